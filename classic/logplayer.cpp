@@ -147,7 +147,6 @@ const int Player::TIMEDELTA = 10;
 const int Player::PLAY_CYCLE = 100;
 const int Player::FEED_CYCLE = 50;
 const int Player::STEP_CYCLE = 450;
-const std::size_t Player::MAX_SHOWINFO = 18000;
 
 
 Player::Player()
@@ -521,24 +520,12 @@ Player::stop()
 
 
 
-struct DispInfoCmp
-    : public std::binary_function< boost::shared_ptr< rcss::rcg::DispInfoT >,
-                                   boost::shared_ptr< rcss::rcg::DispInfoT >,
-                                   bool > {
-    result_type operator()( const first_argument_type & lhs,
-                            const second_argument_type & rhs )
-      {
-          return lhs->show_.time_ < rhs->show_.time_;
-      }
-};
-
-
 void
 Player::jump()
 {
     int max_time = ( M_dispinfo_cache.empty()
                      ? 0
-                     : M_dispinfo_cache.back()->show_.time_ );
+                     : M_dispinfo_cache.time( M_dispinfo_cache.size() - 1 ) );
 
     if ( M_to_time == END )
     {
@@ -553,17 +540,11 @@ Player::jump()
     {
         if ( ! M_dispinfo_cache.empty() )
         {
-            static boost::shared_ptr< rcss::rcg::DispInfoT > tmp( new rcss::rcg::DispInfoT );
-            tmp->show_.time_ = static_cast< rcss::rcg::UInt32 >( M_to_time );
-
-            std::vector< boost::shared_ptr< rcss::rcg::DispInfoT > >::iterator it
-                = std::lower_bound( M_dispinfo_cache.begin(),
-                                    M_dispinfo_cache.end(),
-                                    tmp,
-                                    DispInfoCmp() );
-            if ( it != M_dispinfo_cache.end() )
+            const std::size_t idx
+                = M_dispinfo_cache.lowerBound( static_cast< rcss::rcg::UInt32 >( M_to_time ) );
+            if ( idx != M_dispinfo_cache.size() )
             {
-                M_show_index = std::distance( M_dispinfo_cache.begin(), it ) + 1;
+                M_show_index = idx + 1;
                 sendLog( M_show_index );
                 writeLog( M_show_index );
             }
@@ -783,24 +764,24 @@ Player::writeLog( const std::size_t index )
         static rcss::rcg::PlayMode s_playmode = rcss::rcg::PM_Null;
         static rcss::rcg::TeamT s_teams[2];
 
-        boost::shared_ptr< rcss::rcg::DispInfoT > disp = M_dispinfo_cache[index - 1];
+        const rcss::rcg::DispInfoT & disp = M_dispinfo_cache.disp( index - 1 );
 
         // if playmode has changed wirte playmode
-        if ( s_playmode != disp->pmode_ )
+        if ( s_playmode != disp.pmode_ )
         {
-            s_playmode = disp->pmode_;
+            s_playmode = disp.pmode_;
 
-            M_out_strm << "(playmode " << disp->show_.time_
+            M_out_strm << "(playmode " << disp.show_.time_
                        << ' ' << s_playmode_strings[s_playmode] << ")\n";
         }
 
-        if ( ! s_teams[0].equals( disp->team_[0] )
-             || ! s_teams[1].equals( disp->team_[1] ) )
+        if ( ! s_teams[0].equals( disp.team_[0] )
+             || ! s_teams[1].equals( disp.team_[1] ) )
         {
-            s_teams[0] = disp->team_[0];
-            s_teams[1] = disp->team_[1];
+            s_teams[0] = disp.team_[0];
+            s_teams[1] = disp.team_[1];
 
-            M_out_strm << "(team " << disp->show_.time_
+            M_out_strm << "(team " << disp.show_.time_
                        << ' ' << ( s_teams[0].name_.empty() ? "null" : s_teams[0].name_.c_str() )
                        << ' ' << ( s_teams[1].name_.empty() ? "null" : s_teams[1].name_.c_str() )
                        << ' ' << s_teams[0].score_
@@ -817,7 +798,7 @@ Player::writeLog( const std::size_t index )
         }
 
         std::string msg;
-        serializeDisp( *disp, false, 0, msg );
+        serializeDisp( disp, false, 0, msg );
         M_out_strm << msg << '\n';
     }
     else if ( doGetLogVersion() == rcss::rcg::REC_VERSION_3 )
@@ -825,12 +806,12 @@ Player::writeLog( const std::size_t index )
         static rcss::rcg::PlayMode s_playmode = rcss::rcg::PM_Null;
         static rcss::rcg::TeamT s_teams[2];
 
-        boost::shared_ptr< rcss::rcg::DispInfoT > disp = M_dispinfo_cache[index - 1];
+        const rcss::rcg::DispInfoT & disp = M_dispinfo_cache.disp( index - 1 );
 
         // if playmode has changed wirte playmode
-        if ( s_playmode != disp->pmode_ )
+        if ( s_playmode != disp.pmode_ )
         {
-            s_playmode = disp->pmode_;
+            s_playmode = disp.pmode_;
 
             rcss::rcg::Int16 mode = htons( rcss::rcg::PM_MODE );
             char pm = static_cast< char >( s_playmode );
@@ -841,11 +822,11 @@ Player::writeLog( const std::size_t index )
         }
 
         // if teams or score has changed, write teams and score
-        if ( ! s_teams[0].equals( disp->team_[0] )
-             || ! s_teams[1].equals( disp->team_[1] ) )
+        if ( ! s_teams[0].equals( disp.team_[0] )
+             || ! s_teams[1].equals( disp.team_[1] ) )
         {
-            s_teams[0] = disp->team_[0];
-            s_teams[1] = disp->team_[1];
+            s_teams[0] = disp.team_[0];
+            s_teams[1] = disp.team_[1];
 
             rcss::rcg::Int16 mode = htons( rcss::rcg::TEAM_MODE );
             rcss::rcg::team_t teams[2];
@@ -860,7 +841,7 @@ Player::writeLog( const std::size_t index )
         // write positional data
         rcss::rcg::Int16 mode = htons( rcss::rcg::SHOW_MODE );
         rcss::rcg::short_showinfo_t2 show;
-        rcss::rcg::convert( disp->show_, show );
+        rcss::rcg::convert( disp.show_, show );
         M_out_strm.write( reinterpret_cast< const char * >( &mode ),
                           sizeof( mode ) );
         M_out_strm.write( reinterpret_cast< const char * >( &show ),
@@ -868,14 +849,14 @@ Player::writeLog( const std::size_t index )
     }
     else if ( doGetLogVersion() == rcss::rcg::REC_VERSION_2 )
     {
-        boost::shared_ptr< rcss::rcg::DispInfoT > disp = M_dispinfo_cache[index - 1];
+        const rcss::rcg::DispInfoT & disp = M_dispinfo_cache.disp( index - 1 );
 
         rcss::rcg::Int16 mode = htons( rcss::rcg::SHOW_MODE );
         rcss::rcg::showinfo_t show;
-        rcss::rcg::convert( static_cast< char >( disp->pmode_ ),
-                            disp->team_[0],
-                            disp->team_[1],
-                            disp->show_,
+        rcss::rcg::convert( static_cast< char >( disp.pmode_ ),
+                            disp.team_[0],
+                            disp.team_[1],
+                            disp.show_,
                             show );
 
         M_out_strm.write( reinterpret_cast< const char * >( &mode ),
@@ -885,17 +866,17 @@ Player::writeLog( const std::size_t index )
     }
     else // REC_OLD_VERSION
     {
-        boost::shared_ptr< rcss::rcg::DispInfoT > disp = M_dispinfo_cache[index - 1];
+        const rcss::rcg::DispInfoT & disp = M_dispinfo_cache.disp( index - 1 );
 
         rcss::rcg::dispinfo_t new_disp;
         new_disp.mode = htons( rcss::rcg::SHOW_MODE );
-        rcss::rcg::convert( static_cast< char >( disp->pmode_ ),
-                            disp->team_[0],
-                            disp->team_[1],
-                            disp->show_,
+        rcss::rcg::convert( static_cast< char >( disp.pmode_ ),
+                            disp.team_[0],
+                            disp.team_[1],
+                            disp.show_,
                             new_disp.body.show );
 
-        M_out_strm.write( reinterpret_cast< const char * >( &disp ),
+        M_out_strm.write( reinterpret_cast< const char * >( &new_disp ),
                           sizeof( rcss::rcg::dispinfo_t ) );
     }
 }
@@ -910,8 +891,8 @@ Player::sendLog( const std::size_t index )
 
     if ( index <= M_dispinfo_cache.size() )
     {
-        boost::shared_ptr< rcss::rcg::DispInfoT > disp = M_dispinfo_cache[index - 1];
-        M_current = disp->show_.time_;
+        const rcss::rcg::DispInfoT & disp = M_dispinfo_cache.disp( index - 1 );
+        M_current = disp.show_.time_;
 
         int counter = 0;
         for ( std::vector< Monitor >::const_iterator p = M_port.monitors().begin();
@@ -923,10 +904,10 @@ Player::sendLog( const std::size_t index )
             {
                 rcss::rcg::dispinfo_t new_disp;
                 new_disp.mode = htons( rcss::rcg::SHOW_MODE );
-                rcss::rcg::convert( static_cast< char >( disp->pmode_ ),
-                                    disp->team_[0],
-                                    disp->team_[1],
-                                    disp->show_,
+                rcss::rcg::convert( static_cast< char >( disp.pmode_ ),
+                                    disp.team_[0],
+                                    disp.team_[1],
+                                    disp.show_,
                                     new_disp.body.show );
                 M_port.send( new_disp, p->addr_ );
             }
@@ -934,17 +915,17 @@ Player::sendLog( const std::size_t index )
             {
                 rcss::rcg::dispinfo_t2 new_disp2;
                 new_disp2.mode = htons( rcss::rcg::SHOW_MODE );
-                rcss::rcg::convert( static_cast< char >( disp->pmode_ ),
-                                    disp->team_[0],
-                                    disp->team_[1],
-                                    disp->show_,
+                rcss::rcg::convert( static_cast< char >( disp.pmode_ ),
+                                    disp.team_[0],
+                                    disp.team_[1],
+                                    disp.show_,
                                     new_disp2.body.show );
                 M_port.send( new_disp2, p->addr_ );
             }
             else if ( p->version_ >= 3 )
             {
                 std::string msg;
-                serializeDisp( *disp, true, p->version_, msg );
+                serializeDisp( disp, true, p->version_, msg );
                 M_port.send( msg, p->addr_ );
             }
         }
@@ -1253,21 +1234,16 @@ Player::doHandleLogVersion( int ver )
 void
 Player::doHandleShowInfo( const rcss::rcg::ShowInfoT & info )
 {
-    if ( M_dispinfo_cache.size() > MAX_SHOWINFO )
-    {
-        return;
-    }
-
     //
     // register new disp info
     //
 
-    boost::shared_ptr< rcss::rcg::DispInfoT > disp( new rcss::rcg::DispInfoT );
+    rcss::rcg::DispInfoT disp;
 
-    disp->pmode_ = M_playmode;
-    disp->team_[0] = M_teams[0];
-    disp->team_[1] = M_teams[1];
-    disp->show_ = info;
+    disp.pmode_ = M_playmode;
+    disp.team_[0] = M_teams[0];
+    disp.team_[1] = M_teams[1];
+    disp.show_ = info;
 
     M_dispinfo_cache.push_back( disp );
 }
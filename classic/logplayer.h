@@ -41,6 +41,7 @@
 
 #include <rcsslogplayer/handler.h>
 #include <rcsslogplayer/types.h>
+#include <rcsslogplayer/frame_store.h>
 
 #if !X_DISPLAY_MISSING
 #include <X11/Intrinsic.h>
@@ -96,7 +97,6 @@ private:
     static const int PLAY_CYCLE; // [msec]
     static const int FEED_CYCLE; // [msec]
     static const int STEP_CYCLE; // [msec]
-    static const std::size_t MAX_SHOWINFO;
 
     std::string M_input_file; /* input file name */
     std::string M_output_file; /* output file name */
@@ -132,7 +132,7 @@ private:
     rcss::rcg::PlayerParamT M_player_param;
     std::vector< rcss::rcg::PlayerTypeT > M_player_types;
 
-    std::vector< boost::shared_ptr< rcss::rcg::DispInfoT > > M_dispinfo_cache;
+    rcss::rcg::FrameStore M_dispinfo_cache;
     std::size_t M_show_index;
 
 public:
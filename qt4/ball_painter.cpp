@@ -274,8 +274,9 @@ BallPainter::drawTrace( QPainter & painter ) const
         return;
     }
 
-    const std::vector< DispPtr > & cont = M_main_data.dispHolder().dispInfoCont();
-    if ( cont.empty() )
+    // the positions are read from the columns directly, also in the lazy mode.
+    const rcss::rcg::FrameStore & frames = M_main_data.dispHolder().frames();
+    if ( frames.empty() )
     {
         return;
     }
@@ -293,12 +294,12 @@ BallPainter::drawTrace( QPainter & painter ) const
     painter.setBrush( Qt::NoBrush );
 
     std::size_t i = first;
-    int prev_x = opt.screenX( cont[i]->show_.ball_.x_ );
-    int prev_y = opt.screenX( cont[i]->show_.ball_.y_ );
+    int prev_x = opt.screenX( frames.ballX( i ) );
+    int prev_y = opt.screenX( frames.ballY( i ) );
     ++i;
     for ( ; i <= last; ++i )
     {
-        switch ( cont[i]->pmode_ ) {
+        switch ( frames.pmode( i ) ) {
         case rcss::rcg::PM_BeforeKickOff:
         case rcss::rcg::PM_TimeOver:
         case rcss::rcg::PM_KickOff_Left:
@@ -316,8 +317,8 @@ BallPainter::drawTrace( QPainter & painter ) const
             break;
         }
 
-        int ix = opt.screenX( cont[i]->show_.ball_.x_ );
-        int iy = opt.screenY( cont[i]->show_.ball_.y_ );
+        int ix = opt.screenX( frames.ballX( i ) );
+        int iy = opt.screenY( frames.ballY( i ) );
 
         painter.drawLine( prev_x, prev_y, ix, iy );
         if ( ! line_trace )
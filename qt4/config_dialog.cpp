@@ -2045,12 +2045,15 @@ ConfigDialog::editBallTraceEnd( const QString & text )
 void
 ConfigDialog::clickBallTraceAll()
 {
-    const std::vector< DispPtr > & cont = M_main_data.dispHolder().dispInfoCont();
+    const DispHolder & holder = M_main_data.dispHolder();
 
-    if ( ! cont.empty() )
+    if ( holder.dispInfoSize() > 0 )
     {
-        if ( Options::instance().ballTraceStart() == cont.front()->show_.time_
-             && Options::instance().ballTraceEnd() == cont.back()->show_.time_ )
+        const int first_time = holder.frames().time( 0 );
+        const int last_time = holder.frames().time( holder.dispInfoSize() - 1 );
+
+        if ( Options::instance().ballTraceStart() == first_time
+             && Options::instance().ballTraceEnd() == last_time )
         {
             M_ball_trace_start->setText( QString::number( 0 ) );
             M_ball_trace_end->setText( QString::number( 0 ) );
@@ -2060,11 +2063,11 @@ ConfigDialog::clickBallTraceAll()
         }
         else
         {
-            M_ball_trace_start->setText( QString::number( cont.front()->show_.time_ ) );
-            M_ball_trace_end->setText( QString::number( cont.back()->show_.time_ ) );
+            M_ball_trace_start->setText( QString::number( first_time ) );
+            M_ball_trace_end->setText( QString::number( last_time ) );
 
-            Options::instance().setBallTraceStart( cont.front()->show_.time_ );
-            Options::instance().setBallTraceEnd( cont.back()->show_.time_ );
+            Options::instance().setBallTraceStart( first_time );
+            Options::instance().setBallTraceEnd( last_time );
         }
 
         emit configured();
@@ -2114,11 +2117,14 @@ ConfigDialog::editPlayerTraceEnd( const QString & text )
 void
 ConfigDialog::clickPlayerTraceAll()
 {
-    const std::vector< DispPtr > & cont = M_main_data.dispHolder().dispInfoCont();
-    if ( ! cont.empty() )
+    const DispHolder & holder = M_main_data.dispHolder();
+    if ( holder.dispInfoSize() > 0 )
     {
-        if ( Options::instance().playerTraceStart() == cont.front()->show_.time_
-             && Options::instance().playerTraceEnd() == cont.back()->show_.time_ )
+        const int first_time = holder.frames().time( 0 );
+        const int last_time = holder.frames().time( holder.dispInfoSize() - 1 );
+
+        if ( Options::instance().playerTraceStart() == first_time
+             && Options::instance().playerTraceEnd() == last_time )
         {
             M_player_trace_start->setText( QString::number( 0 ) );
             M_player_trace_end->setText( QString::number( 0 ) );
@@ -2128,11 +2134,11 @@ ConfigDialog::clickPlayerTraceAll()
         }
         else
         {
-            M_player_trace_start->setText( QString::number( cont.front()->show_.time_ ) );
-            M_player_trace_end->setText( QString::number( cont.back()->show_.time_ ) );
+            M_player_trace_start->setText( QString::number( first_time ) );
+            M_player_trace_end->setText( QString::number( last_time ) );
 
-            Options::instance().setPlayerTraceStart( cont.front()->show_.time_ );
-            Options::instance().setPlayerTraceEnd( cont.back()->show_.time_ );
+            Options::instance().setPlayerTraceStart( first_time );
+            Options::instance().setPlayerTraceEnd( last_time );
         }
 
         emit configured();
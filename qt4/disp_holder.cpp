@@ -40,7 +40,9 @@
 #include <rcsslogplayer/parser.h>
 
 #include <sstream>
+#include <algorithm>
 #include <cmath>
+#include <cctype>
 #include <cstring>
 #include <cstdio>
 
@@ -51,12 +53,113 @@
 #include <windows.h>
 #endif
 
+namespace {
+
+//! default maximum number of cached frames in the lazy mode
+const std::size_t DEFAULT_LAZY_CACHE_SIZE = 1024;
+
+inline
+std::size_t
+index_distance( const std::size_t lhs,
+                const std::size_t rhs )
+{
+    return ( lhs < rhs ? rhs - lhs : lhs - rhs );
+}
+
+}
+
+/*!
+  \class DispHolder::ShowDecoder
+  \brief handler to receive the show data decoded from the show line in the lazy mode.
+ */
+class DispHolder::ShowDecoder
+    : public rcss::rcg::Handler {
+private:
+    int M_log_version;
+    rcss::rcg::ShowInfoT * M_show;
+
+public:
+    explicit
+    ShowDecoder( const int log_version )
+        : M_log_version( log_version ),
+          M_show( 0 )
+      { }
+
+    /*!
+      \brief set the variable that receives the next show data
+      \param show pointer to the result variable
+     */
+    void setTarget( rcss::rcg::ShowInfoT * show )
+      {
+          M_show = show;
+      }
+
+    /*!
+      \brief check if the show data has been received after setTarget()
+      \return true if the target variable has been set
+     */
+    bool received() const
+      {
+          return M_show == 0;
+      }
+
+private:
+    void doHandleLogVersion( int )
+      { }
+    int doGetLogVersion() const
+      {
+          return M_log_version;
+      }
+    void doHandleShowInfo( const rcss::rcg::ShowInfoT & show )
+      {
+          if ( M_show )
+          {
+              *M_show = show;
+              M_show = 0;
+          }
+      }
+    void doHandleMsgInfo( const int,
+                          const int,
+                          const std::string & )
+      { }
+    void doHandlePlayMode( const int,
+                           const rcss::rcg::PlayMode )
+      { }
+    void doHandleTeamInfo( const int,
+                           const rcss::rcg::TeamT &,
+                           const rcss::rcg::TeamT & )
+      { }
+    void doHandleDrawClear( const int )
+      { }
+    void doHandleDrawPointInfo( const int,
+                                const rcss::rcg::PointInfoT & )
+      { }
+    void doHandleDrawLineInfo( const int,
+                               const rcss::rcg::LineInfoT & )
+      { }
+    void doHandleDrawCircleInfo( const int,
+                                 const rcss::rcg::CircleInfoT & )
+      { }
+    void doHandleServerParam( const rcss::rcg::ServerParamT & )
+      { }
+    void doHandlePlayerParam( const rcss::rcg::PlayerParamT & )
+      { }
+    void doHandlePlayerType( const rcss::rcg::PlayerTypeT & )
+      { }
+    void doHandleEOF()
+      { }
+};
+
 /*-------------------------------------------------------------------*/
 /*!
 
  */
 DispHolder::DispHolder()
-    : M_log_version( 0 )
+    : M_log_version( 0 ),
+      M_frame_revision( 0 ),
+      M_lazy_current(),
+      M_lazy_cache_size( DEFAULT_LAZY_CACHE_SIZE ),
+      M_lazy_center( 0 )
 {
 
 }
@@ -85,8 +188,17 @@ DispHolder::clear()
     M_penalty_scores_left.clear();
     M_penalty_scores_right.clear();
 
-    M_last_disp.reset();
-    M_dispinfo_cont.clear();
+    M_frames.clear();
+    M_frames.setColumnsOnly( false );
+    ++M_frame_revision;
+
+    M_lazy_file.reset();
+    M_lazy_frames.clear();
+    M_lazy_teams.clear();
+    M_lazy_cache.clear();
+    M_lazy_center = 0;
+    M_lazy_parser.reset();
+    M_lazy_decoder.reset();
 
     M_server_param = rcss::rcg::ServerParamT();
     M_player_param = rcss::rcg::PlayerParamT();
@@ -100,6 +212,169 @@ DispHolder::clear()
     M_team_graphic_right.clear();
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DispHolder::loadLazy( boost::shared_ptr< const rcss::MappedFile > file )
+{
+    clear();
+
+    if ( ! file
+         || ! file->is_open() )
+    {
+        return false;
+    }
+
+    const char * const buf = file->data();
+    const std::size_t size = file->size();
+
+    // v4+ log has the text header, "ULG4" or "ULG5".
+    if ( size < 4
+         || std::strncmp( buf, "ULG", 3 ) != 0
+         || ! std::isdigit( static_cast< unsigned char >( buf[3] ) ) )
+    {
+        return false;
+    }
+
+    // parse the header and the rest of the first line
+    rcss::rcg::Parser parser( *this );
+    std::size_t pos = 0;
+    M_log_version = 0;
+    parser.parse( buf, size, pos );
+
+    if ( M_log_version < rcss::rcg::REC_VERSION_4 )
+    {
+        clear();
+        return false;
+    }
+
+    M_lazy_file = file;
+    M_frames.setColumnsOnly( true );
+
+    // only the fields kept in the columns are decoded. the other fields are skipped
+    // without validation, so a show line broken in them is accepted here, and
+    // decodeLazyFrame() builds that frame from the columns.
+    // the show block is not used, because each show record has to be handled
+    // with its own line position.
+    parser.setFieldMask( rcss::rcg::Parser::FIELD_POSITION );
+    std::string line;
+    int n_line = 1;
+    while ( pos < size )
+    {
+        const char * first = buf + pos;
+        const char * last = static_cast< const char * >( std::memchr( first, '\n', size - pos ) );
+        if ( last )
+        {
+            pos = last - buf + 1;
+        }
+        else
+        {
+            last = buf + size;
+            pos = size;
+        }
+
+        ++n_line;
+        if ( first == last )
+        {
+            continue;
+        }
+
+        M_lazy_current.offset_ = first - buf;
+        M_lazy_current.line_ = n_line;
+
+        line.assign( first, last );
+        parser.parseLine( n_line, line );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DispHolder::setLazyCacheSize( const std::size_t size )
+{
+    M_lazy_cache_size = std::max( static_cast< std::size_t >( 1 ), size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+DispHolder::LazyFrame
+DispHolder::createLazyFrame( const rcss::rcg::DispInfoT & disp )
+{
+    if ( M_lazy_teams.empty()
+         || ! M_lazy_teams.back().first.equals( disp.team_[0] )
+         || ! M_lazy_teams.back().second.equals( disp.team_[1] ) )
+    {
+        M_lazy_teams.push_back( std::make_pair( disp.team_[0], disp.team_[1] ) );
+    }
+
+    LazyFrame frame = M_lazy_current;
+    frame.team_index_ = M_lazy_teams.size() - 1;
+    return frame;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DispHolder::decodeLazyFrame( const std::size_t idx,
+                             rcss::rcg::DispInfoT & disp ) const
+{
+    const LazyFrame & frame = M_lazy_frames[idx];
+    const char * const buf = M_lazy_file->data();
+    const std::size_t size = M_lazy_file->size();
+
+    const char * first = buf + frame.offset_;
+    const char * last = static_cast< const char * >( std::memchr( first, '\n', size - frame.offset_ ) );
+    if ( ! last )
+    {
+        last = buf + size;
+    }
+
+    if ( ! M_lazy_parser )
+    {
+        M_lazy_decoder.reset( new ShowDecoder( M_log_version ) );
+        M_lazy_parser.reset( new rcss::rcg::Parser( *M_lazy_decoder ) );
+    }
+
+    disp.pmode_ = M_frames.pmode( idx );
+    disp.team_[0] = M_lazy_teams[frame.team_index_].first;
+    disp.team_[1] = M_lazy_teams[frame.team_index_].second;
+
+    M_lazy_decoder->setTarget( &disp.show_ );
+    M_lazy_line_buf.assign( first, last );
+    M_lazy_parser->parseLine( frame.line_, M_lazy_line_buf );
+
+    if ( ! M_lazy_decoder->received() )
+    {
+        // the line is broken in the fields skipped by loadLazy().
+        // only the data in the columns are available.
+        M_lazy_decoder->setTarget( 0 );
+
+        disp.show_ = rcss::rcg::ShowInfoT();
+        disp.show_.time_ = M_frames.time( idx );
+        disp.show_.ball_.x_ = M_frames.ballX( idx );
+        disp.show_.ball_.y_ = M_frames.ballY( idx );
+        for ( int i = 0; i < rcss::rcg::MAX_PLAYER*2; ++i )
+        {
+            rcss::rcg::PlayerT & p = disp.show_.player_[i];
+            p.side_ = ( i < rcss::rcg::MAX_PLAYER ? 'l' : 'r' );
+            p.unum_ = ( i < rcss::rcg::MAX_PLAYER ? i + 1 : i + 1 - rcss::rcg::MAX_PLAYER );
+            p.state_ = rcss::rcg::STAND;
+            p.x_ = M_frames.playerX( idx, i );
+            p.y_ = M_frames.playerY( idx, i );
+        }
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -107,24 +382,68 @@ DispHolder::clear()
 DispConstPtr
 DispHolder::getDispInfo( const std::size_t idx ) const
 {
-    if ( M_dispinfo_cont.size() <= idx )
+    if ( M_frames.size() <= idx )
     {
         return DispConstPtr(); // null pointer
     }
 
-    return M_dispinfo_cont[idx];
+    if ( M_lazy_file )
+    {
+        std::map< std::size_t, DispPtr >::const_iterator it = M_lazy_cache.find( idx );
+        if ( it != M_lazy_cache.end() )
+        {
+            return it->second;
+        }
+
+        // remove the farthest frame from the current index.
+        // the frame out of the cache range is also cached, but it is removed at first.
+        DispPtr disp;
+        while ( ! M_lazy_cache.empty()
+                && M_lazy_cache.size() >= M_lazy_cache_size )
+        {
+            std::map< std::size_t, DispPtr >::iterator first = M_lazy_cache.begin();
+            std::map< std::size_t, DispPtr >::iterator last = M_lazy_cache.end();
+            --last;
+
+            std::map< std::size_t, DispPtr >::iterator farthest
+                = ( index_distance( first->first, M_lazy_center )
+                    >= index_distance( last->first, M_lazy_center )
+                    ? first
+                    : last );
+            disp = farthest->second;
+            M_lazy_cache.erase( farthest );
+        }
+
+        // the memory of the removed frame is reused if no one holds it.
+        if ( ! disp
+             || ! disp.unique() )
+        {
+            disp.reset( new rcss::rcg::DispInfoT );
+        }
+
+        decodeLazyFrame( idx, *disp );
+        M_lazy_cache.insert( std::make_pair( idx, disp ) );
+
+        return disp;
+    }
+
+    // the pointer refers to the frame in the store without copying.
+    return M_frames.ptr( idx );
 }
 
-namespace {
+/*-------------------------------------------------------------------*/
+/*!
 
-struct TimeCmp {
-    bool operator()( const DispPtr & lhs,
-                     const int time ) const
-      {
-          return lhs->show_.time_ < time;
-      }
-};
+ */
+std::size_t
+DispHolder::lowerBound( const int time ) const
+{
+    if ( time < 0 )
+    {
+        return 0;
+    }
 
+    return M_frames.lowerBound( static_cast< rcss::rcg::UInt32 >( time ) );
 }
 
 /*-------------------------------------------------------------------*/
@@ -134,17 +453,39 @@ struct TimeCmp {
 std::size_t
 DispHolder::getIndexOf( const int time ) const
 {
-    std::vector< DispPtr >::const_iterator it
-        = std::lower_bound( M_dispinfo_cont.begin(),
-                            M_dispinfo_cont.end(),
-                            time,
-                            TimeCmp() );
-    if ( it == M_dispinfo_cont.end() )
+    const std::size_t idx = lowerBound( time );
+    if ( idx == dispInfoSize() )
     {
         return 0;
     }
 
-    return std::distance( M_dispinfo_cont.begin(), it );
+    return idx;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+DispHolder::getIndexOf( const int time,
+                        const int sub_cycle ) const
+{
+    const std::size_t first = lowerBound( time );
+    if ( first == dispInfoSize() )
+    {
+        return 0;
+    }
+
+    if ( sub_cycle <= 0 )
+    {
+        return first;
+    }
+
+    // the frames of the same time are consecutive.
+    const int first_time = static_cast< int >( M_frames.time( first ) );
+    const std::size_t last = lowerBound( first_time + 1 ) - 1;
+
+    return std::min( first + sub_cycle, last );
 }
 
 /*-------------------------------------------------------------------*/
@@ -173,38 +514,30 @@ DispHolder::playerType( const int id ) const
 bool
 DispHolder::addDispInfo1( const rcss::rcg::dispinfo_t & disp )
 {
-    if ( M_dispinfo_cont.size() >= 65535 )
-    {
-        std::cerr << "over the maximum number of showinfo."
-                  << std::endl;
-        return true;
-    }
-
     switch ( ntohs( disp.mode ) ) {
     case rcss::rcg::NO_INFO:
         break;
     case rcss::rcg::SHOW_MODE:
         {
-            DispPtr new_disp( new rcss::rcg::DispInfoT );
+            rcss::rcg::DispInfoT new_disp;
 
             M_playmode = static_cast< rcss::rcg::PlayMode >( disp.body.show.pmode );
             rcss::rcg::convert( disp.body.show.team[0], M_teams[0] );
             rcss::rcg::convert( disp.body.show.team[1], M_teams[1] );
 
-            new_disp->pmode_ = M_playmode;
-            new_disp->team_[0] = M_teams[0];
-            new_disp->team_[1] = M_teams[1];
-            rcss::rcg::convert( disp.body.show, new_disp->show_ );
+            new_disp.pmode_ = M_playmode;
+            new_disp.team_[0] = M_teams[0];
+            new_disp.team_[1] = M_teams[1];
+            rcss::rcg::convert( disp.body.show, new_disp.show_ );
 
-            M_last_disp = new_disp;
-            if ( new_disp->show_.time_ > 0
-                 || M_dispinfo_cont.empty() )
+            if ( new_disp.show_.time_ > 0
+                 || M_frames.empty() )
             {
-                M_dispinfo_cont.push_back( new_disp );
+                addFrame( new_disp );
             }
             else
             {
-                M_dispinfo_cont.back() =  new_disp;
+                replaceLastFrame( new_disp );
             }
         }
         break;
@@ -230,39 +563,30 @@ DispHolder::addDispInfo1( const rcss::rcg::dispinfo_t & disp )
 bool
 DispHolder::addDispInfo2( const rcss::rcg::dispinfo_t2 & disp )
 {
-    if ( M_dispinfo_cont.size() >= 65535 )
-    {
-        std::cerr << "over the maximum number of showinfo."
-                  << std::endl;
-        return true;
-    }
-
-
     switch ( ntohs( disp.mode ) ) {
     case rcss::rcg::NO_INFO:
         break;
     case rcss::rcg::SHOW_MODE:
         {
-            DispPtr new_disp( new rcss::rcg::DispInfoT );
+            rcss::rcg::DispInfoT new_disp;
 
             M_playmode = static_cast< rcss::rcg::PlayMode >( disp.body.show.pmode );
             rcss::rcg::convert( disp.body.show.team[0], M_teams[0] );
             rcss::rcg::convert( disp.body.show.team[1], M_teams[1] );
 
-            new_disp->pmode_ = M_playmode;
-            new_disp->team_[0] = M_teams[0];
-            new_disp->team_[1] = M_teams[1];
-            rcss::rcg::convert( disp.body.show, new_disp->show_ );
+            new_disp.pmode_ = M_playmode;
+            new_disp.team_[0] = M_teams[0];
+            new_disp.team_[1] = M_teams[1];
+            rcss::rcg::convert( disp.body.show, new_disp.show_ );
 
-            M_last_disp = new_disp;
-            if ( new_disp->show_.time_ > 0
-                 || M_dispinfo_cont.empty() )
+            if ( new_disp.show_.time_ > 0
+                 || M_frames.empty() )
             {
-                M_dispinfo_cont.push_back( new_disp );
+                addFrame( new_disp );
             }
             else
             {
-                M_dispinfo_cont.back() =  new_disp;
+                replaceLastFrame( new_disp );
             }
         }
         break;
@@ -313,18 +637,15 @@ DispHolder::addDispInfo2( const rcss::rcg::dispinfo_t2 & disp )
 
  */
 bool
-DispHolder::addDispInfo3( const char * msg )
+DispHolder::addDispInfo3( const char * msg,
+                          const std::size_t len )
 {
-    if ( M_dispinfo_cont.size() >= 65535 )
+    if ( ! M_monitor_parser )
     {
-        std::cerr << "over the maximum number of showinfo."
-                  << std::endl;
-        return true;
+        M_monitor_parser.reset( new rcss::rcg::Parser( *this ) );
     }
 
-    rcss::rcg::Parser parser( *this );
-
-    return parser.parseLine( -1, msg );
+    return M_monitor_parser->parseLine( -1, msg, len );
 }
 
 /*-------------------------------------------------------------------*/
@@ -354,52 +675,93 @@ DispHolder::doGetLogVersion() const
 void
 DispHolder::doHandleShowInfo( const rcss::rcg::ShowInfoT & show )
 {
-    if ( M_dispinfo_cont.size() >= 65535 )
-    {
-        std::cerr << "over the maximum number of showinfo."
-                  << std::endl;
-        return;
-    }
+    rcss::rcg::DispInfoT disp;
 
-    DispPtr disp( new rcss::rcg::DispInfoT );
+    disp.pmode_ = M_playmode;
+    disp.team_[0] = M_teams[0];
+    disp.team_[1] = M_teams[1];
+    disp.show_ = show;
 
-    disp->pmode_ = M_playmode;
-    disp->team_[0] = M_teams[0];
-    disp->team_[1] = M_teams[1];
-    disp->show_ = show;
+    appendDispInfo( disp );
+}
 
-    M_last_disp = disp;
+/*-------------------------------------------------------------------*/
+/*!
 
-    if ( M_playmode == rcss::rcg::PM_BeforeKickOff )
+ */
+void
+DispHolder::doHandleShowBlock( const rcss::rcg::ShowInfoT * shows,
+                               const std::size_t n )
+{
+    // playmode and team info are never changed in the block.
+    rcss::rcg::DispInfoT disp;
+    disp.pmode_ = M_playmode;
+    disp.team_[0] = M_teams[0];
+    disp.team_[1] = M_teams[1];
+
+    for ( std::size_t i = 0; i < n; ++i )
     {
-        if ( M_dispinfo_cont.empty()
-             || M_dispinfo_cont.back()->pmode_ != rcss::rcg::PM_BeforeKickOff )
-        {
-            M_dispinfo_cont.push_back( disp );
-        }
-        else
-        {
-            M_dispinfo_cont.back() = disp;
-        }
+        disp.show_ = shows[i];
+        appendDispInfo( disp );
     }
-    else if ( M_playmode == rcss::rcg::PM_TimeOver )
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DispHolder::appendDispInfo( const rcss::rcg::DispInfoT & disp )
+{
+    // only the last frame is kept while the playmode is before_kick_off or time_over.
+    if ( ( M_playmode == rcss::rcg::PM_BeforeKickOff
+           || M_playmode == rcss::rcg::PM_TimeOver )
+         && ! M_frames.empty()
+         && M_frames.pmode( M_frames.size() - 1 ) == M_playmode )
     {
-        if ( M_dispinfo_cont.empty()
-             || M_dispinfo_cont.back()->pmode_ != rcss::rcg::PM_TimeOver )
-        {
-            M_dispinfo_cont.push_back( disp );
-        }
-        else
-        {
-            M_dispinfo_cont.back() = disp;
-        }
+        replaceLastFrame( disp );
     }
     else
     {
-        M_dispinfo_cont.push_back( disp );
+        addFrame( disp );
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DispHolder::addFrame( const rcss::rcg::DispInfoT & disp )
+{
+    M_frames.push_back( disp );
+    if ( M_lazy_file )
+    {
+        M_lazy_frames.push_back( createLazyFrame( disp ) );
+    }
+    ++M_frame_revision;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DispHolder::replaceLastFrame( const rcss::rcg::DispInfoT & disp )
+{
+    M_frames.setBack( disp );
+    if ( M_lazy_file )
+    {
+        M_lazy_frames.back() = createLazyFrame( disp );
+        M_lazy_cache.erase( M_frames.size() - 1 );
+    }
+    ++M_frame_revision;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -466,7 +828,7 @@ DispHolder::doHandleTeamInfo( const int,
     if ( M_teams[0].score_ != team_l.score_
          || M_teams[1].score_ != team_r.score_ )
     {
-        M_score_changed_index.push_back( M_dispinfo_cont.size() );
+        M_score_changed_index.push_back( dispInfoSize() );
     }
 
     M_teams[0] = team_l;
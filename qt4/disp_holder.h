@@ -37,13 +37,24 @@
 
 #include <rcsslogplayer/types.h>
 #include <rcsslogplayer/handler.h>
+#include <rcsslogplayer/frame_store.h>
+#include <rcsslogplayer/mappedfile.h>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include <map>
+#include <string>
+#include <deque>
 #include <vector>
 #include <iostream>
 
+namespace rcss {
+namespace rcg {
+class Parser;
+}
+}
+
 typedef boost::shared_ptr< rcss::rcg::DispInfoT > DispPtr;
 typedef boost::shared_ptr< const rcss::rcg::DispInfoT > DispConstPtr;
 
@@ -51,12 +62,48 @@ class DispHolder
     : public rcss::rcg::Handler {
 private:
 
+    /*!
+      \struct LazyFrame
+      \brief reference to the show line used in the lazy mode.
+     */
+    struct LazyFrame {
+        std::size_t offset_; //!< head position of the show line
+        int line_; //!< line number of the show line
+        std::size_t team_index_; //!< index of M_lazy_teams
+    };
+
+    class ShowDecoder;
+
     int M_log_version;
     rcss::rcg::PlayMode M_playmode; //!< last handled playmode
     rcss::rcg::TeamT M_teams[2]; //!< last handled team info
-    DispPtr M_last_disp;
 
-    std::vector< DispPtr > M_dispinfo_cont;
+    //! all frames. only the columns are kept in the lazy mode.
+    rcss::rcg::FrameStore M_frames;
+    //! the number of frame updates. this value is increased when the frame is added or replaced.
+    std::size_t M_frame_revision;
+
+    //! mapped log file. not NULL only in the lazy mode.
+    boost::shared_ptr< const rcss::MappedFile > M_lazy_file;
+    //! show line of each frame in the lazy mode.
+    //! deque is used to avoid copying all frames when it grows.
+    std::deque< LazyFrame > M_lazy_frames;
+    //! team info history in the lazy mode
+    std::vector< std::pair< rcss::rcg::TeamT, rcss::rcg::TeamT > > M_lazy_teams;
+    //! show line position of the record being parsed by loadLazy()
+    LazyFrame M_lazy_current;
+    //! decoded frames in the lazy mode. key: frame index
+    mutable std::map< std::size_t, DispPtr > M_lazy_cache;
+    //! the maximum number of cached frames
+    std::size_t M_lazy_cache_size;
+    //! center of the cached frames. the farthest frame from this index is removed first.
+    std::size_t M_lazy_center;
+    //! receiver of the decoded show data. created at the first decoding.
+    mutable boost::scoped_ptr< ShowDecoder > M_lazy_decoder;
+    //! parser reused to decode the show lines. created at the first decoding.
+    mutable boost::scoped_ptr< rcss::rcg::Parser > M_lazy_parser;
+    //! reused line buffer for M_lazy_parser
+    mutable std::string M_lazy_line_buf;
 
     rcss::rcg::ServerParamT M_server_param;
     rcss::rcg::PlayerParamT M_player_param;
@@ -78,6 +125,16 @@ private:
     TeamGraphic M_team_graphic_left;
     TeamGraphic M_team_graphic_right;
 
+    //! parser of the datagrams from the monitor client. created at the first datagram.
+    boost::scoped_ptr< rcss::rcg::Parser > M_monitor_parser;
+
+    /*!
+      \brief find the first frame whose time is not less than the given time.
+      \param time game time
+      \return frame index. dispInfoSize() if not found.
+     */
+    std::size_t lowerBound( const int time ) const;
+
     // not used
     DispHolder( const DispHolder & );
     const DispHolder & operator=( const DispHolder & );
@@ -93,18 +150,122 @@ public:
           return M_log_version;
       }
 
+    /*!
+      \brief load the v4+ text log in the lazy mode.
+      \param file opened rcg file. this holder keeps the file while the data are used.
+      \return true if successfully loaded. false if the file is not a text log.
+
+      Only the columns of frames() (time, playmode and positions) are decoded from
+      each show line, and the other fields are skipped. The columns and the position
+      of the show line are kept for each frame. Each frame is decoded again from its
+      show line by getDispInfo() on demand, and the frames around the current index
+      (see setCurrentIndex()) are cached. If a show line is broken in the skipped
+      fields, the normal mode drops it, but this mode keeps the frame and builds it
+      from the columns only.
+     */
+    bool loadLazy( boost::shared_ptr< const rcss::MappedFile > file );
+
+    bool isLazy() const
+      {
+          return M_lazy_file.get() != 0;
+      }
+
+    /*!
+      \brief set the maximum number of cached frames in the lazy mode
+      \param size the number of frames
+     */
+    void setLazyCacheSize( const std::size_t size );
+
+    /*!
+      \brief set the current frame index.
+      \param idx frame index
+
+      In the lazy mode, the cached frame farthest from this index is removed
+      first, so the frames around this index stay in the cache.
+     */
+    void setCurrentIndex( const std::size_t idx )
+      {
+          M_lazy_center = idx;
+      }
+
+    /*!
+      \brief set the compact encoding of the frames in the normal mode.
+      \param on if true, the frames are encoded to reduce the memory usage.
+
+      The stored frames are encoded again. In the compact mode, getDispInfo()
+      returns the newly decoded data.
+     */
+    void setCompact( const bool on )
+      {
+          M_frames.setCompact( on );
+      }
+
+    bool isCompact() const
+      {
+          return M_frames.isCompact();
+      }
+
+    /*!
+      \brief get the display data of the frame.
+      \param idx frame index
+      \return pointer to the display data. NULL if idx is out of range.
+
+      In the normal mode, the pointer refers to the frame in the store. When the last frame is
+      replaced (e.g. by the monitor client), the data seen through the pointer
+      already held to that frame are also changed. The holder should not keep
+      the pointer beyond the current event, or should copy the data.
+     */
     DispConstPtr getDispInfo( const std::size_t idx ) const;
+
+    /*!
+      \brief get the index of the first frame at the given time.
+      \param time game time
+      \return frame index. 0 if not found.
+     */
     std::size_t getIndexOf( const int time ) const;
 
+    /*!
+      \brief get the index of the frame at the sub-cycle of the given time.
+      \param time game time
+      \param sub_cycle order of the frame in the frames of the same time (e.g. during the stoppage).
+      \return frame index. 0 if not found.
+      If sub_cycle is too large, the last frame of the time is returned.
+     */
+    std::size_t getIndexOf( const int time,
+                            const int sub_cycle ) const;
+
     DispConstPtr lastDispInfo() const
       {
-          return M_last_disp;
+          return ( dispInfoSize() == 0
+                   ? DispConstPtr()
+                   : getDispInfo( dispInfoSize() - 1 ) );
+      }
+
+    std::size_t dispInfoSize() const
+      {
+          return M_frames.size();
+      }
+
+    /*!
+      \brief get the number of frame updates.
+      \return revision number. it is changed when the frame is added or replaced.
+     */
+    std::size_t frameRevision() const
+      {
+          return M_frame_revision;
       }
 
+    /*!
+      \brief get the columnar frame container.
+      \return const reference to the container. only the columns are available in the lazy mode.
+
+      The history of one field (e.g. positions for the trace) can be read from
+      the columns of the container directly.
+     */
     const
-    std::vector< DispPtr > & dispInfoCont() const
+    rcss::rcg::FrameStore & frames() const
       {
-          return M_dispinfo_cont;
+          return M_frames;
       }
 
     const
@@ -181,7 +342,8 @@ public:
 
     bool addDispInfo1( const rcss::rcg::dispinfo_t & disp );
     bool addDispInfo2( const rcss::rcg::dispinfo_t2 & disp );
-    bool addDispInfo3( const char * msg );
+    bool addDispInfo3( const char * msg,
+                       const std::size_t len );
 
 private:
     virtual
@@ -191,6 +353,9 @@ private:
     virtual
     void doHandleShowInfo( const rcss::rcg::ShowInfoT & );
     virtual
+    void doHandleShowBlock( const rcss::rcg::ShowInfoT * shows,
+                            const std::size_t n );
+    virtual
     void doHandleMsgInfo( const int,
                           const int,
                           const std::string & );
@@ -222,6 +387,14 @@ private:
     void doHandleEOF();
 
 private:
+    void appendDispInfo( const rcss::rcg::DispInfoT & disp );
+    void addFrame( const rcss::rcg::DispInfoT & disp );
+    void replaceLastFrame( const rcss::rcg::DispInfoT & disp );
+
+    LazyFrame createLazyFrame( const rcss::rcg::DispInfoT & disp );
+    void decodeLazyFrame( const std::size_t idx,
+                          rcss::rcg::DispInfoT & disp ) const;
+
     void analyzeTeamGraphic( const std::string & msg );
 
 };
@@ -343,11 +343,11 @@ ImageSaveDialog::selectAllCycle()
     int min_cycle = 0;
     int max_cycle = 0;
 
-    const std::vector< DispPtr > & disp_cont = M_main_data.dispHolder().dispInfoCont();
-    if ( ! disp_cont.empty() )
+    const DispHolder & holder = M_main_data.dispHolder();
+    if ( holder.dispInfoSize() > 0 )
     {
-        min_cycle = disp_cont.front()->show_.time_;
-        max_cycle = disp_cont.back()->show_.time_;
+        min_cycle = holder.frames().time( 0 );
+        max_cycle = holder.frames().time( holder.dispInfoSize() - 1 );
     }
 
     M_start_cycle->setRange( min_cycle, max_cycle );
@@ -411,7 +411,7 @@ ImageSaveDialog::saveImage( const int start_cycle,
                             const QString & name_prefix,
                             const QString & format_name )
 {
-    if ( M_main_data.dispHolder().dispInfoCont().empty() )
+    if ( M_main_data.dispHolder().dispInfoSize() == 0 )
     {
         QMessageBox::warning( this,
                               tr( "Error" ),
@@ -421,7 +421,18 @@ LogPlayer::goToIndex( int index )
 void
 LogPlayer::goToCycle( int cycle )
 {
-    if ( M_main_data.setCycle( cycle ) )
+    goToCycle( cycle, 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+LogPlayer::goToCycle( int cycle,
+                      int sub_cycle )
+{
+    if ( M_main_data.setCycle( cycle, sub_cycle ) )
     {
         M_live_mode = false;
         //M_timer->stop();
@@ -104,6 +104,8 @@ public slots:
     void goToIndex( int index );
 
     void goToCycle( int cycle );
+    void goToCycle( int cycle,
+                    int sub_cycle );
 
     void showLive();
 
@@ -155,8 +155,8 @@ LogSliderToolBar::LogSliderToolBar( LogPlayer * log_player,
 
     createControls( log_player, main_win );
 
-    connect( this, SIGNAL( cycleChanged( int ) ),
-             log_player, SLOT( goToCycle( int ) ) );
+    connect( this, SIGNAL( cycleChanged( int, int ) ),
+             log_player, SLOT( goToCycle( int, int ) ) );
 }
 
 /*-------------------------------------------------------------------*/
@@ -199,7 +199,7 @@ LogSliderToolBar::createControls( LogPlayer * log_player,
     //
 
     M_cycle_edit = new CycleEdit();
-    M_cycle_edit->setStatusTip( tr( "Cycle Input Box." ) );
+    M_cycle_edit->setStatusTip( tr( "Cycle Input Box. (cycle or cycle.sub_cycle)" ) );
     M_cycle_edit->setToolTip( tr( "Cycle Input" ) );
     connect( M_cycle_edit, SIGNAL( returnPressed() ),
              this, SLOT( editCycle() ) );
@@ -274,13 +274,27 @@ LogSliderToolBar::createControls( LogPlayer * log_player,
 void
 LogSliderToolBar::editCycle()
 {
+    // "cycle" or "cycle.sub_cycle". sub_cycle is the order of the frame in the stoppage.
+    const QStringList values = M_cycle_edit->text().split( '.' );
+    if ( values.size() > 2 )
+    {
+        return;
+    }
+
     bool ok = true;
-    int cycle = M_cycle_edit->text().toInt( &ok );
+    int cycle = values[0].toInt( &ok );
+    int sub_cycle = 0;
+    if ( ok
+         && values.size() == 2 )
+    {
+        sub_cycle = values[1].toInt( &ok );
+    }
 
     if ( ok
-         && cycle >= 0 )
+         && cycle >= 0
+         && sub_cycle >= 0 )
     {
-        emit cycleChanged( cycle );
+        emit cycleChanged( cycle, sub_cycle );
     }
 }
 
@@ -315,7 +329,7 @@ LogSliderToolBar::updateSlider()
         return;
     }
 
-    int size = M_main_data.dispHolder().dispInfoCont().size();
+    int size = M_main_data.dispHolder().dispInfoSize();
 
     if ( size == 1 ) size = 0;
 
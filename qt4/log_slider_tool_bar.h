@@ -86,7 +86,8 @@ public slots:
 
 signals:
 
-    void cycleChanged( int cycle );
+    void cycleChanged( int cycle,
+                       int sub_cycle );
 
 };
 
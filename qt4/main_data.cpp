@@ -49,9 +49,12 @@
 #ifdef HAVE_LIBZ
 #include <rcsslogplayer/gzfstream.h>
 #endif
+#include <rcsslogplayer/mappedfile.h>
+#include <rcsslogplayer/index.h>
 #include <rcsslogplayer/util.h>
 #include <rcsslogplayer/parser.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <cmath>
@@ -83,8 +86,9 @@ MainData::MainData()
     : M_out( static_cast< std::ostream * >( 0 ) )
     , M_record_mode( false )
     , M_record_playmode( rcss::rcg::PM_Null )
+    , M_follow_offset( 0 )
 {
-
+    M_disp_holder.setCompact( Options::instance().compactFrames() );
 }
 
 /*-------------------------------------------------------------------*/
@@ -93,6 +97,7 @@ MainData::MainData()
 */
 MainData::~MainData()
 {
+    closeFollow();
     closeOutputFile();
 }
 
@@ -109,51 +114,139 @@ MainData::clear()
 
 /*-------------------------------------------------------------------*/
 /*!
-  \todo multi-threaded
+
 */
 bool
 MainData::openRCG( const QString & file_path,
                    QWidget * parent )
 {
+    // uncompressed file is directly parsed on the mapped memory.
+    // compressed file (gzip, zstd or lz4) is decompressed into the memory.
+    // gzip members are inflated by all available cores.
+    boost::shared_ptr< rcss::MappedFile > mapped( new rcss::MappedFile );
+    if ( mapped->open( file_path.toLatin1() )
+         && mapped->isCompressed()
+         && ! mapped->inflate( QThread::idealThreadCount() ) )
+    {
+        mapped->close();
+    }
+
 #ifdef HAVE_LIBZ
-    rcss::gzifstream fin( file_path.toLatin1() );
+    rcss::gzifstream fin;
 #else
-    std::ifstream fin( file_path.toLatin1() );
+    std::ifstream fin;
 #endif
 
-    if ( ! fin )
+    if ( ! mapped->is_open() )
     {
-        std::cerr << "failed to open the rcg file. [" << file_path.toStdString() << "]"
-                  << std::endl;
-        return false;
+#ifdef HAVE_LIBZ
+        // inflate the next blocks while parsing
+        fin.setReadAhead( true );
+#endif
+        fin.open( file_path.toLatin1() );
+
+        if ( ! fin )
+        {
+            std::cerr << "failed to open the rcg file. [" << file_path.toStdString() << "]"
+                      << std::endl;
+            return false;
+        }
     }
 
     clear();
 
+    // the offset index built by rcgindex, if any, gives the progress range.
+    // the player never writes it, because the log directory may be read-only.
+    const std::string index_path = rcss::rcg::Index::indexFilePath( file_path.toStdString() );
+    rcss::rcg::Index index;
+    const bool has_index = ( mapped->is_open()
+                             && index.read( index_path )
+                             && index.isValidFor( mapped->data(), mapped->size() ) );
+
+    QTime timer;
+    timer.start();
+
+    // by default, the whole log is parsed, in parallel if it is mapped.
+    // in the lazy mode, the text log in the mapped file is only scanned.
+    // the columns and the show line positions are kept, and each frame is decoded on demand.
+    if ( mapped->is_open()
+         && Options::instance().lazyLoad()
+         && M_disp_holder.loadLazy( mapped ) )
+    {
+        std::cerr << "scanning elapsed " << timer.elapsed() << " [ms]" << std::endl;
+    }
+    else
+    {
+        const int max_time = ( has_index && ! index.shows().empty()
+                               ? index.shows().back().time_
+                               : -1 );
+        if ( ! parseRCG( *mapped, fin, max_time, parent ) )
+        {
+            std::cerr << "failed to parse the rcg file [" << file_path.toStdString() << "]."
+                      << std::endl;
+            fin.close();
+            return false;
+        }
+
+        std::cerr << "parsing elapsed " << timer.elapsed() << " [ms]" << std::endl;
+    }
+
+    fin.close();
+
+    std::cerr << "opened rcg file [" << file_path.toStdString()
+              << "]. data size = "
+              << M_disp_holder.dispInfoSize()
+              << std::endl;
+
+    Options::instance().setGameLogFile( file_path.toStdString() );
+    return true;
+}
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+MainData::parseRCG( const rcss::MappedFile & mapped,
+                    std::istream & fin,
+                    const int max_time,
+                    QWidget * parent )
+{
     // show progress dialog
     QProgressDialog progress_dialog( parent );
     progress_dialog.setWindowTitle( QObject::tr( "parsing rcg file..." ) );
-    progress_dialog.setRange( 0, 6000 );
+    progress_dialog.setRange( 0, ( max_time >= 0 ? std::max( 1, max_time ) : 6000 ) );
     progress_dialog.setValue( 0 );
     progress_dialog.setLabelText( QObject::tr( "Time: 0" ) );
     progress_dialog.setCancelButton( 0 ); // no cancel button
     progress_dialog.setMinimumDuration( 0 ); // no duration
 
-    QTime timer;
-    timer.start();
-
     rcss::rcg::Parser parser( M_disp_holder );
+    // consecutive frames are appended to the holder at once.
+    parser.setShowBlockSize( rcss::rcg::Parser::DEFAULT_SHOW_BLOCK_SIZE );
+    if ( mapped.is_open() )
+    {
+        // text lines in the mapped file are parsed by all available cores.
+        parser.setThreadCount( QThread::idealThreadCount() );
+    }
+
+    // in the parallel mode, each call parses a large block of lines.
+    const int progress_interval = ( parser.threadCount() > 1 ? 1 : 32 );
+    const int event_interval = ( parser.threadCount() > 1 ? 1 : 512 );
+
+    std::size_t pos = 0;
     int count = 0;
-    while (  parser.parse( fin ) )
+    while ( mapped.is_open()
+            ? parser.parse( mapped.data(), mapped.size(), pos )
+            : parser.parse( fin ) )
     {
         ++count;
 
-        if ( count % 32 == 1 )
+        if ( ( count - 1 ) % progress_interval == 0 )
         {
-            if ( ! M_disp_holder.dispInfoCont().empty() )
+            if ( M_disp_holder.dispInfoSize() > 0 )
             {
-                int time = M_disp_holder.dispInfoCont().back()->show_.time_;
+                int time = M_disp_holder.lastDispInfo()->show_.time_;
                 if ( time > progress_dialog.maximum() )
                 {
                     progress_dialog.setMaximum( progress_dialog.maximum() + 6000 );
@@ -163,7 +256,7 @@ MainData::openRCG( const QString & file_path,
             }
         }
 
-        if ( count % 512 == 1 )
+        if ( ( count - 1 ) % event_interval == 0 )
         {
             qApp->processEvents();
             std::fprintf( stdout, "parsing... %d\r", count );
@@ -171,21 +264,45 @@ MainData::openRCG( const QString & file_path,
         }
     }
 
-    std::cerr << "parsing elapsed " << timer.elapsed() << " [ms]" << std::endl;
+    return ( mapped.is_open()
+             ? pos >= mapped.size()
+             : fin.eof() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+MainData::openFollow( const QString & file_path )
+{
+    closeFollow();
 
-    if ( ! fin.eof() )
+    M_follow_in.open( file_path.toLatin1(),
+                      std::ios_base::in | std::ios_base::binary );
+    if ( ! M_follow_in.is_open() )
     {
-        std::cerr << "failed to parse the rcg file [" << file_path.toStdString() << "]."
+        std::cerr << "failed to open the rcg file. [" << file_path.toStdString() << "]"
                   << std::endl;
-        fin.close();
         return false;
     }
 
-    fin.close();
+    clear();
 
-    std::cerr << "opened rcg file [" << file_path.toStdString()
+    M_follow_parser.reset( new rcss::rcg::Parser( M_disp_holder ) );
+    // consecutive frames in the appended data are added at once.
+    M_follow_parser->setShowBlockSize( rcss::rcg::Parser::DEFAULT_SHOW_BLOCK_SIZE );
+
+    readFollowData();
+
+    if ( ! isFollowing() )
+    {
+        return false;
+    }
+
+    std::cerr << "following rcg file [" << file_path.toStdString()
               << "]. data size = "
-              << M_disp_holder.dispInfoCont().size()
+              << M_disp_holder.dispInfoSize()
               << std::endl;
 
     Options::instance().setGameLogFile( file_path.toStdString() );
@@ -195,13 +312,97 @@ MainData::openRCG( const QString & file_path,
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+void
+MainData::closeFollow()
+{
+    // the pending frames are delivered to the holder.
+    M_follow_parser.reset();
+
+    if ( M_follow_in.is_open() )
+    {
+        M_follow_in.close();
+    }
+    M_follow_in.clear();
+
+    M_follow_buf.clear();
+    M_follow_offset = 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+MainData::readFollowData()
+{
+    if ( ! isFollowing() )
+    {
+        return false;
+    }
+
+    // read the appended data from the last position.
+    char buf[8192];
+    for ( ; ; )
+    {
+        M_follow_in.read( buf, sizeof( buf ) );
+        const std::streamsize n = M_follow_in.gcount();
+        if ( n <= 0 )
+        {
+            break;
+        }
+        M_follow_buf.append( buf, n );
+    }
+    // clear the eof flag to read the data appended later.
+    M_follow_in.clear();
+
+    // only the text log can be parsed line by line.
+    if ( M_follow_offset == 0
+         && M_follow_buf.length() >= 4
+         && ( M_follow_buf.compare( 0, 3, "ULG" ) != 0
+              || M_follow_buf[3] < '4'
+              || '9' < M_follow_buf[3] ) )
+    {
+        std::cerr << "the follow mode supports only the text log (v4 or later)."
+                  << std::endl;
+        closeFollow();
+        return false;
+    }
+
+    const std::string::size_type last = M_follow_buf.rfind( '\n' );
+    if ( last == std::string::npos )
+    {
+        return false;
+    }
+
+    const std::size_t old_revision = M_disp_holder.frameRevision();
+
+    const std::size_t size = last + 1;
+    std::size_t pos = 0;
+    while ( pos < size
+            && M_follow_parser->parse( M_follow_buf.data(), size, pos ) )
+    {
+
+    }
+    M_follow_parser->flush();
+
+    M_follow_offset += pos;
+    M_follow_buf.erase( 0, pos );
+
+    // the last frame may be replaced without adding the new frame (e.g. before_kick_off)
+    return M_disp_holder.frameRevision() != old_revision;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 bool
 MainData::openOutputFile( const QString & file_path )
 {
     closeOutputFile();
 
-    if ( M_disp_holder.dispInfoCont().empty() )
+    if ( M_disp_holder.dispInfoSize() == 0 )
     {
         return false;
     }
@@ -548,9 +749,9 @@ MainData::serializeShow( std::ostream & os,
 bool
 MainData::setIndexFirst()
 {
-    M_index = 0;
+    changeIndex( 0 );
 
-    return ( ! M_disp_holder.dispInfoCont().empty() );
+    return ( M_disp_holder.dispInfoSize() > 0 );
 }
 
 /*-------------------------------------------------------------------*/
@@ -560,13 +761,13 @@ MainData::setIndexFirst()
 bool
 MainData::setIndexLast()
 {
-    if ( M_disp_holder.dispInfoCont().empty() )
+    if ( M_disp_holder.dispInfoSize() == 0 )
     {
-        M_index = 0;
+        changeIndex( 0 );
         return false;
     }
 
-    M_index = M_disp_holder.dispInfoCont().size() - 1;
+    changeIndex( M_disp_holder.dispInfoSize() - 1 );
     return true;
 }
 
@@ -579,14 +780,14 @@ MainData::setIndexStepBack()
 {
     if ( 0 < M_index )
     {
-        --M_index;
+        changeIndex( M_index - 1 );
         return true;
     }
     else
     {
         if ( Options::instance().autoLoopMode() )
         {
-            M_index = dispHolder().dispInfoCont().size() - 1;
+            changeIndex( dispHolder().dispInfoSize() - 1 );
             return true;
         }
         else
@@ -603,16 +804,16 @@ MainData::setIndexStepBack()
 bool
 MainData::setIndexStepForward()
 {
-    if ( M_index < dispHolder().dispInfoCont().size() - 1 )
+    if ( M_index < dispHolder().dispInfoSize() - 1 )
     {
-        ++M_index;
+        changeIndex( M_index + 1 );
         return true;
     }
     else
     {
         if ( Options::instance().autoLoopMode() )
         {
-            M_index = 0;
+            changeIndex( 0 );
             return true;
         }
         else
@@ -641,12 +842,12 @@ MainData::setIndex( const int index )
 
     std::size_t idx = static_cast< std::size_t >( index );
 
-    if ( idx >= dispHolder().dispInfoCont().size() )
+    if ( idx >= dispHolder().dispInfoSize() )
     {
         return false;
     }
 
-    M_index = idx;
+    changeIndex( idx );
 
     return true;
 }
@@ -656,16 +857,17 @@ MainData::setIndex( const int index )
 
 */
 bool
-MainData::setCycle( const int cycle )
+MainData::setCycle( const int cycle,
+                    const int sub_cycle )
 {
 
-    std::size_t index = M_disp_holder.getIndexOf( cycle );
+    std::size_t index = M_disp_holder.getIndexOf( cycle, sub_cycle );
 
     if ( index == M_index )
     {
         return false;
     }
 
-    M_index = index;
+    changeIndex( index );
     return true;
 }
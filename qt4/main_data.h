@@ -35,11 +35,21 @@
 
 #include "disp_holder.h"
 
+#include <fstream>
+#include <istream>
 #include <ostream>
+#include <string>
 
 class QString;
 class QWidget;
 
+namespace rcss {
+class MappedFile;
+namespace rcg {
+class Parser;
+}
+}
+
 class MainData {
 private:
 
@@ -51,9 +61,28 @@ private:
     rcss::rcg::PlayMode M_record_playmode;
     rcss::rcg::TeamT M_record_team[2];
 
+    //! the game log file followed in the follow mode
+    std::ifstream M_follow_in;
+    //! parser kept while following the file. NULL if not in the follow mode.
+    boost::shared_ptr< rcss::rcg::Parser > M_follow_parser;
+    //! appended data not parsed yet. the incomplete last line remains here.
+    std::string M_follow_buf;
+    //! byte length of the parsed data in the followed file
+    std::size_t M_follow_offset;
+
     // not used
     MainData( const MainData & );
     const MainData & operator=( const MainData & );
+
+    /*!
+      \brief change the current index. the lazy cache of the holder follows it.
+      \param idx new frame index
+     */
+    void changeIndex( const std::size_t idx )
+      {
+          M_index = idx;
+          M_disp_holder.setCurrentIndex( idx );
+      }
 public:
 
     MainData();
@@ -109,12 +138,46 @@ public:
     bool openRCG( const QString & file_path,
                   QWidget * parant );
 
+    /*!
+      \brief start to follow the v4+ text log written by the running server.
+      \param file_path game log file path
+      \return true if the file is opened.
+
+      The current contents are parsed at once, and the data appended later
+      are parsed by readFollowData().
+     */
+    bool openFollow( const QString & file_path );
+
+    /*!
+      \brief stop the follow mode.
+     */
+    void closeFollow();
+
+    bool isFollowing() const
+      {
+          return M_follow_parser.get() != 0;
+      }
+
+    /*!
+      \brief parse the data appended to the followed file since the last call.
+      \return true if the last frame is updated.
+
+      The file is read from the last position, so the parsed data are never read again.
+      The incomplete last line is kept until its new line character is written.
+     */
+    bool readFollowData();
+
     bool openOutputFile( const QString & file_path );
     void setEnableRecord( bool checked );
     void outputCurrentData();
     void closeOutputFile();
 
 private:
+    bool parseRCG( const rcss::MappedFile & mapped,
+                   std::istream & fin,
+                   const int max_time,
+                   QWidget * parent );
+
     void serializeShow( std::ostream & os,
                         const rcss::rcg::DispInfoT & disp );
 
@@ -127,7 +190,8 @@ public:
     bool setIndexStepForward();
 
     bool setIndex( const int index );
-    bool setCycle( const int cycle );
+    bool setCycle( const int cycle,
+                   const int sub_cycle = 0 );
 
 };
 
@@ -85,6 +85,7 @@ MainWindow::MainWindow()
     , M_monitor_server( static_cast< MonitorServer * >( 0 ) )
     , M_monitor_client( static_cast< MonitorClient * >( 0 ) )
     , M_monitor_process( static_cast< QProcess * >( 0 ) )
+    , M_follow_watcher( static_cast< QFileSystemWatcher * >( 0 ) )
 {
     readSettings();
 
@@ -169,7 +170,14 @@ MainWindow::init()
 
     if ( ! Options::instance().gameLogFile().empty() )
     {
-        openRCG( QString::fromStdString( Options::instance().gameLogFile() ) );
+        if ( Options::instance().followMode() )
+        {
+            followRCG( QString::fromStdString( Options::instance().gameLogFile() ) );
+        }
+        else
+        {
+            openRCG( QString::fromStdString( Options::instance().gameLogFile() ) );
+        }
     }
     else if ( Options::instance().connect() )
     {
@@ -1281,6 +1289,7 @@ MainWindow::openRCG( const QString & file_path )
 
     M_log_player->stop();
     disconnectMonitor();
+    closeFollow();
     M_open_output_act->setEnabled( false );
     M_save_image_act->setEnabled( false );
     M_log_player_tool_bar->checkRecord( false );
@@ -1311,7 +1320,7 @@ MainWindow::openRCG( const QString & file_path )
         return;
     }
 
-    if ( M_main_data.dispHolder().dispInfoCont().empty() )
+    if ( M_main_data.dispHolder().dispInfoSize() == 0 )
     {
         if ( Options::instance().autoQuitMode() )
         {
@@ -1372,6 +1381,100 @@ MainWindow::openRCG( const QString & file_path )
     emit viewUpdated();
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::followRCG( const QString & file_path )
+{
+    if ( ! QFile::exists( file_path ) )
+    {
+        std::cerr << "File [" << file_path.toStdString()
+                  << "] does not exist."
+                  << std::endl;
+        return;
+    }
+
+    M_log_player->stop();
+    disconnectMonitor();
+    closeFollow();
+    M_open_output_act->setEnabled( false );
+    M_save_image_act->setEnabled( false );
+    M_log_player_tool_bar->checkRecord( false );
+    M_log_player_tool_bar->enableRecord( false );
+    M_main_data.closeOutputFile();
+
+    if ( ! M_main_data.openFollow( file_path ) )
+    {
+        QString err_msg = tr( "Failed to follow [" );
+        err_msg += file_path;
+        err_msg += tr( "]" );
+        QMessageBox::critical( this,
+                               tr( "Error" ),
+                               err_msg,
+                               QMessageBox::Ok, QMessageBox::NoButton );
+        this->setWindowTitle( tr( PACKAGE_NAME ) );
+        this->statusBar()->showMessage( tr( "Ready" ) );
+        return;
+    }
+
+    // the file modification is notified by inotify on Linux.
+    M_follow_watcher = new QFileSystemWatcher( this );
+    M_follow_watcher->addPath( file_path );
+    connect( M_follow_watcher, SIGNAL( fileChanged( const QString & ) ),
+             this, SLOT( receiveFollowData() ) );
+
+    // update last opened file path
+    QFileInfo file_info( file_path );
+    M_game_log_path = file_info.absoluteFilePath();
+    Options::instance().setGameLogFile( M_game_log_path.toStdString() );
+
+    if ( M_config_dialog )
+    {
+        M_config_dialog->unzoom();
+    }
+
+    // set window title
+    QString name = file_info.fileName();
+    if ( name.length() > 128 )
+    {
+        name.replace( 125, name.length() - 125, tr( "..." ) );
+    }
+    this->setWindowTitle( name + tr( " - " ) + tr( PACKAGE_NAME ) );
+    this->statusBar()->showMessage( name );
+
+    createMonitorServer();
+    M_open_output_act->setEnabled( true );
+    M_save_image_act->setEnabled( true );
+    M_set_live_mode_act->setEnabled( true );
+
+    // the view tracks the tail of the file.
+    M_log_player->setLiveMode();
+
+    emit viewUpdated();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::closeFollow()
+{
+    if ( M_follow_watcher )
+    {
+        delete M_follow_watcher;
+        M_follow_watcher = static_cast< QFileSystemWatcher * >( 0 );
+    }
+
+    if ( M_main_data.isFollowing() )
+    {
+        M_main_data.closeFollow();
+        M_set_live_mode_act->setEnabled( false );
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1555,8 +1658,9 @@ MainWindow::kickOff()
 void
 MainWindow::setLiveMode()
 {
-    if ( M_monitor_client
-         && M_monitor_client->isConnected() )
+    if ( ( M_monitor_client
+           && M_monitor_client->isConnected() )
+         || M_main_data.isFollowing() )
     {
         M_log_player->setLiveMode();
     }
@@ -1621,6 +1725,7 @@ MainWindow::connectMonitorTo( const char * hostname )
     M_open_output_act->setEnabled( false );
 
     closeMonitorServer();
+    closeFollow();
 
     std::cerr << "Connect to [" << hostname << "] ..." << std::endl;
 
@@ -2076,6 +2181,28 @@ MainWindow::receiveMonitorPacket()
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::receiveFollowData()
+{
+    if ( ! M_main_data.readFollowData() )
+    {
+        return;
+    }
+
+    if ( M_log_player->isLiveMode() )
+    {
+        M_log_player->showLive();
+    }
+    else
+    {
+        M_log_slider_tool_bar->updateSlider();
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -44,6 +44,7 @@ class QActionGroup;
 class QCloseEvent;
 class QDragEnterEvent;
 class QDropEvent;
+class QFileSystemWatcher;
 class QLabel;
 class QPoint;
 class QResizeEvent;
@@ -86,6 +87,9 @@ private:
     // monitor process
     QProcess * M_monitor_process;
 
+    //! watcher of the game log file in the follow mode
+    QFileSystemWatcher * M_follow_watcher;
+
     // file actions
     QAction * M_open_act;
     QAction * M_open_output_act;
@@ -163,6 +167,8 @@ protected:
 private:
 
     void openRCG( const QString & file_path );
+    void followRCG( const QString & file_path );
+    void closeFollow();
     void openOutputFile( const QString & file_path );
     void connectMonitorTo( const char * hostname );
 
@@ -208,6 +214,7 @@ public slots:
     void toggleRecord( bool checked );
 
     void receiveMonitorPacket();
+    void receiveFollowData();
 
     void updatePositionLabel( const QPoint & point );
 
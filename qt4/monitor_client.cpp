@@ -175,14 +175,21 @@ MonitorClient::handleReceive()
         while ( M_socket->hasPendingDatagrams() )
         {
             quint16 from_port;
+            // keep the last byte for the terminating null character
             int n = M_socket->readDatagram( buf,
-                                            8192,
+                                            sizeof( buf ) - 1,
                                             0, // QHostAddress*
                                             &from_port );
             if ( n > 0 )
             {
                 buf[n] = '\0';
-                if ( ! M_disp_holder.addDispInfo3( buf ) )
+                // the server may send the terminating null character
+                while ( n > 0 && buf[n - 1] == '\0' )
+                {
+                    --n;
+                }
+                // the show line is parsed directly from the receive buffer
+                if ( ! M_disp_holder.addDispInfo3( buf, n ) )
                 {
                     std::cerr << "recv: " << buf << std::endl;
                 }
@@ -105,6 +105,9 @@ Options::Options()
     , M_monitor_path( "self" )
     , M_monitor_port( 6000 )
     , M_game_log_file( "" )
+    , M_follow_mode( false )
+    , M_compact_frames( false )
+    , M_lazy_load( false )
     , M_output_file( "" )
     , M_auto_quit_mode( false )
     , M_auto_quit_wait( 5 )
@@ -439,6 +442,18 @@ Options::parseCmdLine( int argc,
 //         ( "output-file",
 //           po::value< std::string >( &M_output_file )->default_value( "", "" ),
 //           "set the output file path." )
+        ( "follow",
+          po::bool_switch( &M_follow_mode ),
+          "follow the game log file written by the running server, like 'tail -f'." )
+        ( "compact-frames",
+          po::bool_switch( &M_compact_frames ),
+          "store the frames in the compact encoding to reduce the memory usage."
+          " velocities are rounded to 1e-4 and angles to 1e-2 degree."
+          " the memory is not reduced if the player attributes change at random in every frame." )
+        ( "lazy-load",
+          po::bool_switch( &M_lazy_load ),
+          "scan the uncompressed text log at the open, and decode each frame when it is shown."
+          " the memory usage is reduced, but the normal load parses the log by all available cores." )
         ( "auto-quit-mode",
           po::value< bool >( &M_auto_quit_mode )->default_value( false, "off" ),
           "enable automatic quit mode." )
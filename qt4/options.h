@@ -109,6 +109,9 @@ private:
     std::string M_monitor_path;
     int M_monitor_port;
     std::string M_game_log_file; //!< game log file path to be opened
+    bool M_follow_mode; //!< if true, the game log file is followed while it grows.
+    bool M_compact_frames; //!< if true, the frames are stored in the compact encoding.
+    bool M_lazy_load; //!< if true, the uncompressed text log is scanned and each frame is decoded on demand.
     std::string M_output_file;
     bool M_auto_quit_mode;
     int M_auto_quit_wait;
@@ -289,6 +292,21 @@ public:
           M_game_log_file = path;
       }
 
+    bool followMode() const
+      {
+          return M_follow_mode;
+      }
+
+    bool compactFrames() const
+      {
+          return M_compact_frames;
+      }
+
+    bool lazyLoad() const
+      {
+          return M_lazy_load;
+      }
+
     const
     std::string & outputFile() const
       {
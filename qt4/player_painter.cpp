@@ -1048,8 +1048,9 @@ PlayerPainter::drawTrace( QPainter & painter,
         return;
     }
 
-    const std::vector< DispPtr > & cont = M_main_data.dispHolder().dispInfoCont();
-    if ( cont.empty() )
+    // the positions are read from the columns directly, also in the lazy mode.
+    const rcss::rcg::FrameStore & frames = M_main_data.dispHolder().frames();
+    if ( frames.empty() )
     {
         return;
     }
@@ -1074,12 +1075,12 @@ PlayerPainter::drawTrace( QPainter & painter,
     painter.setBrush( Qt::NoBrush );
 
     std::size_t i = first;
-    int prev_x = opt.screenX( cont[i]->show_.player_[idx].x_ );
-    int prev_y = opt.screenY( cont[i]->show_.player_[idx].y_ );
+    int prev_x = opt.screenX( frames.playerX( i, idx ) );
+    int prev_y = opt.screenY( frames.playerY( i, idx ) );
     ++i;
     for ( ; i <= last; ++i )
     {
-        switch ( cont[i]->pmode_ ) {
+        switch ( frames.pmode( i ) ) {
         case rcss::rcg::PM_BeforeKickOff:
         case rcss::rcg::PM_TimeOver:
         case rcss::rcg::PM_AfterGoal_Left:
@@ -1093,8 +1094,8 @@ PlayerPainter::drawTrace( QPainter & painter,
             break;
         }
 
-        int ix = opt.screenX( cont[i]->show_.player_[idx].x_ );
-        int iy = opt.screenY( cont[i]->show_.player_[idx].y_ );
+        int ix = opt.screenX( frames.playerX( i, idx ) );
+        int iy = opt.screenY( frames.playerY( i, idx ) );
 
         painter.drawLine( prev_x, prev_y, ix, iy );
         if ( ! line_trace )
@@ -22,11 +22,11 @@ win32 {
 }
 unix {
   LIBS += -L/opt/local/lib
-  LIBS += -lboost_program_options-mt -lz
+  LIBS += -lboost_program_options-mt -lz -lpthread
 }
 macx {
   LIBS += -L/opt/local/lib
-  LIBS += -lboost_program_options-mt -lz
+  LIBS += -lboost_program_options-mt -lz -lpthread
 }
 
 DEFINES += HAVE_LIBZ
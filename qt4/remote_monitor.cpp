@@ -240,8 +240,8 @@ RemoteMonitor::serializeDisp( const rcss::rcg::DispInfoT & disp,
         {
             ostr << ' ' << disp.team_[0].pen_score_
                  << ' ' << disp.team_[0].pen_miss_
-                 << ' ' << disp.team_[0].pen_score_
-                 << ' ' << disp.team_[0].pen_miss_;
+                 << ' ' << disp.team_[1].pen_score_
+                 << ' ' << disp.team_[1].pen_miss_;
         }
         ostr << ')';
     }
@@ -320,6 +320,11 @@ RemoteMonitor::serializeDisp( const rcss::rcg::DispInfoT & disp,
             }
         }
 
+        if ( p.isFocusing() )
+        {
+            ostr << " (f " << p.focus_side_ << ' ' << p.focus_unum_ << ')';
+        }
+
         ostr << " (c "
              << p.kick_count_ << ' '
              << p.dash_count_ << ' '
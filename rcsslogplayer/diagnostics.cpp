@@ -0,0 +1,252 @@
+// -*-c++-*-
+
+/*!
+  \file diagnostics.cpp
+  \brief rcg parse diagnostics Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "diagnostics.h"
+
+#include <iostream>
+
+namespace rcss {
+namespace rcg {
+
+const std::size_t Diagnostics::DEFAULT_SAMPLE_LIMIT = 16;
+const std::size_t Diagnostics::MAX_EXCERPT_LENGTH = 160;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Diagnostics::Diagnostics()
+    : M_samples(),
+      M_sample_limit( DEFAULT_SAMPLE_LIMIT ),
+      M_print( true ),
+      M_suppressed( false ),
+      M_callback( static_cast< Callback * >( 0 ) )
+{
+    for ( int i = 0; i < MAX_CATEGORY; ++i )
+    {
+        M_counts[i] = 0;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Diagnostics::clear()
+{
+    for ( int i = 0; i < MAX_CATEGORY; ++i )
+    {
+        M_counts[i] = 0;
+    }
+    M_samples.clear();
+    M_suppressed = false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+Diagnostics::totalCount() const
+{
+    std::size_t total = 0;
+    for ( int i = 0; i < MAX_CATEGORY; ++i )
+    {
+        total += M_counts[i];
+    }
+    return total;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Diagnostics::report( const Category category,
+                     const long n_line,
+                     const char * what,
+                     const char * record,
+                     const std::size_t len )
+{
+    ++M_counts[category];
+
+    if ( M_samples.size() >= M_sample_limit )
+    {
+        suppress();
+        return;
+    }
+
+    Sample sample;
+    sample.category_ = category;
+    sample.line_ = n_line;
+    sample.message_ = what;
+
+    if ( record )
+    {
+        const bool truncated = ( len > MAX_EXCERPT_LENGTH );
+        sample.message_ += " \"";
+        sample.message_.append( record, truncated ? MAX_EXCERPT_LENGTH : len );
+        if ( truncated )
+        {
+            sample.message_ += "...";
+        }
+        sample.message_ += '\"';
+    }
+
+    addSample( sample );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Diagnostics::merge( const Diagnostics & other )
+{
+    for ( int i = 0; i < MAX_CATEGORY; ++i )
+    {
+        M_counts[i] += other.M_counts[i];
+    }
+
+    for ( std::vector< Sample >::const_iterator it = other.M_samples.begin(), end = other.M_samples.end();
+          it != end && M_samples.size() < M_sample_limit;
+          ++it )
+    {
+        addSample( *it );
+    }
+
+    if ( totalCount() > M_samples.size() )
+    {
+        suppress();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+Diagnostics::printSummary( std::ostream & os ) const
+{
+    for ( int i = 0; i < MAX_CATEGORY; ++i )
+    {
+        if ( M_counts[i] > 0 )
+        {
+            os << categoryName( static_cast< Category >( i ) ) << ": "
+               << M_counts[i] << '\n';
+        }
+    }
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const char *
+Diagnostics::categoryName( const Category category )
+{
+    switch ( category ) {
+    case READ_ERROR:
+        return "read_error";
+    case UNKNOWN_RECORD:
+        return "unknown_record";
+    case SHOW_ERROR:
+        return "show_error";
+    case DRAW_ERROR:
+        return "draw_error";
+    case MSG_ERROR:
+        return "msg_error";
+    case PLAYMODE_ERROR:
+        return "playmode_error";
+    case TEAM_ERROR:
+        return "team_error";
+    case PARAM_ERROR:
+        return "param_error";
+    case PARAM_WARNING:
+        return "param_warning";
+    default:
+        break;
+    }
+    return "unknown";
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Diagnostics::addSample( const Sample & sample )
+{
+    M_samples.push_back( sample );
+
+    if ( M_print )
+    {
+        std::cerr << sample.line_
+                  << ( sample.category_ == PARAM_WARNING ? ": warning: " : ": error: " )
+                  << sample.message_
+                  << std::endl;
+    }
+
+    if ( M_callback )
+    {
+        M_callback->report( sample );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Diagnostics::suppress()
+{
+    if ( M_suppressed )
+    {
+        return;
+    }
+
+    M_suppressed = true;
+    if ( M_print )
+    {
+        std::cerr << "rcg: too many errors. further messages are suppressed."
+                  << std::endl;
+    }
+}
+
+}
+}
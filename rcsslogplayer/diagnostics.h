@@ -0,0 +1,254 @@
+// -*-c++-*-
+
+/*!
+  \file diagnostics.h
+  \brief rcg parse diagnostics Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_DIAGNOSTICS_H
+#define RCSSLOGPLAYER_DIAGNOSTICS_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstddef>
+
+namespace rcss {
+namespace rcg {
+
+/*!
+  \class Diagnostics
+  \brief error and warning sink of the parser.
+
+  Every report is counted for each category, but only the first reports
+  are kept as the samples, printed to std::cerr and passed to the optional
+  callback. So the cost of the broken log is bounded, however many records
+  are broken.
+*/
+class Diagnostics {
+public:
+
+    /*!
+      \enum Category
+      \brief error class
+     */
+    enum Category {
+        READ_ERROR, //!< failed to read the data
+        UNKNOWN_RECORD, //!< unknown record type
+        SHOW_ERROR, //!< illegal show record
+        DRAW_ERROR, //!< illegal draw record
+        MSG_ERROR, //!< illegal msg record
+        PLAYMODE_ERROR, //!< illegal playmode record
+        TEAM_ERROR, //!< illegal team record
+        PARAM_ERROR, //!< illegal parameter record or value
+        PARAM_WARNING, //!< unsupported parameter name
+        MAX_CATEGORY
+    };
+
+    /*!
+      \struct Sample
+      \brief a kept report
+     */
+    struct Sample {
+        Category category_; //!< error class
+        long line_; //!< line number in the text log. byte offset in the binary log. negative value if unknown.
+        std::string message_; //!< message including the excerpt of the record
+    };
+
+    /*!
+      \class Callback
+      \brief abstract receiver of the reports
+     */
+    class Callback {
+    public:
+        virtual
+        ~Callback()
+          { }
+
+        /*!
+          \brief called for each kept sample.
+          \param sample reported data
+         */
+        virtual
+        void report( const Sample & sample ) = 0;
+    };
+
+    //! default number of kept samples
+    static const std::size_t DEFAULT_SAMPLE_LIMIT;
+    //! maximum length of the record excerpt in the message
+    static const std::size_t MAX_EXCERPT_LENGTH;
+
+private:
+
+    std::size_t M_counts[MAX_CATEGORY]; //!< the number of reports for each category
+    std::vector< Sample > M_samples; //!< kept reports
+    std::size_t M_sample_limit; //!< maximum number of kept samples
+    bool M_print; //!< if true, kept samples are printed to std::cerr
+    bool M_suppressed; //!< true if the suppression notice has already been printed
+    Callback * M_callback; //!< optional receiver. not owned by this class.
+
+public:
+
+    /*!
+      \brief initialize counters. samples are printed by default.
+     */
+    Diagnostics();
+
+    /*!
+      \brief clear all counters and samples. settings are not changed.
+     */
+    void clear();
+
+    /*!
+      \brief set the maximum number of kept samples
+      \param limit the number of samples
+     */
+    void setSampleLimit( const std::size_t limit )
+      {
+          M_sample_limit = limit;
+      }
+
+    std::size_t sampleLimit() const
+      {
+          return M_sample_limit;
+      }
+
+    /*!
+      \brief set the print mode.
+      \param on if true, kept samples are printed to std::cerr.
+     */
+    void setPrint( const bool on )
+      {
+          M_print = on;
+      }
+
+    bool isPrint() const
+      {
+          return M_print;
+      }
+
+    /*!
+      \brief set the receiver of the kept samples.
+      \param callback pointer to the receiver. NULL to disable the callback.
+      The receiver must be alive while it is used.
+     */
+    void setCallback( Callback * callback )
+      {
+          M_callback = callback;
+      }
+
+    /*!
+      \brief get the number of reports
+      \param category error class
+      \return the number of reports
+     */
+    std::size_t count( const Category category ) const
+      {
+          return M_counts[category];
+      }
+
+    /*!
+      \brief get the number of all reports
+      \return the number of reports
+     */
+    std::size_t totalCount() const;
+
+    /*!
+      \brief get the kept samples
+      \return const reference to the sample container
+     */
+    const std::vector< Sample > & samples() const
+      {
+          return M_samples;
+      }
+
+    /*!
+      \brief report an error.
+      \param category error class
+      \param n_line line number or byte offset. negative value if unknown.
+      \param what short description
+      \param record head of the offending record. NULL if no record.
+      \param len length of the record. it is shortened to MAX_EXCERPT_LENGTH.
+
+      The message string is built only if the sample is kept.
+     */
+    void report( const Category category,
+                 const long n_line,
+                 const char * what,
+                 const char * record = 0,
+                 const std::size_t len = 0 );
+
+    /*!
+      \brief report an error.
+      \param category error class
+      \param n_line line number or byte offset. negative value if unknown.
+      \param what short description
+      \param record offending record
+     */
+    void report( const Category category,
+                 const long n_line,
+                 const char * what,
+                 const std::string & record )
+      {
+          report( category, n_line, what, record.data(), record.length() );
+      }
+
+    /*!
+      \brief add the reports in other sink.
+      \param other other sink
+
+      The counts are summed up. The samples of other sink are kept
+      (and printed) while the sample limit of this sink allows.
+     */
+    void merge( const Diagnostics & other );
+
+    /*!
+      \brief print the number of reports for each category.
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    std::ostream & printSummary( std::ostream & os ) const;
+
+    /*!
+      \brief get the name of category
+      \param category error class
+      \return category name string
+     */
+    static
+    const char * categoryName( const Category category );
+
+private:
+
+    void addSample( const Sample & sample );
+    void suppress();
+};
+
+}
+}
+
+#endif
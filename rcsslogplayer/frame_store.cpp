@@ -0,0 +1,780 @@
+// -*-c++-*-
+
+/*!
+  \file frame_store.cpp
+  \brief columnar display data container Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "frame_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace rcss {
+namespace rcg {
+
+namespace {
+
+//! encoded value of SHOWINFO_SCALE2F (i.e. no data)
+const Int16 NO_VALUE16 = -32767 - 1;
+//! encoded value of SHOWINFO_SCALE2F (i.e. no data)
+const Int32 NO_VALUE32 = -2147483647 - 1;
+
+//! the player data are stored as they are. this flag is in the last 2 bits of the counts.
+const unsigned char FLAG_RAW = 0x40;
+//! the absolute command counts are stored. this flag is in the last 2 bits of the counts.
+const unsigned char FLAG_COUNTS = 0x80;
+//! the mask of the state bits stored in the encoded player data.
+const Int32 STATE_LOWER_MASK = 0x0000ffff;
+
+/*!
+  \brief spread 4 differences in the byte to 8 bit lanes.
+  \param b 4 differences of 2 bits
+  \return 4 differences of 8 bits
+ */
+inline
+UInt32
+spread_diffs( const unsigned char b )
+{
+    return ( ( b & 0x03 )
+             | ( ( b & 0x0c ) << 6 )
+             | ( ( b & 0x30 ) << 12 )
+             | ( ( UInt32 )( b & 0xc0 ) << 18 ) );
+}
+
+inline
+bool
+pack16( const float val,
+        const double scale,
+        Int16 & result )
+{
+    if ( val == SHOWINFO_SCALE2F )
+    {
+        result = NO_VALUE16;
+        return true;
+    }
+
+    const double v = std::floor( val * scale + 0.5 );
+    if ( ! ( -32767.0 <= v && v <= 32767.0 ) ) // also false if NaN
+    {
+        return false;
+    }
+
+    result = static_cast< Int16 >( v );
+    return true;
+}
+
+inline
+bool
+pack32( const float val,
+        const double scale,
+        Int32 & result )
+{
+    if ( val == SHOWINFO_SCALE2F )
+    {
+        result = NO_VALUE32;
+        return true;
+    }
+
+    const double v = std::floor( val * scale + 0.5 );
+    if ( ! ( -2147483647.0 <= v && v <= 2147483647.0 ) )
+    {
+        return false;
+    }
+
+    result = static_cast< Int32 >( v );
+    return true;
+}
+
+inline
+float
+unpack16( const Int16 val,
+          const double scale )
+{
+    return ( val == NO_VALUE16
+             ? SHOWINFO_SCALE2F
+             : static_cast< float >( val / scale ) );
+}
+
+inline
+float
+unpack32( const Int32 val,
+          const double scale )
+{
+    return ( val == NO_VALUE32
+             ? SHOWINFO_SCALE2F
+             : static_cast< float >( val / scale ) );
+}
+
+/*!
+  \brief compare the key of the raw data record
+ */
+struct KeyLess {
+    template < typename T >
+    bool operator()( const T & lhs,
+                     const UInt32 rhs ) const
+      {
+          return lhs.key_ < rhs;
+      }
+};
+
+/*!
+  \brief find the raw data record. the record must exist.
+  \param v records sorted by the key
+  \param key frame * MAX_PLAYER*2 + player
+  \return const reference to the record
+ */
+template < typename T >
+const T &
+find_raw( const std::vector< T > & v,
+          const UInt32 key )
+{
+    return *std::lower_bound( v.begin(), v.end(), key, KeyLess() );
+}
+
+/*!
+  \brief remove the raw data records of the frame and later.
+  \param v records sorted by the key
+  \param key the first key of the frame
+ */
+template < typename T >
+void
+pop_raw( std::vector< T > & v,
+         const UInt32 key )
+{
+    while ( ! v.empty()
+            && v.back().key_ >= key )
+    {
+        v.pop_back();
+    }
+}
+
+inline
+void
+get_counts( const PlayerT & p,
+            UInt16 * counts )
+{
+    counts[0] = p.kick_count_;
+    counts[1] = p.dash_count_;
+    counts[2] = p.turn_count_;
+    counts[3] = p.catch_count_;
+    counts[4] = p.move_count_;
+    counts[5] = p.turn_neck_count_;
+    counts[6] = p.change_view_count_;
+    counts[7] = p.say_count_;
+    counts[8] = p.tackle_count_;
+    counts[9] = p.pointto_count_;
+    counts[10] = p.attentionto_count_;
+}
+
+inline
+void
+set_counts( const UInt16 * counts,
+            PlayerT & p )
+{
+    p.kick_count_ = counts[0];
+    p.dash_count_ = counts[1];
+    p.turn_count_ = counts[2];
+    p.catch_count_ = counts[3];
+    p.move_count_ = counts[4];
+    p.turn_neck_count_ = counts[5];
+    p.change_view_count_ = counts[6];
+    p.say_count_ = counts[7];
+    p.tackle_count_ = counts[8];
+    p.pointto_count_ = counts[9];
+    p.attentionto_count_ = counts[10];
+}
+
+}
+
+const std::size_t FrameStore::CHUNK_SIZE;
+const std::size_t FrameStore::KEY_INTERVAL;
+const std::size_t FrameStore::DECODE_CACHE_SIZE;
+const int FrameStore::COMMAND_COUNT;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+FrameStore::FrameStore( const bool compact )
+    : M_compact( compact ),
+      M_columns_only( false ),
+      M_size( 0 ),
+      M_decoded_next( 0 )
+{
+    std::memset( M_last_counts, 0, sizeof( M_last_counts ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::clear()
+{
+    M_size = 0;
+    std::vector< ChunkPtr >().swap( M_chunks );
+    M_time_index.clear();
+    std::memset( M_last_counts, 0, sizeof( M_last_counts ) );
+    clearDecoded();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::setCompact( const bool on )
+{
+    if ( M_compact == on )
+    {
+        return;
+    }
+
+    if ( M_columns_only )
+    {
+        // no display data to be encoded again
+        M_compact = on;
+        return;
+    }
+
+    FrameStore tmp( on );
+
+    DispInfoT disp;
+    for ( std::size_t i = 0; i < M_size; ++i )
+    {
+        decode( i, disp );
+        tmp.push_back( disp );
+    }
+
+    M_compact = on;
+    M_chunks.swap( tmp.M_chunks );
+    clearDecoded();
+    std::memcpy( M_last_counts, tmp.M_last_counts, sizeof( M_last_counts ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::setColumnsOnly( const bool on )
+{
+    if ( M_columns_only == on )
+    {
+        return;
+    }
+
+    clear();
+    M_columns_only = on;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::push_back( const DispInfoT & disp )
+{
+    if ( M_size == M_chunks.size() * CHUNK_SIZE )
+    {
+        ChunkPtr c( new Chunk );
+        if ( M_columns_only )
+        {
+            // only the columns are used.
+        }
+        else if ( M_compact )
+        {
+            c->packed_.resize( CHUNK_SIZE );
+            c->keys_.resize( ( CHUNK_SIZE / KEY_INTERVAL ) * MAX_PLAYER*2 );
+        }
+        else
+        {
+            c->disp_.resize( CHUNK_SIZE );
+        }
+        M_chunks.push_back( c );
+    }
+
+    set( M_size, disp );
+    ++M_size;
+    M_time_index.push_back( disp.show_.time_ );
+
+    if ( M_compact
+         && ! M_columns_only
+         && M_size % CHUNK_SIZE == 0 )
+    {
+        // the chunk is full. release the unused capacity of the history.
+        Chunk & c = *M_chunks.back();
+        std::vector< TeamPair >( c.teams_ ).swap( c.teams_ );
+        std::vector< RawCounts >( c.raw_counts_ ).swap( c.raw_counts_ );
+        std::vector< RawPlayer >( c.raw_players_ ).swap( c.raw_players_ );
+        for ( int p = 0; p < MAX_PLAYER*2; ++p )
+        {
+            std::vector< PlayerAttr >( c.attrs_[p] ).swap( c.attrs_[p] );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::setBack( const DispInfoT & disp )
+{
+    set( M_size - 1, disp );
+    M_time_index.setBack( disp.show_.time_ );
+
+    // the decoded copy held by others is not changed.
+    for ( std::size_t n = 0; n < DECODE_CACHE_SIZE; ++n )
+    {
+        if ( M_decoded[n].disp_
+             && M_decoded[n].index_ == M_size - 1 )
+        {
+            M_decoded[n].disp_.reset();
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+FrameStore::bisect( const UInt32 time ) const
+{
+    std::size_t first = 0;
+    std::size_t count = M_size;
+    while ( count > 0 )
+    {
+        const std::size_t half = count / 2;
+        if ( this->time( first + half ) < time )
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+
+    return first;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::set( const std::size_t idx,
+                 const DispInfoT & disp )
+{
+    Chunk & c = *M_chunks[idx / CHUNK_SIZE];
+    const std::size_t i = idx % CHUNK_SIZE;
+
+    c.time_[i] = disp.show_.time_;
+    c.pmode_[i] = static_cast< unsigned char >( disp.pmode_ );
+
+    c.ball_x_[i] = disp.show_.ball_.x_;
+    c.ball_y_[i] = disp.show_.ball_.y_;
+    for ( int p = 0; p < MAX_PLAYER*2; ++p )
+    {
+        c.player_x_[p][i] = disp.show_.player_[p].x_;
+        c.player_y_[p][i] = disp.show_.player_[p].y_;
+    }
+
+    if ( M_columns_only )
+    {
+        return;
+    }
+
+    if ( M_compact )
+    {
+        encode( idx, disp );
+    }
+    else
+    {
+        c.disp_[i] = disp;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::encode( const std::size_t idx,
+                    const DispInfoT & disp )
+{
+    Chunk & c = *M_chunks[idx / CHUNK_SIZE];
+    const std::size_t i = idx % CHUNK_SIZE;
+    const bool replace = ( idx < M_size );
+    PackedFrame & frame = c.packed_[i];
+
+    c.ball_vx_[i] = disp.show_.ball_.vx_;
+    c.ball_vy_[i] = disp.show_.ball_.vy_;
+
+    //
+    // team info
+    //
+
+    if ( replace
+         && static_cast< std::size_t >( frame.team_ ) + 1 == c.teams_.size()
+         && ( i == 0 || c.packed_[i - 1].team_ != frame.team_ ) )
+    {
+        // the last record is used only by the replaced frame.
+        c.teams_.pop_back();
+    }
+
+    if ( c.teams_.empty()
+         || ! c.teams_.back().team_[0].equals( disp.team_[0] )
+         || ! c.teams_.back().team_[1].equals( disp.team_[1] ) )
+    {
+        TeamPair teams;
+        teams.team_[0] = disp.team_[0];
+        teams.team_[1] = disp.team_[1];
+        c.teams_.push_back( teams );
+    }
+    frame.team_ = static_cast< UInt16 >( c.teams_.size() - 1 );
+
+    //
+    // players
+    //
+
+    const CommandCounts * prev_counts = M_last_counts[replace ? 0 : 1];
+    const UInt32 first_key = static_cast< UInt32 >( i * MAX_PLAYER*2 );
+
+    if ( replace )
+    {
+        pop_raw( c.raw_counts_, first_key );
+        pop_raw( c.raw_players_, first_key );
+    }
+
+    for ( int p = 0; p < MAX_PLAYER*2; ++p )
+    {
+        const PlayerT & player = disp.show_.player_[p];
+        PackedPlayer & packed = frame.player_[p];
+
+        if ( replace )
+        {
+            if ( static_cast< std::size_t >( packed.attr_ ) + 1 == c.attrs_[p].size()
+                 && ( i == 0 || c.packed_[i - 1].player_[p].attr_ != packed.attr_ ) )
+            {
+                c.attrs_[p].pop_back();
+            }
+        }
+
+        if ( ! encodePlayer( c, i, p, player, prev_counts[p], packed ) )
+        {
+            std::memset( &packed, 0, sizeof( packed ) );
+            packed.attr_ = static_cast< UInt16 >( c.attrs_[p].empty() ? 0 : c.attrs_[p].size() - 1 );
+            packed.counts_[COMMAND_COUNT / 4] = FLAG_RAW;
+
+            RawPlayer raw;
+            raw.key_ = first_key + p;
+            raw.player_ = player;
+            c.raw_players_.push_back( raw );
+        }
+
+        if ( i % KEY_INTERVAL == 0 )
+        {
+            get_counts( player, c.keys_[( i / KEY_INTERVAL ) * MAX_PLAYER*2 + p].count_ );
+        }
+    }
+
+    if ( ! replace )
+    {
+        std::memcpy( M_last_counts[0], M_last_counts[1], sizeof( M_last_counts[0] ) );
+    }
+
+    for ( int p = 0; p < MAX_PLAYER*2; ++p )
+    {
+        get_counts( disp.show_.player_[p], M_last_counts[1][p].count_ );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+FrameStore::encodePlayer( Chunk & c,
+                          const std::size_t i,
+                          const int p,
+                          const PlayerT & player,
+                          const CommandCounts & prev_counts,
+                          PackedPlayer & packed )
+{
+    if ( ! pack32( player.stamina_, 1000.0, packed.stamina_ )
+         || ! pack32( player.stamina_capacity_, 1000.0, packed.stamina_capacity_ )
+         || ! pack16( player.vx_, 10000.0, packed.vx_ )
+         || ! pack16( player.vy_, 10000.0, packed.vy_ )
+         || ! pack16( player.body_, 100.0, packed.body_ )
+         || ! pack16( player.neck_, 100.0, packed.neck_ ) )
+    {
+        return false;
+    }
+
+    std::memset( packed.counts_, 0, sizeof( packed.counts_ ) );
+    if ( i % KEY_INTERVAL != 0 )
+    {
+        UInt16 counts[COMMAND_COUNT];
+        get_counts( player, counts );
+
+        for ( int k = 0; k < COMMAND_COUNT; ++k )
+        {
+            const int diff = counts[k] - prev_counts.count_[k];
+            if ( diff < 0 || 3 < diff )
+            {
+                // store the absolute values instead of the differences
+                std::memset( packed.counts_, 0, sizeof( packed.counts_ ) );
+                packed.counts_[COMMAND_COUNT / 4] = FLAG_COUNTS;
+
+                RawCounts raw;
+                raw.key_ = static_cast< UInt32 >( i * MAX_PLAYER*2 + p );
+                std::copy( counts, counts + COMMAND_COUNT, raw.counts_.count_ );
+                c.raw_counts_.push_back( raw );
+                break;
+            }
+            packed.counts_[k / 4] |= static_cast< unsigned char >( diff << ( ( k % 4 ) * 2 ) );
+        }
+    }
+
+    const Int32 upper_state = player.state_ & ~STATE_LOWER_MASK;
+    packed.state_ = static_cast< UInt16 >( player.state_ & STATE_LOWER_MASK );
+
+    std::vector< PlayerAttr > & attrs = c.attrs_[p];
+    if ( attrs.empty()
+         || attrs.back().side_ != player.side_
+         || attrs.back().view_quality_ != player.view_quality_
+         || attrs.back().focus_side_ != player.focus_side_
+         || attrs.back().unum_ != player.unum_
+         || attrs.back().type_ != player.type_
+         || attrs.back().focus_unum_ != player.focus_unum_
+         || attrs.back().state_ != upper_state
+         || attrs.back().view_width_ != player.view_width_
+         || attrs.back().point_x_ != player.point_x_
+         || attrs.back().point_y_ != player.point_y_
+         || attrs.back().effort_ != player.effort_
+         || attrs.back().recovery_ != player.recovery_ )
+    {
+        PlayerAttr attr;
+        attr.side_ = player.side_;
+        attr.view_quality_ = player.view_quality_;
+        attr.focus_side_ = player.focus_side_;
+        attr.unum_ = player.unum_;
+        attr.type_ = player.type_;
+        attr.focus_unum_ = player.focus_unum_;
+        attr.state_ = upper_state;
+        attr.view_width_ = player.view_width_;
+        attr.point_x_ = player.point_x_;
+        attr.point_y_ = player.point_y_;
+        attr.effort_ = player.effort_;
+        attr.recovery_ = player.recovery_;
+        attrs.push_back( attr );
+    }
+    packed.attr_ = static_cast< UInt16 >( attrs.size() - 1 );
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::decode( const std::size_t idx,
+                    DispInfoT & disp ) const
+{
+    if ( ! M_compact )
+    {
+        disp = this->disp( idx );
+        return;
+    }
+
+    const Chunk & c = chunk( idx );
+    const std::size_t i = idx % CHUNK_SIZE;
+    const PackedFrame & frame = c.packed_[i];
+
+    disp.pmode_ = static_cast< PlayMode >( c.pmode_[i] );
+    disp.team_[0] = c.teams_[frame.team_].team_[0];
+    disp.team_[1] = c.teams_[frame.team_].team_[1];
+
+    disp.show_.time_ = c.time_[i];
+    disp.show_.ball_.x_ = c.ball_x_[i];
+    disp.show_.ball_.y_ = c.ball_y_[i];
+    disp.show_.ball_.vx_ = c.ball_vx_[i];
+    disp.show_.ball_.vy_ = c.ball_vy_[i];
+
+    for ( int p = 0; p < MAX_PLAYER*2; ++p )
+    {
+        decodePlayer( c, i, p, disp.show_.player_[p] );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::decodePlayer( const Chunk & c,
+                          const std::size_t i,
+                          const int p,
+                          PlayerT & player ) const
+{
+    const PackedPlayer & packed = c.packed_[i].player_[p];
+
+    if ( packed.counts_[COMMAND_COUNT / 4] & FLAG_RAW )
+    {
+        player = find_raw( c.raw_players_, static_cast< UInt32 >( i * MAX_PLAYER*2 + p ) ).player_;
+        return;
+    }
+
+    const PlayerAttr & attr = c.attrs_[p][packed.attr_];
+    player.side_ = attr.side_;
+    player.unum_ = attr.unum_;
+    player.type_ = attr.type_;
+    player.view_quality_ = attr.view_quality_;
+    player.focus_side_ = attr.focus_side_;
+    player.focus_unum_ = attr.focus_unum_;
+    player.state_ = attr.state_ | packed.state_;
+
+    player.x_ = c.player_x_[p][i];
+    player.y_ = c.player_y_[p][i];
+    player.vx_ = unpack16( packed.vx_, 10000.0 );
+    player.vy_ = unpack16( packed.vy_, 10000.0 );
+    player.body_ = unpack16( packed.body_, 100.0 );
+    player.neck_ = unpack16( packed.neck_, 100.0 );
+    player.point_x_ = attr.point_x_;
+    player.point_y_ = attr.point_y_;
+    player.view_width_ = attr.view_width_;
+
+    player.stamina_ = unpack32( packed.stamina_, 1000.0 );
+    player.effort_ = attr.effort_;
+    player.recovery_ = attr.recovery_;
+    player.stamina_capacity_ = unpack32( packed.stamina_capacity_, 1000.0 );
+
+    //
+    // add the differences to the counts of the nearest key frame or raw data
+    //
+
+    // the differences are summed in 8 bit lanes. [0-3], [4-7] and [8-10]
+    UInt32 diff[3] = { 0, 0, 0 };
+
+    UInt16 counts[COMMAND_COUNT];
+    std::size_t k = i;
+    while ( true )
+    {
+        const PackedPlayer & prev = c.packed_[k].player_[p];
+        if ( k % KEY_INTERVAL == 0 )
+        {
+            const UInt16 * key = c.keys_[( k / KEY_INTERVAL ) * MAX_PLAYER*2 + p].count_;
+            std::copy( key, key + COMMAND_COUNT, counts );
+            break;
+        }
+
+        if ( prev.counts_[COMMAND_COUNT / 4] & FLAG_RAW )
+        {
+            get_counts( find_raw( c.raw_players_, static_cast< UInt32 >( k * MAX_PLAYER*2 + p ) ).player_,
+                        counts );
+            break;
+        }
+
+        if ( prev.counts_[COMMAND_COUNT / 4] & FLAG_COUNTS )
+        {
+            const UInt16 * raw = find_raw( c.raw_counts_, static_cast< UInt32 >( k * MAX_PLAYER*2 + p ) ).counts_.count_;
+            std::copy( raw, raw + COMMAND_COUNT, counts );
+            break;
+        }
+
+        diff[0] += spread_diffs( prev.counts_[0] );
+        diff[1] += spread_diffs( prev.counts_[1] );
+        diff[2] += spread_diffs( static_cast< unsigned char >( prev.counts_[2] & ~( FLAG_RAW | FLAG_COUNTS ) ) );
+        --k;
+    }
+
+    for ( int n = 0; n < COMMAND_COUNT; ++n )
+    {
+        counts[n] = static_cast< UInt16 >( counts[n] + ( ( diff[n / 4] >> ( ( n % 4 ) * 8 ) ) & 0xff ) );
+    }
+    set_counts( counts, player );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+boost::shared_ptr< const DispInfoT >
+FrameStore::decodePtr( const std::size_t idx ) const
+{
+    for ( std::size_t n = 0; n < DECODE_CACHE_SIZE; ++n )
+    {
+        if ( M_decoded[n].disp_
+             && M_decoded[n].index_ == idx )
+        {
+            return M_decoded[n].disp_;
+        }
+    }
+
+    Decoded & entry = M_decoded[M_decoded_next];
+    M_decoded_next = ( M_decoded_next + 1 ) % DECODE_CACHE_SIZE;
+
+    // reuse the memory if nobody else refers the old data.
+    if ( ! entry.disp_
+         || ! entry.disp_.unique() )
+    {
+        entry.disp_.reset( new DispInfoT );
+    }
+
+    entry.index_ = idx;
+    decode( idx, *entry.disp_ );
+    return entry.disp_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+FrameStore::clearDecoded() const
+{
+    for ( std::size_t n = 0; n < DECODE_CACHE_SIZE; ++n )
+    {
+        M_decoded[n].disp_.reset();
+    }
+    M_decoded_next = 0;
+}
+
+}
+}
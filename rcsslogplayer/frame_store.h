@@ -0,0 +1,503 @@
+// -*-c++-*-
+
+/*!
+  \file frame_store.h
+  \brief columnar display data container Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_FRAME_STORE_H
+#define RCSSLOGPLAYER_FRAME_STORE_H
+
+#include <rcsslogplayer/types.h>
+#include <rcsslogplayer/time_index.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+#include <cstddef>
+
+namespace rcss {
+namespace rcg {
+
+/*!
+  \class FrameStore
+  \brief arena of the display data with the columns of the frequently used fields.
+
+  Frames are stored in the chunks of CHUNK_SIZE frames. Each chunk is allocated at once,
+  so appending the frame does not allocate the memory, and the frames are never moved
+  when the store grows. There is no limit of the number of frames.
+
+  In each chunk, the show time, the playmode and the positions of the ball and the players
+  have their own arrays indexed by the frame, so the history of one field (e.g. the player
+  position for the trace) is read from the contiguous memory. The whole display data are
+  also kept in the chunk, because splitting every field makes appending one frame touch
+  hundreds of arrays.
+
+  In the compact mode, the display data are encoded instead of being kept as they are.
+  The columns above are not changed, and other player data are stored as follows:
+  - velocity: int16 fixed-point (1e-4)
+  - body and neck angle: int16 fixed-point (1e-2 degree)
+  - stamina and stamina capacity: int32 fixed-point (1e-3)
+  - state: lower 16 bits. (e.g. kicking, tackling and collision)
+  - side, uniform number, type, upper bits of state, view, focus, pointing, effort and
+    recovery: the record in the chunk is shared while these values are not changed.
+  - command counts: 2 bit difference from the previous frame. the absolute values are
+    recorded every KEY_INTERVAL frames, and when the difference is out of [0, 3].
+  The sentinel values (e.g. no velocity) are kept exactly. If any other value cannot be
+  encoded, the player data of that frame are stored as they are.
+  The team info is shared while it is not changed.
+  The encoded frame is decoded when requested by ptr(), disp() or decode().
+  The last DECODE_CACHE_SIZE decoded frames are cached, so the const methods of
+  the compact store must not be called from several threads at once.
+
+  The memory reduction depends on the log. If the player attributes or the command
+  counts change at random in every frame, the compact store is not smaller.
+
+  In the column only mode, only the columns above are kept. This mode is used when
+  the display data are decoded from somewhere else on demand (e.g. the mapped log file).
+*/
+class FrameStore {
+public:
+
+    //! the number of frames in one chunk. this value must be the power of 2.
+    static const std::size_t CHUNK_SIZE = 1024;
+    //! interval of the frames that have the absolute command counts in the compact mode.
+    //! this value must divide CHUNK_SIZE, and must be less than 86 to sum the differences in 8 bits.
+    static const std::size_t KEY_INTERVAL = 32;
+    //! the number of decoded frames cached in the compact mode.
+    static const std::size_t DECODE_CACHE_SIZE = 4;
+
+    /*!
+      \class View
+      \brief non-owning reference to one frame in the store.
+
+      The view is valid while the store is not cleared.
+     */
+    class View {
+    private:
+        const FrameStore * M_store;
+        std::size_t M_index;
+
+    public:
+        View( const FrameStore & store,
+              const std::size_t index )
+            : M_store( &store ),
+              M_index( index )
+          { }
+
+        std::size_t index() const
+          {
+              return M_index;
+          }
+
+        UInt32 time() const
+          {
+              return M_store->time( M_index );
+          }
+
+        PlayMode pmode() const
+          {
+              return M_store->pmode( M_index );
+          }
+
+        /*!
+          \brief get the display data. see FrameStore::disp().
+          \return const reference to the display data
+         */
+        const DispInfoT & disp() const
+          {
+              return M_store->disp( M_index );
+          }
+    };
+
+private:
+
+    //! the number of command counters of the player
+    static const int COMMAND_COUNT = 11;
+
+    /*!
+      \struct PlayerAttr
+      \brief rarely changed player data in the compact mode
+     */
+    struct PlayerAttr {
+        char side_;
+        char view_quality_;
+        char focus_side_;
+        Int16 unum_;
+        Int16 type_;
+        Int16 focus_unum_;
+        Int32 state_; //!< upper bits of the state
+        float view_width_;
+        float point_x_;
+        float point_y_;
+        float effort_;
+        float recovery_;
+    };
+
+    /*!
+      \struct PackedPlayer
+      \brief encoded player data in the compact mode
+     */
+    struct PackedPlayer {
+        Int32 stamina_; //!< 1e-3
+        Int32 stamina_capacity_; //!< 1e-3
+        Int16 vx_; //!< 1e-4
+        Int16 vy_; //!< 1e-4
+        Int16 body_; //!< 1e-2 degree
+        Int16 neck_; //!< 1e-2 degree
+        UInt16 attr_; //!< index of Chunk::attrs_
+        UInt16 state_; //!< lower 16 bits of the state
+        //! 2 bit differences of the command counts. the last 2 bits are the flags.
+        unsigned char counts_[( COMMAND_COUNT + 1 ) / 4];
+    };
+
+    /*!
+      \struct PackedFrame
+      \brief encoded display data in the compact mode
+     */
+    struct PackedFrame {
+        PackedPlayer player_[MAX_PLAYER*2];
+        UInt16 team_; //!< index of Chunk::teams_
+    };
+
+    /*!
+      \struct TeamPair
+      \brief team info of both sides
+     */
+    struct TeamPair {
+        TeamT team_[2];
+    };
+
+    /*!
+      \struct CommandCounts
+      \brief absolute command counts of one player
+     */
+    struct CommandCounts {
+        UInt16 count_[COMMAND_COUNT];
+    };
+
+    /*!
+      \struct RawCounts
+      \brief absolute command counts that cannot be encoded as the difference
+     */
+    struct RawCounts {
+        UInt32 key_; //!< frame * MAX_PLAYER*2 + player
+        CommandCounts counts_;
+    };
+
+    /*!
+      \struct RawPlayer
+      \brief player data that cannot be encoded
+     */
+    struct RawPlayer {
+        UInt32 key_; //!< frame * MAX_PLAYER*2 + player
+        PlayerT player_;
+    };
+
+    /*!
+      \struct Decoded
+      \brief cached decoded frame in the compact mode
+     */
+    struct Decoded {
+        std::size_t index_; //!< frame index
+        boost::shared_ptr< DispInfoT > disp_; //!< decoded data. NULL if not used.
+    };
+
+    /*!
+      \struct Chunk
+      \brief memory block of CHUNK_SIZE frames
+     */
+    struct Chunk {
+        UInt32 time_[CHUNK_SIZE]; //!< show time of each frame
+        unsigned char pmode_[CHUNK_SIZE]; //!< playmode of each frame
+        float ball_x_[CHUNK_SIZE]; //!< ball position x of each frame
+        float ball_y_[CHUNK_SIZE]; //!< ball position y of each frame
+        float player_x_[MAX_PLAYER*2][CHUNK_SIZE]; //!< player position x. [player][frame]
+        float player_y_[MAX_PLAYER*2][CHUNK_SIZE]; //!< player position y. [player][frame]
+        //! display data of each frame. empty in the compact mode and in the column only mode.
+        std::vector< DispInfoT > disp_;
+
+        //
+        // the compact mode
+        //
+        float ball_vx_[CHUNK_SIZE]; //!< ball velocity x of each frame
+        float ball_vy_[CHUNK_SIZE]; //!< ball velocity y of each frame
+        std::vector< PackedFrame > packed_; //!< encoded data of each frame
+        std::vector< TeamPair > teams_; //!< team info history
+        std::vector< PlayerAttr > attrs_[MAX_PLAYER*2]; //!< player attribute history
+        //! command counts of the key frames. [key * MAX_PLAYER*2 + player]
+        std::vector< CommandCounts > keys_;
+        //! command counts that cannot be encoded. sorted by the key.
+        std::vector< RawCounts > raw_counts_;
+        //! player data that cannot be encoded. sorted by the key.
+        std::vector< RawPlayer > raw_players_;
+    };
+
+    typedef boost::shared_ptr< Chunk > ChunkPtr;
+
+    bool M_compact; //!< if true, the display data are encoded.
+    bool M_columns_only; //!< if true, the display data are not kept.
+    std::size_t M_size; //!< the number of frames
+    std::vector< ChunkPtr > M_chunks;
+
+    //! the first frame of each show time
+    TimeIndex M_time_index;
+
+    //! command counts of the last two frames used to encode the difference. compact mode only.
+    CommandCounts M_last_counts[2][MAX_PLAYER*2];
+
+    //! recently decoded frames. compact mode only.
+    mutable Decoded M_decoded[DECODE_CACHE_SIZE];
+    //! the cache entry replaced at the next miss
+    mutable std::size_t M_decoded_next;
+
+    // not used
+    FrameStore( const FrameStore & );
+    FrameStore & operator=( const FrameStore & );
+
+public:
+
+    /*!
+      \brief create the empty store.
+      \param compact if true, the display data are stored in the compact encoding.
+     */
+    explicit
+    FrameStore( const bool compact = false );
+
+    /*!
+      \brief change the storage mode. the stored frames are encoded again.
+      \param on if true, the display data are stored in the compact encoding.
+     */
+    void setCompact( const bool on );
+
+    bool isCompact() const
+      {
+          return M_compact;
+      }
+
+    /*!
+      \brief change the column only mode. the stored frames are removed.
+      \param on if true, only the columns are kept, and the display data are dropped.
+
+      In the column only mode, ptr(), disp() and decode() must not be called.
+      The compact mode has no effect.
+     */
+    void setColumnsOnly( const bool on );
+
+    bool isColumnsOnly() const
+      {
+          return M_columns_only;
+      }
+
+    /*!
+      \brief remove all frames and release the chunks.
+
+      The chunks referred by the pointers from ptr() are released when the
+      last pointer is destroyed.
+     */
+    void clear();
+
+    std::size_t size() const
+      {
+          return M_size;
+      }
+
+    bool empty() const
+      {
+          return M_size == 0;
+      }
+
+    /*!
+      \brief append the frame
+      \param disp new display data
+     */
+    void push_back( const DispInfoT & disp );
+
+    /*!
+      \brief replace the last frame. the store must not be empty.
+      \param disp new display data
+
+      The last frame is overwritten in place. In the normal mode, the data seen
+      through the pointers already returned by ptr() for this frame are also changed.
+     */
+    void setBack( const DispInfoT & disp );
+
+    /*!
+      \brief get the non-owning reference to the frame
+      \param idx frame index
+      \return view object
+     */
+    View view( const std::size_t idx ) const
+      {
+          return View( *this, idx );
+      }
+
+    /*!
+      \brief get the pointer to the frame
+      \param idx frame index
+      \return pointer that shares the ownership of the chunk. no memory is allocated.
+
+      The pointer refers to the frame in the store, not to its copy. If the frame
+      is replaced by setBack(), the pointer shows the new data.
+      In the compact mode, the pointer to the decoded copy is returned. The copy is
+      cached, and it is not changed by setBack().
+     */
+    boost::shared_ptr< const DispInfoT > ptr( const std::size_t idx ) const
+      {
+          if ( M_compact )
+          {
+              return decodePtr( idx );
+          }
+
+          const ChunkPtr & c = M_chunks[idx / CHUNK_SIZE];
+          return boost::shared_ptr< const DispInfoT >( c, &c->disp_[idx % CHUNK_SIZE] );
+      }
+
+    /*!
+      \brief get the reference to the frame.
+      \param idx frame index
+      \return const reference to the display data
+
+      In the compact mode, the reference refers to the decoded cache, and it is
+      valid until DECODE_CACHE_SIZE other frames are decoded. Use ptr() to keep it.
+     */
+    const DispInfoT & disp( const std::size_t idx ) const
+      {
+          if ( M_compact )
+          {
+              return *decodePtr( idx );
+          }
+
+          return chunk( idx ).disp_[idx % CHUNK_SIZE];
+      }
+
+    /*!
+      \brief copy the frame. the encoded data are decoded in the compact mode.
+      \param idx frame index
+      \param disp reference to the result variable
+     */
+    void decode( const std::size_t idx,
+                 DispInfoT & disp ) const;
+
+    UInt32 time( const std::size_t idx ) const
+      {
+          return chunk( idx ).time_[idx % CHUNK_SIZE];
+      }
+
+    PlayMode pmode( const std::size_t idx ) const
+      {
+          return static_cast< PlayMode >( chunk( idx ).pmode_[idx % CHUNK_SIZE] );
+      }
+
+    /*!
+      \brief find the first frame whose time is not less than the given time.
+      \param time show time
+      \return frame index. size() if not found.
+
+      The show time must be monotonic. The frames of the same time are consecutive,
+      and the returned frame is the first sub-cycle of them.
+      This lookup is O(1) unless the time index is given up.
+     */
+    std::size_t lowerBound( const UInt32 time ) const
+      {
+          return ( M_time_index.isValid()
+                   ? M_time_index.lowerBound( time )
+                   : bisect( time ) );
+      }
+
+    //
+    // column access
+    //
+
+    float ballX( const std::size_t idx ) const
+      {
+          return chunk( idx ).ball_x_[idx % CHUNK_SIZE];
+      }
+
+    float ballY( const std::size_t idx ) const
+      {
+          return chunk( idx ).ball_y_[idx % CHUNK_SIZE];
+      }
+
+    /*!
+      \brief get the x coordinate of the player
+      \param idx frame index
+      \param player_index player index. [0, MAX_PLAYER) for left, [MAX_PLAYER, MAX_PLAYER*2) for right.
+      \return x coordinate
+     */
+    float playerX( const std::size_t idx,
+                   const std::size_t player_index ) const
+      {
+          return chunk( idx ).player_x_[player_index][idx % CHUNK_SIZE];
+      }
+
+    /*!
+      \brief get the y coordinate of the player
+      \param idx frame index
+      \param player_index player index. [0, MAX_PLAYER) for left, [MAX_PLAYER, MAX_PLAYER*2) for right.
+      \return y coordinate
+     */
+    float playerY( const std::size_t idx,
+                   const std::size_t player_index ) const
+      {
+          return chunk( idx ).player_y_[player_index][idx % CHUNK_SIZE];
+      }
+
+private:
+
+    const Chunk & chunk( const std::size_t idx ) const
+      {
+          return *M_chunks[idx / CHUNK_SIZE];
+      }
+
+    void set( const std::size_t idx,
+              const DispInfoT & disp );
+
+    std::size_t bisect( const UInt32 time ) const;
+
+    void encode( const std::size_t idx,
+                 const DispInfoT & disp );
+    bool encodePlayer( Chunk & c,
+                       const std::size_t i,
+                       const int p,
+                       const PlayerT & player,
+                       const CommandCounts & prev_counts,
+                       PackedPlayer & packed );
+    void decodePlayer( const Chunk & c,
+                       const std::size_t i,
+                       const int p,
+                       PlayerT & player ) const;
+
+    boost::shared_ptr< const DispInfoT > decodePtr( const std::size_t idx ) const;
+    void clearDecoded() const;
+};
+
+}
+}
+
+#endif
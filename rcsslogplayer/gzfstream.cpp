@@ -36,15 +36,34 @@
 
 #include "gzfstream.h"
 
+#include "gzindex.h"
+
+#include <vector>
 #include <string>
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 #ifdef HAVE_LIBZ
 #include <zlib.h>
 #endif
 
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
+
 namespace rcss {
 
+namespace {
+
+//! the size of the block inflated by the read-ahead thread
+const std::size_t READ_AHEAD_BLOCK_SIZE = 256 * 1024;
+
+//! the number of the read-ahead blocks
+const std::size_t READ_AHEAD_BLOCKS = 4;
+
+}
+
 /////////////////////////////////////////////////////////////////////
 
 //! the implementation of file stream buffer
@@ -56,6 +75,52 @@ struct gzfilebuf_impl {
 #ifdef HAVE_LIBZ
     //! gzip file
     gzFile file_;
+
+    //! opened file path
+    std::string path_;
+    //! access point index
+    boost::shared_ptr< const GzipIndex > index_;
+
+    //! the file read directly after seeking by the index.
+    std::FILE * raw_file_;
+    //! inflate stream restarted from the access point.
+    z_stream raw_strm_;
+    //! true if raw_strm_ is initialized.
+    bool raw_active_;
+    //! true if raw_strm_ inflates the gzip wrapper. false if started in the middle of the member.
+    bool raw_wrapped_;
+    //! true if raw_file_ reaches the end of the data.
+    bool raw_eof_;
+    //! offset in the uncompressed data of the next output
+    boost::uint64_t raw_pos_;
+    //! input buffer
+    std::vector< unsigned char > raw_in_;
+#endif
+
+    //! true if the read-ahead mode is requested.
+    bool read_ahead_;
+
+#if defined(HAVE_LIBZ) && defined(HAVE_LIBPTHREAD)
+    //! read-ahead blocks used as the ring buffer.
+    std::vector< std::vector< char > > ahead_blocks_;
+    //! data size in each block. 0 or less means the end of data.
+    std::vector< int > ahead_sizes_;
+    //! index of the block consumed next.
+    std::size_t ahead_head_;
+    //! the number of the filled blocks, including the held block.
+    std::size_t ahead_count_;
+    //! true if the head block is used as the get area.
+    bool ahead_held_;
+    //! stop request for the read-ahead thread.
+    bool ahead_stop_;
+    //! true if the read-ahead thread is running.
+    bool ahead_running_;
+    //! offset in the uncompressed data of the end of the get area.
+    boost::uint64_t ahead_pos_;
+
+    pthread_t ahead_thread_;
+    pthread_mutex_t ahead_mutex_;
+    pthread_cond_t ahead_cond_;
 #endif
 
     //! constructor
@@ -63,8 +128,431 @@ struct gzfilebuf_impl {
         : open_mode_( static_cast< std::ios_base::openmode >( 0 ) )
 #ifdef HAVE_LIBZ
         , file_( NULL )
+        , raw_file_( NULL )
+        , raw_active_( false )
+        , raw_wrapped_( false )
+        , raw_eof_( false )
+        , raw_pos_( 0 )
+#endif
+        , read_ahead_( false )
+#if defined(HAVE_LIBZ) && defined(HAVE_LIBPTHREAD)
+        , ahead_head_( 0 )
+        , ahead_count_( 0 )
+        , ahead_held_( false )
+        , ahead_stop_( false )
+        , ahead_running_( false )
+        , ahead_pos_( 0 )
+#endif
+      {
+#if defined(HAVE_LIBZ) && defined(HAVE_LIBPTHREAD)
+          pthread_mutex_init( &ahead_mutex_, 0 );
+          pthread_cond_init( &ahead_cond_, 0 );
+#endif
+      }
+
+#ifdef HAVE_LIBZ
+    //! destructor
+    ~gzfilebuf_impl()
+      {
+#ifdef HAVE_LIBPTHREAD
+          stopReadAhead();
+          pthread_cond_destroy( &ahead_cond_ );
+          pthread_mutex_destroy( &ahead_mutex_ );
+#endif
+          closeRaw();
+      }
+
+    /*!
+      \brief get the offset in the uncompressed data of the next read.
+     */
+    boost::uint64_t tell()
+      {
+#ifdef HAVE_LIBPTHREAD
+          if ( ahead_running_ )
+          {
+              return ahead_pos_;
+          }
+#endif
+          if ( raw_active_ )
+          {
+              return raw_pos_;
+          }
+
+          z_off_t pos = gztell( file_ );
+          return ( pos < 0 ? 0 : static_cast< boost::uint64_t >( pos ) );
+      }
+
+    /*!
+      \brief read the uncompressed data.
+     */
+    int read( char * buf,
+              const int len )
+      {
+          if ( raw_active_ )
+          {
+              return readRaw( buf, len );
+          }
+
+          return gzread( file_, buf, len );
+      }
+
+    void closeRaw()
+      {
+          if ( raw_active_ )
+          {
+              inflateEnd( &raw_strm_ );
+              raw_active_ = false;
+          }
+
+          if ( raw_file_ )
+          {
+              std::fclose( raw_file_ );
+              raw_file_ = NULL;
+          }
+      }
+
+    /*!
+      \brief fill the input buffer if empty.
+      \return false if no more input.
+     */
+    bool fillRaw()
+      {
+          if ( raw_strm_.avail_in == 0 )
+          {
+              raw_strm_.avail_in = static_cast< uInt >( std::fread( &raw_in_[0], 1, raw_in_.size(), raw_file_ ) );
+              raw_strm_.next_in = &raw_in_[0];
+          }
+
+          return raw_strm_.avail_in > 0;
+      }
+
+    /*!
+      \brief restart inflating from the access point before pos, and skip to pos.
+      \return true if successfully restarted.
+
+      If pos is out of the index, the read position is not changed. If the restart
+      fails on the way, the read position is reset to the beginning of the data.
+     */
+    bool seekRaw( const boost::uint64_t pos )
+      {
+          const GzipIndex::Point * p = index_->findPoint( pos );
+          if ( ! p
+               || index_->dataSize() < pos )
+          {
+              return false;
+          }
+
+          if ( restartRaw( *p, pos ) )
+          {
+              return true;
+          }
+
+          // the previous stream state has been already discarded.
+          closeRaw();
+          gzrewind( file_ );
+          return false;
+      }
+
+    /*!
+      \brief restart inflating from the access point, and skip to pos.
+      \return true if successfully restarted.
+     */
+    bool restartRaw( const GzipIndex::Point & p,
+                     const boost::uint64_t pos )
+      {
+          if ( raw_active_ )
+          {
+              inflateEnd( &raw_strm_ );
+              raw_active_ = false;
+          }
+
+          if ( ! raw_file_ )
+          {
+              raw_file_ = std::fopen( path_.c_str(), "rb" );
+              if ( ! raw_file_ )
+              {
+                  return false;
+              }
+              raw_in_.resize( 16384 );
+          }
+
+          const long in = static_cast< long >( p.in_ ) - ( p.bits_ > 0 ? 1 : 0 );
+          if ( std::fseek( raw_file_, in, SEEK_SET ) != 0 )
+          {
+              return false;
+          }
+
+          std::memset( &raw_strm_, 0, sizeof( raw_strm_ ) );
+
+          if ( p.bits_ < 0 )
+          {
+              // the head of the gzip member
+              if ( inflateInit2( &raw_strm_, 15 + 32 ) != Z_OK )
+              {
+                  return false;
+              }
+              raw_wrapped_ = true;
+          }
+          else
+          {
+              // raw deflate data in the middle of the member
+              if ( inflateInit2( &raw_strm_, -15 ) != Z_OK )
+              {
+                  return false;
+              }
+              raw_active_ = true;
+              raw_wrapped_ = false;
+
+              if ( p.bits_ > 0 )
+              {
+                  const int c = std::getc( raw_file_ );
+                  if ( c == EOF
+                       || inflatePrime( &raw_strm_, p.bits_, c >> ( 8 - p.bits_ ) ) != Z_OK )
+                  {
+                      return false;
+                  }
+              }
+
+              if ( inflateSetDictionary( &raw_strm_,
+                                         &p.window_[0],
+                                         static_cast< uInt >( p.window_.size() ) ) != Z_OK )
+              {
+                  return false;
+              }
+          }
+
+          raw_active_ = true;
+          raw_eof_ = false;
+          raw_pos_ = p.out_;
+
+          char discard[GzipIndex::WINDOW_SIZE];
+          while ( raw_pos_ < pos )
+          {
+              const int n = readRaw( discard,
+                                     static_cast< int >( std::min( pos - raw_pos_,
+                                                                   static_cast< boost::uint64_t >( sizeof( discard ) ) ) ) );
+              if ( n <= 0 )
+              {
+                  return false;
+              }
+          }
+
+          return true;
+      }
+
+    /*!
+      \brief read the uncompressed data from the restarted stream.
+      \return the number of bytes read.
+     */
+    int readRaw( char * buf,
+                 const int len )
+      {
+          if ( raw_eof_ )
+          {
+              return 0;
+          }
+
+          raw_strm_.next_out = reinterpret_cast< Bytef * >( buf );
+          raw_strm_.avail_out = static_cast< uInt >( len );
+
+          while ( raw_strm_.avail_out > 0 )
+          {
+              if ( ! fillRaw() )
+              {
+                  raw_eof_ = true;
+                  break;
+              }
+
+              const int ret = inflate( &raw_strm_, Z_NO_FLUSH );
+
+              if ( ret == Z_STREAM_END )
+              {
+                  if ( ! raw_wrapped_ )
+                  {
+                      // skip the gzip trailer (CRC32 and ISIZE)
+                      int skip = 8;
+                      while ( skip > 0
+                              && fillRaw() )
+                      {
+                          const int n = std::min( skip, static_cast< int >( raw_strm_.avail_in ) );
+                          raw_strm_.next_in += n;
+                          raw_strm_.avail_in -= n;
+                          skip -= n;
+                      }
+                  }
+
+                  // restart for the next member
+                  z_stream strm = raw_strm_;
+                  inflateEnd( &raw_strm_ );
+                  std::memset( &raw_strm_, 0, sizeof( raw_strm_ ) );
+                  raw_strm_.next_in = strm.next_in;
+                  raw_strm_.avail_in = strm.avail_in;
+                  raw_strm_.next_out = strm.next_out;
+                  raw_strm_.avail_out = strm.avail_out;
+                  if ( inflateInit2( &raw_strm_, 15 + 32 ) != Z_OK )
+                  {
+                      raw_eof_ = true;
+                      break;
+                  }
+                  raw_wrapped_ = true;
+                  continue;
+              }
+
+              if ( ret != Z_OK
+                   && ret != Z_BUF_ERROR )
+              {
+                  // trailing garbage after the last member is ignored in the same way as gzread().
+                  raw_eof_ = true;
+                  break;
+              }
+          }
+
+          const int n = len - static_cast< int >( raw_strm_.avail_out );
+          raw_pos_ += n;
+          return n;
+      }
+
+#ifdef HAVE_LIBPTHREAD
+    /*!
+      \brief start the read-ahead thread from the current position.
+      \return true if the thread is started.
+     */
+    bool startReadAhead()
+      {
+          if ( ahead_running_ )
+          {
+              return true;
+          }
+
+          if ( ahead_blocks_.empty() )
+          {
+              ahead_blocks_.resize( READ_AHEAD_BLOCKS, std::vector< char >( READ_AHEAD_BLOCK_SIZE ) );
+              ahead_sizes_.resize( READ_AHEAD_BLOCKS, 0 );
+          }
+
+          ahead_pos_ = tell();
+          ahead_head_ = 0;
+          ahead_count_ = 0;
+          ahead_held_ = false;
+          ahead_stop_ = false;
+
+          if ( pthread_create( &ahead_thread_, 0, &gzfilebuf_impl::read_ahead_thread, this ) != 0 )
+          {
+              return false;
+          }
+
+          ahead_running_ = true;
+          return true;
+      }
+
+    /*!
+      \brief stop the read-ahead thread. the inflated blocks are discarded.
+     */
+    void stopReadAhead()
+      {
+          if ( ! ahead_running_ )
+          {
+              return;
+          }
+
+          pthread_mutex_lock( &ahead_mutex_ );
+          ahead_stop_ = true;
+          pthread_cond_broadcast( &ahead_cond_ );
+          pthread_mutex_unlock( &ahead_mutex_ );
+
+          pthread_join( ahead_thread_, 0 );
+
+          ahead_running_ = false;
+          ahead_head_ = 0;
+          ahead_count_ = 0;
+          ahead_held_ = false;
+      }
+
+    /*!
+      \brief release the held block and get the next inflated block.
+      \param block pointer to the variable that receives the head of the block.
+      \return data size of the block. 0 or less at the end of data.
+     */
+    int nextBlock( char ** block )
+      {
+          pthread_mutex_lock( &ahead_mutex_ );
+
+          if ( ahead_held_ )
+          {
+              ahead_head_ = ( ahead_head_ + 1 ) % READ_AHEAD_BLOCKS;
+              --ahead_count_;
+              ahead_held_ = false;
+              pthread_cond_broadcast( &ahead_cond_ );
+          }
+
+          while ( ahead_count_ == 0 )
+          {
+              pthread_cond_wait( &ahead_cond_, &ahead_mutex_ );
+          }
+
+          // the last block is never released, so that the end of data is kept.
+          const int size = ahead_sizes_[ahead_head_];
+          if ( size > 0 )
+          {
+              ahead_held_ = true;
+              ahead_pos_ += size;
+          }
+
+          pthread_mutex_unlock( &ahead_mutex_ );
+
+          *block = &ahead_blocks_[ahead_head_][0];
+          return size;
+      }
+
+    /*!
+      \brief the body of the read-ahead thread.
+     */
+    void runReadAhead()
+      {
+          while ( true )
+          {
+              pthread_mutex_lock( &ahead_mutex_ );
+              while ( ahead_count_ == READ_AHEAD_BLOCKS
+                      && ! ahead_stop_ )
+              {
+                  pthread_cond_wait( &ahead_cond_, &ahead_mutex_ );
+              }
+
+              if ( ahead_stop_ )
+              {
+                  pthread_mutex_unlock( &ahead_mutex_ );
+                  break;
+              }
+
+              const std::size_t tail = ( ahead_head_ + ahead_count_ ) % READ_AHEAD_BLOCKS;
+              pthread_mutex_unlock( &ahead_mutex_ );
+
+              // only this thread touches the input while running.
+              const int size = ( raw_active_
+                                 ? readRaw( &ahead_blocks_[tail][0], READ_AHEAD_BLOCK_SIZE )
+                                 : gzread( file_, &ahead_blocks_[tail][0], READ_AHEAD_BLOCK_SIZE ) );
+
+              pthread_mutex_lock( &ahead_mutex_ );
+              ahead_sizes_[tail] = size;
+              ++ahead_count_;
+              pthread_cond_broadcast( &ahead_cond_ );
+              pthread_mutex_unlock( &ahead_mutex_ );
+
+              if ( size <= 0 )
+              {
+                  break;
+              }
+          }
+      }
+
+    static
+    void * read_ahead_thread( void * arg )
+      {
+          static_cast< gzfilebuf_impl * >( arg )->runReadAhead();
+          return 0;
+      }
+#endif
 #endif
-      { }
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -158,6 +646,8 @@ gzfilebuf::open( const char * path,
             return ret;
         }
 
+        M_impl->path_ = path;
+
         if ( M_buf )
         {
             destroyInternalBuffer();
@@ -172,6 +662,12 @@ gzfilebuf::open( const char * path,
             M_remained_size = 0;
             this->setg( M_buf, M_buf, M_buf );
             M_impl->open_mode_ = std::ios_base::in;
+#ifdef HAVE_LIBPTHREAD
+            if ( M_impl->read_ahead_ )
+            {
+                M_impl->startReadAhead();
+            }
+#endif
         }
 
         if ( testo )
@@ -209,9 +705,16 @@ gzfilebuf::close() throw()
             return NULL;
         }
 
+#ifdef HAVE_LIBPTHREAD
+        M_impl->stopReadAhead();
+#endif
+
         // TODO: checking close status...
         gzclose( M_impl->file_ );
         M_impl->file_ = NULL;
+        M_impl->closeRaw();
+        M_impl->index_.reset();
+        M_impl->path_.clear();
         M_impl->open_mode_ = static_cast< std::ios_base::openmode >( 0 );
     }
 #endif
@@ -221,6 +724,38 @@ gzfilebuf::close() throw()
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+bool
+gzfilebuf::setIndex( boost::shared_ptr< const GzipIndex > index )
+{
+#ifdef HAVE_LIBZ
+    if ( this->is_open()
+         && ( M_impl->open_mode_ & std::ios_base::in )
+         && index
+         && index->isValidFor( M_impl->path_.c_str() ) )
+    {
+        M_impl->index_ = index;
+        return true;
+    }
+#else
+    (void)index;
+#endif
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+gzfilebuf::setReadAhead( const bool on )
+{
+    M_impl->read_ahead_ = on;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 bool
 gzfilebuf::flushBuf()
@@ -371,12 +906,6 @@ gzfilebuf::seekoff( std::streamoff off,
                     std::ios_base::seekdir way,
                     std::ios_base::openmode mode )
 {
-    if ( way & std::ios_base::end )
-    {
-        //! zlib does not support seeking from 'end'.
-        return -1;
-    }
-
     if ( ! is_open() )
     {
         return -1;
@@ -392,23 +921,38 @@ gzfilebuf::seekoff( std::streamoff off,
 #ifdef HAVE_LIBZ
     if ( M_impl->open_mode_ & std::ios_base::in )
     {
-        if ( way & std::ios_base::beg )
+        const std::streamoff cur = ( static_cast< std::streamoff >( M_impl->tell() )
+                                     - ( this->egptr() - this->gptr() ) );
+        if ( way == std::ios_base::cur )
         {
-            ret = gzseek( M_impl->file_, off, SEEK_SET );
-            M_remained_size = 0;
-            this->setg( M_buf, M_buf, M_buf );
+            if ( off == 0 )
+            {
+                // only tell the current position
+                return cur;
+            }
+
+            return seekpos( cur + off, std::ios_base::in );
         }
 
-        if ( way & std::ios_base::cur )
+        if ( way == std::ios_base::end )
         {
-            ret = gzseek( M_impl->file_, off, SEEK_CUR );
-            ret -= this->egptr() - this->gptr();
-            if ( off != 0 )
+            //! zlib does not support seeking from 'end' without the index.
+            if ( ! M_impl->index_ )
             {
-                M_remained_size = 0;
-                this->setg( M_buf, M_buf, M_buf );
+                return -1;
             }
+
+            return seekpos( static_cast< std::streamoff >( M_impl->index_->dataSize() ) + off,
+                            std::ios_base::in );
         }
+
+        return seekpos( off, std::ios_base::in );
+    }
+
+    if ( way & std::ios_base::end )
+    {
+        //! zlib does not support seeking from 'end'.
+        return -1;
     }
 
     if ( M_impl->open_mode_ & std::ios_base::out )
@@ -455,10 +999,35 @@ gzfilebuf::seekpos( std::streampos pos,
     if ( ( M_impl->open_mode_ & std::ios_base::in )
          && ( mode & std::ios_base::in ) )
     {
-        ret = gzseek( M_impl->file_, pos, SEEK_SET );
+#ifdef HAVE_LIBPTHREAD
+        // the inflated blocks are discarded, and the thread restarts from the new position.
+        const bool read_ahead = M_impl->ahead_running_;
+        M_impl->stopReadAhead();
+#endif
+
+        if ( M_impl->index_ )
+        {
+            // restart from the nearest access point
+            if ( pos >= 0
+                 && M_impl->seekRaw( static_cast< boost::uint64_t >( std::streamoff( pos ) ) ) )
+            {
+                ret = pos;
+            }
+        }
+        else
+        {
+            ret = gzseek( M_impl->file_, pos, SEEK_SET );
+        }
         // and reset buffer pointer to initial position
         M_remained_size = 0;
         this->setg( M_buf, M_buf, M_buf );
+
+#ifdef HAVE_LIBPTHREAD
+        if ( read_ahead )
+        {
+            M_impl->startReadAhead();
+        }
+#endif
     }
 
     if ( ( M_impl->open_mode_ & std::ios_base::out )
@@ -516,14 +1085,29 @@ gzfilebuf::underflow()
         return traits_type::eof();
     }
 
+#ifdef HAVE_LIBPTHREAD
+    if ( M_impl->ahead_running_ )
+    {
+        // the inflated block is directly used as the get area.
+        char_type * block = NULL;
+        const int size = M_impl->nextBlock( &block );
+        if ( size <= 0 )
+        {
+            return traits_type::eof();
+        }
+
+        this->setg( block, block, block + size );
+        return traits_type::to_int_type( *gptr() );
+    }
+#endif
+
     if ( M_remained_size )
     {
         M_buf[0] = M_remained_char;
     }
 
-    int read_size = gzread( M_impl->file_,
-                            ( void* )( M_buf + M_remained_size ),
-                            M_buf_size * sizeof( char_type ) - M_remained_size );
+    int read_size = M_impl->read( M_buf + M_remained_size,
+                                  M_buf_size * sizeof( char_type ) - M_remained_size );
     if ( read_size <= 0 )
     {
         return traits_type::eof();
@@ -37,9 +37,11 @@
 #include <string>
 
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace rcss {
 
+class GzipIndex;
 struct gzfilebuf_impl;
 
 /*!
@@ -47,9 +49,12 @@ struct gzfilebuf_impl;
   \brief gzip file stream buffer class.
 
   This class implements basic_filebuf for gzipped files.
-  It doesn't yet support seeking (allowed by zlib but slow/limited),
-  putback and read/write access(tricky). Otherwise, it attempts
-  to be a drop-in replacement for the standard file streambuf.
+  It doesn't yet support putback and read/write access(tricky).
+  Otherwise, it attempts to be a drop-in replacement for the standard file streambuf.
+
+  Seeking in the input mode is allowed by zlib but slow, because the file is
+  inflated again from the beginning. If the access point index is given by setIndex(),
+  the input is restarted from the nearest access point.
 */
 class gzfilebuf
     : public std::streambuf {
@@ -158,6 +163,26 @@ public:
     */
     gzfilebuf * close() throw();
 
+    /*!
+      \brief set the access point index used by seekoff() and seekpos().
+      \param index access point index built from the opened file.
+      \return true if the index is valid for the opened file.
+
+      The file has to be opened in the input mode.
+      If inflating from the access point fails while seeking, the seek returns -1
+      and the read position is reset to the beginning of the file.
+     */
+    bool setIndex( boost::shared_ptr< const GzipIndex > index );
+
+    /*!
+      \brief set the read-ahead mode used by the next open().
+      \param on if true, a worker thread inflates the large blocks in advance
+      while the caller consumes the previous block.
+
+      This mode is available only for the input mode.
+     */
+    void setReadAhead( const bool on );
+
 
 private:
 
@@ -206,7 +231,8 @@ protected:
       \param way object of type ios_base::seekdir.
       ios_base::beg (offset from the beginning of the stream's buffer).
       ios_base::cur (offset from the current position in the stream's buffer).
-      ios_base::cur (offset from the end of the stream's buffer).
+      ios_base::end (offset from the end of the stream's buffer).
+      ios_base::end is available only if the index is set.
       \param mode IO mode
       \return new position value of the modified position pointer.
       in case of error, returned -1.
@@ -275,7 +301,7 @@ protected:
       XXX imbue Imbue locale [virtual]
       OK overflow Put character at current position [virtual]
       XXX pbackfail Put character back [virtual]
-      N/A seekoff Set relative position of internal position pointer [virtual]
+      OK seekoff Set relative position of internal position pointer [virtual]
       OK seekpos  Set absolute position of internal position pointer [virtual]
       XXX setbuf  Set buffer [virtual]
       OK showmanyc  Get number of characters availbale in input sequence [virtual]
@@ -347,6 +373,25 @@ public:
      */
     void open( const char * path );
 
+    /*!
+      \brief set the access point index for the fast seeking.
+      \param index access point index built from the opened file.
+      \return true if the index is valid for the opened file.
+     */
+    bool setIndex( boost::shared_ptr< const GzipIndex > index )
+      {
+          return M_file_buf.setIndex( index );
+      }
+
+    /*!
+      \brief set the read-ahead mode. This has to be called before open().
+      \param on if true, a worker thread inflates the data in advance.
+     */
+    void setReadAhead( const bool on )
+      {
+          M_file_buf.setReadAhead( on );
+      }
+
     /*!
       \brief close gzipped file.
 
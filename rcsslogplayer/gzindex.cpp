@@ -0,0 +1,558 @@
+// -*-c++-*-
+
+/*!
+  \file gzindex.cpp
+  \brief random access point index for gzip files Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "gzindex.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+namespace {
+
+const char INDEX_MAGIC[] = "RCGZIDX1";
+const std::size_t INDEX_MAGIC_SIZE = 8;
+const std::size_t INDEX_HEADER_SIZE = INDEX_MAGIC_SIZE + 8 + 8 + 8 + 8 + 4 + 4;
+const std::size_t POINT_HEADER_SIZE = 8 + 8 + 4 + 4;
+
+//! the number of bytes used to calculate the hash value of the file
+const std::size_t HASH_BLOCK_SIZE = 4096;
+
+//! the size of the input buffer
+const std::size_t CHUNK_SIZE = 16384;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief calculate the FNV-1a hash value
+ */
+boost::uint64_t
+fnv1a( const char * first,
+       const char * last )
+{
+    boost::uint64_t h = 14695981039346656037ULL;
+    for ( ; first != last; ++first )
+    {
+        h ^= static_cast< unsigned char >( *first );
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the size and the hash values of the file.
+ */
+bool
+file_hash( const char * path,
+           boost::uint64_t * size,
+           boost::uint64_t * head,
+           boost::uint64_t * tail )
+{
+    std::FILE * fp = std::fopen( path, "rb" );
+    if ( ! fp )
+    {
+        return false;
+    }
+
+    char buf[HASH_BLOCK_SIZE];
+    bool result = false;
+
+    if ( std::fseek( fp, 0, SEEK_END ) == 0 )
+    {
+        const long file_size = std::ftell( fp );
+        const std::size_t n = std::min( static_cast< std::size_t >( std::max( file_size, 0L ) ),
+                                        HASH_BLOCK_SIZE );
+        if ( file_size >= 0
+             && std::fseek( fp, 0, SEEK_SET ) == 0
+             && std::fread( buf, 1, n, fp ) == n )
+        {
+            *size = static_cast< boost::uint64_t >( file_size );
+            *head = fnv1a( buf, buf + n );
+
+            if ( std::fseek( fp, file_size - static_cast< long >( n ), SEEK_SET ) == 0
+                 && std::fread( buf, 1, n, fp ) == n )
+            {
+                *tail = fnv1a( buf, buf + n );
+                result = true;
+            }
+        }
+    }
+
+    std::fclose( fp );
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+void
+put_u32( std::string & out,
+         const boost::uint32_t value )
+{
+    for ( int i = 0; i < 4; ++i )
+    {
+        out += static_cast< char >( ( value >> ( 8 * i ) ) & 0xff );
+    }
+}
+
+void
+put_u64( std::string & out,
+         const boost::uint64_t value )
+{
+    for ( int i = 0; i < 8; ++i )
+    {
+        out += static_cast< char >( ( value >> ( 8 * i ) ) & 0xff );
+    }
+}
+
+boost::uint32_t
+get_u32( const char * p )
+{
+    boost::uint32_t value = 0;
+    for ( int i = 3; i >= 0; --i )
+    {
+        value = ( value << 8 ) | static_cast< unsigned char >( p[i] );
+    }
+    return value;
+}
+
+boost::uint64_t
+get_u64( const char * p )
+{
+    boost::uint64_t value = 0;
+    for ( int i = 7; i >= 0; --i )
+    {
+        value = ( value << 8 ) | static_cast< unsigned char >( p[i] );
+    }
+    return value;
+}
+
+/*-------------------------------------------------------------------*/
+struct OutCmp {
+    bool operator()( const boost::uint64_t offset,
+                     const rcss::GzipIndex::Point & rhs ) const
+      {
+          return offset < rhs.out_;
+      }
+};
+
+}
+
+namespace rcss {
+
+const std::size_t GzipIndex::DEFAULT_SPAN;
+const std::size_t GzipIndex::WINDOW_SIZE;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+GzipIndex::GzipIndex()
+    : M_file_size( 0 ),
+      M_head_hash( 0 ),
+      M_tail_hash( 0 ),
+      M_data_size( 0 ),
+      M_span( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+GzipIndex::clear()
+{
+    M_file_size = 0;
+    M_head_hash = 0;
+    M_tail_hash = 0;
+    M_data_size = 0;
+    M_span = 0;
+
+    M_points.clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::string
+GzipIndex::indexFilePath( const std::string & gz_path )
+{
+    const std::string ext = ".gz";
+    if ( gz_path.length() > ext.length()
+         && gz_path.compare( gz_path.length() - ext.length(), ext.length(), ext ) == 0 )
+    {
+        return gz_path + "idx";
+    }
+
+    return gz_path + ".gzidx";
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+GzipIndex::build( const char * path,
+                  const std::size_t span )
+{
+    clear();
+
+#ifdef HAVE_LIBZ
+    if ( span == 0
+         || ! file_hash( path, &M_file_size, &M_head_hash, &M_tail_hash ) )
+    {
+        return false;
+    }
+
+    std::FILE * fp = std::fopen( path, "rb" );
+    if ( ! fp )
+    {
+        return false;
+    }
+
+    z_stream strm;
+    std::memset( &strm, 0, sizeof( strm ) );
+
+    // 15 + 32: the gzip or zlib header is automatically detected.
+    if ( inflateInit2( &strm, 15 + 32 ) != Z_OK )
+    {
+        std::fclose( fp );
+        return false;
+    }
+
+    std::vector< unsigned char > input( CHUNK_SIZE );
+    // the output is written to the window cyclically.
+    std::vector< unsigned char > window( WINDOW_SIZE, 0 );
+
+    boost::uint64_t total_in = 0;
+    boost::uint64_t total_out = 0;
+    boost::uint64_t last = 0;
+    int n_members = 0;
+    bool member_head = true;
+    bool result = false;
+
+    strm.avail_out = 0;
+    while ( true )
+    {
+        if ( strm.avail_in == 0 )
+        {
+            strm.avail_in = static_cast< uInt >( std::fread( &input[0], 1, CHUNK_SIZE, fp ) );
+            strm.next_in = &input[0];
+
+            if ( std::ferror( fp ) )
+            {
+                break;
+            }
+
+            if ( strm.avail_in == 0 )
+            {
+                // the last member has to be completed.
+                result = ( member_head && total_in > 0 );
+                break;
+            }
+        }
+
+        if ( member_head )
+        {
+            // the gzip member can be inflated without the dictionary.
+            if ( M_points.empty()
+                 || total_out - last >= span )
+            {
+                Point p;
+                p.out_ = total_out;
+                p.in_ = total_in;
+                p.bits_ = -1;
+                M_points.push_back( p );
+                last = total_out;
+            }
+            member_head = false;
+        }
+
+        if ( strm.avail_out == 0 )
+        {
+            strm.avail_out = static_cast< uInt >( WINDOW_SIZE );
+            strm.next_out = &window[0];
+        }
+
+        total_in += strm.avail_in;
+        total_out += strm.avail_out;
+        const int ret = inflate( &strm, Z_BLOCK );
+        total_in -= strm.avail_in;
+        total_out -= strm.avail_out;
+
+        if ( ret == Z_STREAM_END )
+        {
+            ++n_members;
+            member_head = true;
+            inflateReset( &strm );
+            continue;
+        }
+
+        if ( ret == Z_NEED_DICT
+             || ret == Z_DATA_ERROR
+             || ret == Z_MEM_ERROR )
+        {
+            // trailing garbage after the last member is ignored in the same way as gzread().
+            if ( ret == Z_DATA_ERROR
+                 && n_members > 0
+                 && strm.total_out == 0 )
+            {
+                if ( M_points.back().bits_ < 0
+                     && M_points.back().out_ == total_out )
+                {
+                    M_points.pop_back();
+                }
+                result = true;
+            }
+            break;
+        }
+
+        // the end of the deflate block header, but not the last block.
+        if ( ( strm.data_type & 128 )
+             && ! ( strm.data_type & 64 )
+             && total_out - last >= span )
+        {
+            const std::size_t left = strm.avail_out;
+
+            Point p;
+            p.out_ = total_out;
+            p.in_ = total_in;
+            p.bits_ = strm.data_type & 7;
+            p.window_.resize( WINDOW_SIZE );
+            if ( left > 0 )
+            {
+                std::memcpy( &p.window_[0], &window[WINDOW_SIZE - left], left );
+            }
+            if ( left < WINDOW_SIZE )
+            {
+                std::memcpy( &p.window_[left], &window[0], WINDOW_SIZE - left );
+            }
+            M_points.push_back( p );
+            last = total_out;
+        }
+    }
+
+    inflateEnd( &strm );
+    std::fclose( fp );
+
+    if ( ! result )
+    {
+        clear();
+        return false;
+    }
+
+    M_data_size = total_out;
+    M_span = span;
+    return true;
+#else
+    (void)path;
+    (void)span;
+    return false;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+GzipIndex::read( const std::string & path )
+{
+    clear();
+
+    std::ifstream fin( path.c_str(), std::ios_base::in | std::ios_base::binary );
+    if ( ! fin )
+    {
+        return false;
+    }
+
+    char header[INDEX_HEADER_SIZE];
+    if ( ! fin.read( header, INDEX_HEADER_SIZE )
+         || std::memcmp( header, INDEX_MAGIC, INDEX_MAGIC_SIZE ) != 0 )
+    {
+        return false;
+    }
+
+    const char * p = header + INDEX_MAGIC_SIZE;
+    M_file_size = get_u64( p ); p += 8;
+    M_head_hash = get_u64( p ); p += 8;
+    M_tail_hash = get_u64( p ); p += 8;
+    M_data_size = get_u64( p ); p += 8;
+    M_span = get_u32( p ); p += 4;
+    const boost::uint32_t n_points = get_u32( p );
+
+    // each point has at least its header. the count must not exceed the file size.
+    const std::streampos data_pos = fin.tellg();
+    fin.seekg( 0, std::ios_base::end );
+    const std::streamoff rest = fin.tellg() - data_pos;
+    fin.seekg( data_pos );
+    if ( ! fin
+         || rest < 0
+         || static_cast< boost::uint64_t >( rest ) / POINT_HEADER_SIZE < n_points )
+    {
+        clear();
+        return false;
+    }
+
+    M_points.resize( n_points );
+    for ( boost::uint32_t i = 0; i < n_points; ++i )
+    {
+        char buf[POINT_HEADER_SIZE];
+        if ( ! fin.read( buf, POINT_HEADER_SIZE ) )
+        {
+            clear();
+            return false;
+        }
+
+        Point & pt = M_points[i];
+        p = buf;
+        pt.out_ = get_u64( p ); p += 8;
+        pt.in_ = get_u64( p ); p += 8;
+        pt.bits_ = static_cast< int >( get_u32( p ) ); p += 4;
+        const boost::uint32_t window_size = get_u32( p );
+
+        if ( pt.bits_ < -1 || 7 < pt.bits_
+             || M_file_size <= pt.in_
+             || ( i > 0 && pt.out_ < M_points[i - 1].out_ )
+             || window_size != ( pt.bits_ < 0 ? 0 : WINDOW_SIZE ) )
+        {
+            clear();
+            return false;
+        }
+
+        if ( window_size > 0 )
+        {
+            pt.window_.resize( window_size );
+            if ( ! fin.read( reinterpret_cast< char * >( &pt.window_[0] ), window_size ) )
+            {
+                clear();
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+GzipIndex::write( const std::string & path ) const
+{
+    std::string out;
+    out.reserve( INDEX_HEADER_SIZE + M_points.size() * ( POINT_HEADER_SIZE + WINDOW_SIZE ) );
+
+    out.append( INDEX_MAGIC, INDEX_MAGIC_SIZE );
+    put_u64( out, M_file_size );
+    put_u64( out, M_head_hash );
+    put_u64( out, M_tail_hash );
+    put_u64( out, M_data_size );
+    put_u32( out, static_cast< boost::uint32_t >( M_span ) );
+    put_u32( out, static_cast< boost::uint32_t >( M_points.size() ) );
+
+    for ( std::vector< Point >::const_iterator it = M_points.begin(), end = M_points.end();
+          it != end;
+          ++it )
+    {
+        put_u64( out, it->out_ );
+        put_u64( out, it->in_ );
+        put_u32( out, static_cast< boost::uint32_t >( it->bits_ ) );
+        put_u32( out, static_cast< boost::uint32_t >( it->window_.size() ) );
+        if ( ! it->window_.empty() )
+        {
+            out.append( reinterpret_cast< const char * >( &it->window_[0] ), it->window_.size() );
+        }
+    }
+
+    std::ofstream fout( path.c_str(),
+                        std::ios_base::out
+                        | std::ios_base::trunc
+                        | std::ios_base::binary );
+    if ( ! fout
+         || ! fout.write( out.data(), out.size() ) )
+    {
+        return false;
+    }
+
+    fout.close();
+    return ! fout.fail();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+GzipIndex::isValidFor( const char * path ) const
+{
+    boost::uint64_t size = 0;
+    boost::uint64_t head = 0;
+    boost::uint64_t tail = 0;
+
+    return ( ! M_points.empty()
+             && file_hash( path, &size, &head, &tail )
+             && M_file_size == size
+             && M_head_hash == head
+             && M_tail_hash == tail );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+const GzipIndex::Point *
+GzipIndex::findPoint( const boost::uint64_t offset ) const
+{
+    std::vector< Point >::const_iterator it
+        = std::upper_bound( M_points.begin(), M_points.end(),
+                            offset,
+                            OutCmp() );
+    if ( it == M_points.begin() )
+    {
+        return 0;
+    }
+
+    return &(*( it - 1 ));
+}
+
+}
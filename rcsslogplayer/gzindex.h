@@ -0,0 +1,187 @@
+// -*-c++-*-
+
+/*!
+  \file gzindex.h
+  \brief random access point index for gzip files Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_GZINDEX_H
+#define RCSSLOGPLAYER_GZINDEX_H
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace rcss {
+
+/*!
+  \class GzipIndex
+  \brief access point index for the random access to the gzip file.
+
+  The deflate stream can be restarted at any block boundary if the last 32K bytes
+  of the uncompressed data (the dictionary) are given. The index records such
+  access points at every span bytes of the uncompressed data, so gzfilebuf can
+  seek to any position by inflating less than span bytes.
+  Multiple gzip members in one file are also supported.
+
+  The index is saved as the sidecar file (.gzidx) next to the gzip file.
+  All integers are stored in little endian.
+  \verbatim
+  "RCGZIDX1"
+  uint64 size of the gzip file
+  uint64 hash of the first 4096 bytes of the gzip file
+  uint64 hash of the last 4096 bytes of the gzip file
+  uint64 size of the uncompressed data
+  uint32 span
+  uint32 number of access points
+  { uint64 out, uint64 in, int32 bits, uint32 window size, window } * number of access points
+  \endverbatim
+*/
+class GzipIndex {
+public:
+
+    //! default distance between the access points in the uncompressed data.
+    static const std::size_t DEFAULT_SPAN = 1024 * 1024;
+
+    //! size of the deflate dictionary
+    static const std::size_t WINDOW_SIZE = 32768;
+
+    /*!
+      \struct Point
+      \brief access point
+     */
+    struct Point {
+        boost::uint64_t out_; //!< offset in the uncompressed data
+        boost::uint64_t in_; //!< offset of the first full byte in the gzip file
+        int bits_; //!< number of bits (1-7) in the byte at in_-1, or 0. -1 if a gzip member starts at in_.
+        std::vector< unsigned char > window_; //!< last WINDOW_SIZE bytes of the uncompressed data. empty for the member head.
+
+        Point()
+            : out_( 0 ),
+              in_( 0 ),
+              bits_( 0 )
+          { }
+    };
+
+private:
+
+    boost::uint64_t M_file_size; //!< size of the gzip file
+    boost::uint64_t M_head_hash; //!< hash value of the first bytes of the gzip file
+    boost::uint64_t M_tail_hash; //!< hash value of the last bytes of the gzip file
+    boost::uint64_t M_data_size; //!< size of the uncompressed data
+    std::size_t M_span;
+
+    std::vector< Point > M_points;
+
+public:
+
+    /*!
+      \brief construct an empty index
+     */
+    GzipIndex();
+
+    /*!
+      \brief clear all data
+     */
+    void clear();
+
+    /*!
+      \brief get the sidecar file path for the gzip file
+      \param gz_path path of the gzip file
+      \return sidecar file path. "idx" is appended to the ".gz" extension.
+     */
+    static
+    std::string indexFilePath( const std::string & gz_path );
+
+    /*!
+      \brief build the index by inflating the whole file.
+      \param path path of the gzip file
+      \param span distance between the access points in the uncompressed data
+      \return true if the whole file is successfully inflated.
+     */
+    bool build( const char * path,
+                const std::size_t span = DEFAULT_SPAN );
+
+    /*!
+      \brief read the sidecar file.
+      \param path sidecar file path
+      \return true if successfully read.
+     */
+    bool read( const std::string & path );
+
+    /*!
+      \brief write the sidecar file.
+      \param path sidecar file path
+      \return true if successfully written.
+     */
+    bool write( const std::string & path ) const;
+
+    /*!
+      \brief check if this index was built from the given gzip file.
+      \param path path of the gzip file
+      \return true if the size and the hash values of the file are matched.
+     */
+    bool isValidFor( const char * path ) const;
+
+    /*!
+      \brief get the size of the uncompressed data
+      \return byte length of the uncompressed data
+     */
+    boost::uint64_t dataSize() const
+      {
+          return M_data_size;
+      }
+
+    /*!
+      \brief get the distance between the access points
+      \return span value used to build the index
+     */
+    std::size_t span() const
+      {
+          return M_span;
+      }
+
+    const
+    std::vector< Point > & points() const
+      {
+          return M_points;
+      }
+
+    /*!
+      \brief find the last access point at or before the offset.
+      \param offset offset in the uncompressed data
+      \return pointer to the found point or NULL
+     */
+    const Point * findPoint( const boost::uint64_t offset ) const;
+};
+
+}
+
+#endif
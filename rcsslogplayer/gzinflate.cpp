@@ -0,0 +1,525 @@
+// -*-c++-*-
+
+/*!
+  \file gzinflate.cpp
+  \brief in-memory gzip inflation Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "gzinflate.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
+
+#ifdef HAVE_LIBZ
+
+namespace {
+
+//! the minimum length of the gzip member. (header + empty deflate block + trailer)
+const std::size_t GZIP_MIN_MEMBER_SIZE = 10 + 2 + 8;
+
+//! the maximum compression ratio of deflate
+const std::size_t DEFLATE_MAX_RATIO = 1032;
+
+//! the maximum ratio of the output size to the input size in the parallel mode.
+//! text logs are compressed to 1/2 - 1/10. the larger data are inflated serially.
+const std::size_t PARALLEL_MAX_RATIO = 64;
+
+//! the input length used to check a member candidate
+const std::size_t TRIAL_INPUT_SIZE = 4096;
+
+/*!
+  \struct Member
+  \brief a gzip member candidate
+*/
+struct Member {
+    const char * first_; //!< head of the member
+    const char * last_; //!< end of the member
+    std::size_t out_offset_; //!< position in the output
+    std::size_t out_size_; //!< uncompressed size given by the ISIZE trailer
+};
+
+/*!
+  \struct InflateTask
+  \brief contiguous members assigned to one thread.
+*/
+struct InflateTask {
+    Member * first_;
+    Member * last_;
+    char * out_;
+    bool result_;
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check the fixed part of the gzip header.
+*/
+inline
+bool
+is_member_head( const char * p )
+{
+    const unsigned char xfl = static_cast< unsigned char >( p[8] );
+    const unsigned char os = static_cast< unsigned char >( p[9] );
+
+    // ID1, ID2, CM (deflate), the reserved flag bits,
+    // XFL (0, 2: best, 4: fastest) and OS (0-13 or 255: unknown). MTIME can be any value.
+    return ( static_cast< unsigned char >( p[0] ) == 0x1f
+             && static_cast< unsigned char >( p[1] ) == 0x8b
+             && p[2] == 8
+             && ( p[3] & 0xe0 ) == 0
+             && ( xfl == 0 || xfl == 2 || xfl == 4 )
+             && ( os <= 13 || os == 255 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the data can be inflated as a gzip member.
+  \param strm initialized inflate stream for the gzip wrapper
+  \param p head of the member candidate
+  \param end end of the data
+  \return true if no error is found in the first bytes.
+
+  The bytes 1f 8b 08 can appear in the deflate data. Such a false candidate
+  is rejected by the header or by the first blocks in most cases.
+*/
+bool
+try_member( z_stream & strm,
+            const char * p,
+            const char * end )
+{
+    if ( inflateReset( &strm ) != Z_OK )
+    {
+        return false;
+    }
+
+    char scratch[1024];
+    strm.next_in = reinterpret_cast< Bytef * >( const_cast< char * >( p ) );
+    strm.avail_in = static_cast< uInt >( std::min( static_cast< std::size_t >( end - p ),
+                                                   TRIAL_INPUT_SIZE ) );
+    strm.next_out = reinterpret_cast< Bytef * >( scratch );
+    strm.avail_out = sizeof( scratch );
+
+    const int ret = inflate( &strm, Z_SYNC_FLUSH );
+    return ( ret == Z_OK
+             || ret == Z_STREAM_END
+             || ret == Z_BUF_ERROR );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief detect the member boundaries and their output positions.
+  \return total size of the output. 0 if the sizes are inconsistent or too large.
+*/
+std::size_t
+find_members( const char * buf,
+              const std::size_t size,
+              std::vector< Member > & members )
+{
+    z_stream strm;
+    std::memset( &strm, 0, sizeof( strm ) );
+
+    // 15 + 16: gzip wrapper only
+    if ( inflateInit2( &strm, 15 + 16 ) != Z_OK )
+    {
+        return 0;
+    }
+
+    const char * end = buf + size;
+    const char * p = buf;
+    while ( p + GZIP_MIN_MEMBER_SIZE <= end )
+    {
+        p = static_cast< const char * >( std::memchr( p, 0x1f, end - GZIP_MIN_MEMBER_SIZE + 1 - p ) );
+        if ( ! p )
+        {
+            break;
+        }
+
+        if ( is_member_head( p )
+             && try_member( strm, p, end ) )
+        {
+            Member m;
+            m.first_ = p;
+            members.push_back( m );
+            p += GZIP_MIN_MEMBER_SIZE;
+        }
+        else
+        {
+            ++p;
+        }
+    }
+
+    inflateEnd( &strm );
+
+    if ( members.empty()
+         || members.front().first_ != buf )
+    {
+        return 0;
+    }
+
+    std::size_t total = 0;
+    for ( std::size_t i = 0; i < members.size(); ++i )
+    {
+        Member & m = members[i];
+        m.last_ = ( i + 1 < members.size() ? members[i + 1].first_ : end );
+
+        const unsigned char * t = reinterpret_cast< const unsigned char * >( m.last_ - 4 );
+        m.out_size_ = ( static_cast< std::size_t >( t[0] )
+                        | ( static_cast< std::size_t >( t[1] ) << 8 )
+                        | ( static_cast< std::size_t >( t[2] ) << 16 )
+                        | ( static_cast< std::size_t >( t[3] ) << 24 ) );
+        m.out_offset_ = total;
+
+        // a wrong boundary gives the meaningless size.
+        if ( m.out_size_ > static_cast< std::size_t >( m.last_ - m.first_ ) * DEFLATE_MAX_RATIO )
+        {
+            return 0;
+        }
+
+        total += m.out_size_;
+    }
+
+    // the output is allocated before the boundaries are confirmed by inflating.
+    // an unlikely large size is not trusted.
+    if ( total > size * PARALLEL_MAX_RATIO )
+    {
+        return 0;
+    }
+
+    return total;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief thread function to inflate the members.
+*/
+void *
+inflate_members( void * arg )
+{
+    InflateTask * task = static_cast< InflateTask * >( arg );
+    task->result_ = false;
+
+    for ( Member * m = task->first_; m != task->last_; ++m )
+    {
+        z_stream strm;
+        std::memset( &strm, 0, sizeof( strm ) );
+
+        // 15 + 16: gzip wrapper only
+        if ( inflateInit2( &strm, 15 + 16 ) != Z_OK )
+        {
+            return 0;
+        }
+
+        char dummy = 0;
+        strm.next_in = reinterpret_cast< Bytef * >( const_cast< char * >( m->first_ ) );
+        strm.avail_in = static_cast< uInt >( m->last_ - m->first_ );
+        strm.next_out = reinterpret_cast< Bytef * >( m->out_size_ > 0
+                                                     ? task->out_ + m->out_offset_
+                                                     : &dummy );
+        strm.avail_out = static_cast< uInt >( m->out_size_ );
+
+        const int ret = inflate( &strm, Z_FINISH );
+        const bool ok = ( ret == Z_STREAM_END
+                          && strm.avail_in == 0
+                          && strm.avail_out == 0 );
+        inflateEnd( &strm );
+
+        if ( ! ok )
+        {
+            return 0;
+        }
+    }
+
+    task->result_ = true;
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief execute the inflate tasks concurrently.
+
+  The first task is executed in the caller's thread.
+  If a thread cannot be created, its task is also executed in the caller's thread.
+*/
+void
+run_tasks( std::vector< InflateTask > & tasks )
+{
+#ifdef HAVE_LIBPTHREAD
+    std::vector< pthread_t > threads( tasks.size() );
+    std::vector< char > created( tasks.size(), 0 );
+
+    for ( std::size_t i = 1; i < tasks.size(); ++i )
+    {
+        if ( pthread_create( &threads[i], 0, inflate_members, &tasks[i] ) == 0 )
+        {
+            created[i] = 1;
+        }
+    }
+
+    if ( ! tasks.empty() )
+    {
+        inflate_members( &tasks[0] );
+    }
+
+    for ( std::size_t i = 1; i < tasks.size(); ++i )
+    {
+        if ( created[i] )
+        {
+            pthread_join( threads[i], 0 );
+        }
+        else
+        {
+            inflate_members( &tasks[i] );
+        }
+    }
+#else
+    for ( std::size_t i = 0; i < tasks.size(); ++i )
+    {
+        inflate_members( &tasks[i] );
+    }
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief inflate the members in parallel.
+  \return true if all members are inflated.
+*/
+bool
+inflate_parallel( const char * buf,
+                  const std::size_t size,
+                  const int thread_count,
+                  std::vector< char > & out )
+{
+    std::vector< Member > members;
+    const std::size_t total = find_members( buf, size, members );
+    if ( members.size() < 2
+         || total == 0 )
+    {
+        return false;
+    }
+
+    out.resize( total );
+
+    // assign the contiguous members with the similar compressed size to each thread.
+    const std::size_t n_tasks = std::min( static_cast< std::size_t >( thread_count ), members.size() );
+    std::vector< InflateTask > tasks;
+    tasks.reserve( n_tasks );
+
+    Member * first = &members[0];
+    Member * end = first + members.size();
+    for ( std::size_t i = 0; i < n_tasks && first != end; ++i )
+    {
+        const char * limit = buf + size * ( i + 1 ) / n_tasks;
+        Member * last = first + 1;
+        while ( last != end
+                && ( i + 1 == n_tasks || last->first_ < limit ) )
+        {
+            ++last;
+        }
+
+        InflateTask task;
+        task.first_ = first;
+        task.last_ = last;
+        task.out_ = &out[0];
+        task.result_ = false;
+        tasks.push_back( task );
+
+        first = last;
+    }
+
+    run_tasks( tasks );
+
+    // each member has to end at the head of the next one, and give the size of its trailer.
+    // otherwise, a boundary was wrong. the caller inflates the data serially.
+    for ( std::size_t i = 0; i < tasks.size(); ++i )
+    {
+        if ( ! tasks[i].result_ )
+        {
+            std::vector< char >().swap( out );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief inflate the whole data in a single stream.
+
+  In the same way as gzread(), the trailing garbage after the last member
+  is ignored, and the truncated last member gives the partial data.
+*/
+bool
+inflate_stream( const char * buf,
+                const std::size_t size,
+                std::vector< char > & out )
+{
+    out.clear();
+
+    z_stream strm;
+    std::memset( &strm, 0, sizeof( strm ) );
+
+    // 15 + 32: the gzip or zlib header is automatically detected.
+    if ( inflateInit2( &strm, 15 + 32 ) != Z_OK )
+    {
+        return false;
+    }
+
+    strm.next_in = reinterpret_cast< Bytef * >( const_cast< char * >( buf ) );
+    strm.avail_in = static_cast< uInt >( size );
+
+    // the ISIZE trailer of the single member file gives the exact size.
+    const unsigned char * t = reinterpret_cast< const unsigned char * >( buf + size - 4 );
+    const std::size_t hint = ( size >= GZIP_MIN_MEMBER_SIZE
+                               ? ( static_cast< std::size_t >( t[0] )
+                                   | ( static_cast< std::size_t >( t[1] ) << 8 )
+                                   | ( static_cast< std::size_t >( t[2] ) << 16 )
+                                   | ( static_cast< std::size_t >( t[3] ) << 24 ) )
+                               : 0 );
+    out.resize( hint > 0 && hint <= size * DEFLATE_MAX_RATIO
+                ? hint
+                : std::max( size * 4, static_cast< std::size_t >( 65536 ) ) );
+
+    std::size_t produced = 0;
+    int n_members = 0;
+    bool result = false;
+
+    while ( true )
+    {
+        if ( produced == out.size() )
+        {
+            out.resize( out.size() * 2 );
+        }
+
+        strm.next_out = reinterpret_cast< Bytef * >( &out[produced] );
+        strm.avail_out = static_cast< uInt >( out.size() - produced );
+
+        const int ret = inflate( &strm, Z_NO_FLUSH );
+        produced = out.size() - strm.avail_out;
+
+        if ( ret == Z_STREAM_END )
+        {
+            ++n_members;
+            if ( strm.avail_in == 0 )
+            {
+                result = true;
+                break;
+            }
+
+            inflateReset( &strm );
+            continue;
+        }
+
+        if ( ret == Z_OK )
+        {
+            continue;
+        }
+
+        if ( ret == Z_BUF_ERROR )
+        {
+            if ( strm.avail_out == 0 )
+            {
+                continue;
+            }
+
+            // truncated last member
+            result = ( produced > 0 );
+            break;
+        }
+
+        // trailing garbage
+        result = ( ret == Z_DATA_ERROR
+                   && n_members > 0
+                   && strm.total_out == 0 );
+        break;
+    }
+
+    inflateEnd( &strm );
+
+    out.resize( result ? produced : 0 );
+    if ( out.capacity() > out.size() + out.size() / 2 )
+    {
+        // release the unused area
+        std::vector< char >( out ).swap( out );
+    }
+    return result;
+}
+
+}
+
+#endif
+
+namespace rcss {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+inflate_gzip( const char * buf,
+              const std::size_t size,
+              const int thread_count,
+              std::vector< char > & out )
+{
+    out.clear();
+
+#ifdef HAVE_LIBZ
+    if ( ! buf
+         || size < 2 )
+    {
+        return false;
+    }
+
+    if ( thread_count > 1
+         && inflate_parallel( buf, size, thread_count, out ) )
+    {
+        return true;
+    }
+
+    return inflate_stream( buf, size, out );
+#else
+    (void)buf;
+    (void)size;
+    (void)thread_count;
+    return false;
+#endif
+}
+
+}
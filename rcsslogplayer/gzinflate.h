@@ -0,0 +1,64 @@
+// -*-c++-*-
+
+/*!
+  \file gzinflate.h
+  \brief in-memory gzip inflation Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_GZINFLATE_H
+#define RCSSLOGPLAYER_GZINFLATE_H
+
+#include <vector>
+#include <cstddef>
+
+namespace rcss {
+
+/*!
+  \brief inflate the whole gzip data in the memory.
+  \param buf head of the gzip data (e.g. mapped file)
+  \param size byte length of the gzip data
+  \param thread_count the number of threads used to inflate the gzip members
+  \param out reference to the result container
+  \return true if the whole data is successfully inflated.
+
+  The data may consist of the concatenated gzip members (e.g. the log file
+  flushed periodically). The member boundaries are detected by the gzip
+  header and a trial inflation of the first bytes, and the members are
+  inflated by multiple threads directly into their positions in the output.
+  The output position of each member is given by its ISIZE trailer. If the
+  total size is unlikely large, or any boundary turns out to be wrong, the
+  whole data is inflated in a single stream instead.
+*/
+bool inflate_gzip( const char * buf,
+                   const std::size_t size,
+                   const int thread_count,
+                   std::vector< char > & out );
+
+}
+
+#endif
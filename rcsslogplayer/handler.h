@@ -36,6 +36,7 @@
 #include <rcsslogplayer/types.h>
 
 #include <string>
+#include <cstddef>
 
 namespace rcss {
 namespace rcg {
@@ -73,6 +74,12 @@ private:
           doHandleShowInfo( info );
       }
 
+    void handleShowBlock( const ShowInfoT * shows,
+                          const std::size_t n )
+      {
+          doHandleShowBlock( shows, n );
+      }
+
     void handleMsgInfo( const int time,
                         const int board,
                         const std::string & msg )
@@ -146,6 +153,26 @@ protected:
     virtual
     void doHandleShowInfo( const ShowInfoT & ) = 0;
 
+    /*!
+      \brief receive the consecutive show records at once.
+      \param shows head of the show array
+      \param n the number of the show records
+
+      This method is called instead of doHandleShowInfo() if the show block
+      is enabled by Parser::setShowBlockSize(). No other record exists between
+      the show records in the block. The default implementation passes each
+      record to doHandleShowInfo().
+     */
+    virtual
+    void doHandleShowBlock( const ShowInfoT * shows,
+                            const std::size_t n )
+      {
+          for ( std::size_t i = 0; i < n; ++i )
+          {
+              doHandleShowInfo( shows[i] );
+          }
+      }
+
     virtual
     void doHandleMsgInfo( const int,
                           const int,
@@ -0,0 +1,624 @@
+// -*-c++-*-
+
+/*!
+  \file index.cpp
+  \brief rcg offset index Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "index.h"
+
+#include "handler.h"
+#include "parser.h"
+#include "types.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char INDEX_MAGIC[] = "RCGIDX01";
+const std::size_t INDEX_MAGIC_SIZE = 8;
+const std::size_t INDEX_HEADER_SIZE = INDEX_MAGIC_SIZE + 4 + 8 + 8 + 8 + 8 + 4;
+const std::size_t INDEX_ENTRY_SIZE = 8 + 4 + 4 + 4 + 4 + 4;
+
+//! the number of bytes used to calculate the hash value of the data
+const std::size_t HASH_BLOCK_SIZE = 4096;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief calculate the FNV-1a hash value
+ */
+boost::uint64_t
+fnv1a( const char * first,
+       const char * last )
+{
+    boost::uint64_t h = 14695981039346656037ULL;
+    for ( ; first != last; ++first )
+    {
+        h ^= static_cast< unsigned char >( *first );
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+boost::uint64_t
+head_hash( const char * buf,
+           const std::size_t size )
+{
+    return fnv1a( buf, buf + std::min( size, HASH_BLOCK_SIZE ) );
+}
+
+boost::uint64_t
+tail_hash( const char * buf,
+           const std::size_t size )
+{
+    return fnv1a( buf + size - std::min( size, HASH_BLOCK_SIZE ), buf + size );
+}
+
+/*-------------------------------------------------------------------*/
+void
+put_u32( std::string & out,
+         const boost::uint32_t value )
+{
+    for ( int i = 0; i < 4; ++i )
+    {
+        out += static_cast< char >( ( value >> ( 8 * i ) ) & 0xff );
+    }
+}
+
+void
+put_u64( std::string & out,
+         const boost::uint64_t value )
+{
+    for ( int i = 0; i < 8; ++i )
+    {
+        out += static_cast< char >( ( value >> ( 8 * i ) ) & 0xff );
+    }
+}
+
+boost::uint32_t
+get_u32( const char * p )
+{
+    boost::uint32_t value = 0;
+    for ( int i = 3; i >= 0; --i )
+    {
+        value = ( value << 8 ) | static_cast< unsigned char >( p[i] );
+    }
+    return value;
+}
+
+boost::uint64_t
+get_u64( const char * p )
+{
+    boost::uint64_t value = 0;
+    for ( int i = 7; i >= 0; --i )
+    {
+        value = ( value << 8 ) | static_cast< unsigned char >( p[i] );
+    }
+    return value;
+}
+
+/*-------------------------------------------------------------------*/
+struct TimeCmp {
+    bool operator()( const rcss::rcg::Index::Entry & lhs,
+                     const int time ) const
+      {
+          return lhs.time_ < time;
+      }
+};
+
+struct OffsetCmp {
+    bool operator()( const rcss::rcg::Index::Entry & lhs,
+                     const std::size_t offset ) const
+      {
+          return lhs.offset_ < offset;
+      }
+
+    bool operator()( const rcss::rcg::Index::Entry & lhs,
+                     const rcss::rcg::Index::Entry & rhs ) const
+      {
+          return lhs.offset_ < rhs.offset_;
+      }
+};
+
+}
+
+namespace rcss {
+namespace rcg {
+
+/*!
+  \class IndexBuilder
+  \brief handler to record the position of the parsed records.
+
+  The caller sets the head position of the next record before each Parser::parse() call.
+*/
+class IndexBuilder
+    : public Handler {
+private:
+
+    Index & M_index;
+
+    std::size_t M_offset; //!< head position of the record being parsed
+    int M_line; //!< line number of the record being parsed
+
+    PlayMode M_playmode; //!< last indexed playmode
+    TeamT M_teams[2]; //!< last indexed team info
+
+public:
+
+    explicit
+    IndexBuilder( Index & index )
+        : M_index( index ),
+          M_offset( 0 ),
+          M_line( 0 ),
+          M_playmode( PM_Null )
+      { }
+
+    void setRecordHead( const std::size_t offset,
+                        const int line )
+      {
+          M_offset = offset;
+          M_line = line;
+      }
+
+private:
+
+    Index::Entry entry( const Index::Type type,
+                        const int time ) const
+      {
+          Index::Entry e;
+          e.offset_ = M_offset;
+          e.line_ = ( M_index.M_log_version >= REC_VERSION_4 ? M_line : 0 );
+          e.time_ = time;
+          e.type_ = type;
+          return e;
+      }
+
+    void doHandleLogVersion( int ver )
+      {
+          M_index.M_log_version = ver;
+          if ( ver != REC_OLD_VERSION )
+          {
+              M_offset += 4; // skip the header
+          }
+      }
+
+    int doGetLogVersion() const
+      {
+          return M_index.M_log_version;
+      }
+
+    void doHandleShowInfo( const ShowInfoT & show )
+      {
+          if ( M_index.M_shows.empty() )
+          {
+              M_index.M_data_offset = M_offset;
+          }
+          M_index.addEntry( entry( Index::SHOW, show.time_ ) );
+      }
+
+    void doHandleMsgInfo( const int time,
+                          const int,
+                          const std::string & msg )
+      {
+          if ( ! msg.compare( 0, std::strlen( "(team_graphic_" ), "(team_graphic_" )
+               && msg.length() > std::strlen( "(team_graphic_" ) )
+          {
+              Index::Entry e = entry( Index::TEAM_GRAPHIC, time );
+              e.value_[0] = ( msg[std::strlen( "(team_graphic_" )] == 'r' ? 1 : 0 );
+              M_index.addEntry( e );
+          }
+      }
+
+    void doHandlePlayMode( const int time,
+                           const PlayMode pm )
+      {
+          if ( M_playmode != pm )
+          {
+              Index::Entry e = entry( Index::PLAYMODE, time );
+              e.value_[0] = pm;
+              M_index.addEntry( e );
+          }
+          M_playmode = pm;
+      }
+
+    void doHandleTeamInfo( const int time,
+                           const TeamT & team_l,
+                           const TeamT & team_r )
+      {
+          if ( ! M_teams[0].equals( team_l )
+               || ! M_teams[1].equals( team_r ) )
+          {
+              Index::Entry e = entry( Index::TEAM, time );
+              e.value_[0] = team_l.score_;
+              e.value_[1] = team_r.score_;
+              M_index.addEntry( e );
+          }
+          M_teams[0] = team_l;
+          M_teams[1] = team_r;
+      }
+
+    void doHandleDrawClear( const int )
+      { }
+    void doHandleDrawPointInfo( const int,
+                                const PointInfoT & )
+      { }
+    void doHandleDrawCircleInfo( const int,
+                                 const CircleInfoT & )
+      { }
+    void doHandleDrawLineInfo( const int,
+                               const LineInfoT & )
+      { }
+    void doHandleServerParam( const ServerParamT & )
+      { }
+    void doHandlePlayerParam( const PlayerParamT & )
+      { }
+    void doHandlePlayerType( const PlayerTypeT & )
+      { }
+    void doHandleEOF()
+      { }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+Index::Index()
+    : M_log_version( 0 ),
+      M_data_size( 0 ),
+      M_head_hash( 0 ),
+      M_tail_hash( 0 ),
+      M_data_offset( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+Index::clear()
+{
+    M_log_version = 0;
+    M_data_size = 0;
+    M_head_hash = 0;
+    M_tail_hash = 0;
+    M_data_offset = 0;
+
+    M_shows.clear();
+    M_playmodes.clear();
+    M_teams.clear();
+    M_team_graphics.clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::string
+Index::indexFilePath( const std::string & rcg_path )
+{
+    const std::string ext = ".rcg";
+    if ( rcg_path.length() > ext.length()
+         && rcg_path.compare( rcg_path.length() - ext.length(), ext.length(), ext ) == 0 )
+    {
+        return rcg_path.substr( 0, rcg_path.length() - ext.length() ) + ".rcgidx";
+    }
+
+    return rcg_path + ".rcgidx";
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+Index::addEntry( const Entry & entry )
+{
+    switch ( entry.type_ ) {
+    case SHOW:
+        M_shows.push_back( entry );
+        break;
+    case PLAYMODE:
+        M_playmodes.push_back( entry );
+        break;
+    case TEAM:
+        M_teams.push_back( entry );
+        break;
+    case TEAM_GRAPHIC:
+        M_team_graphics.push_back( entry );
+        break;
+    default:
+        break;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+Index::build( const char * buf,
+              const std::size_t size )
+{
+    clear();
+
+    if ( ! buf )
+    {
+        return false;
+    }
+
+    M_data_size = size;
+    M_head_hash = head_hash( buf, size );
+    M_tail_hash = tail_hash( buf, size );
+
+    IndexBuilder builder( *this );
+    Parser parser( builder );
+    parser.setFieldMask( Parser::FIELD_POSITION );
+
+    // each call parses only one record in the serial mode.
+    std::size_t pos = 0;
+    std::size_t counted_pos = 0;
+    int n_line = 1;
+    while ( true )
+    {
+        if ( M_log_version >= REC_VERSION_4 )
+        {
+            n_line += std::count( buf + counted_pos, buf + pos, '\n' );
+            counted_pos = pos;
+        }
+
+        builder.setRecordHead( pos, n_line );
+        if ( ! parser.parse( buf, size, pos ) )
+        {
+            break;
+        }
+    }
+
+    if ( M_shows.empty() )
+    {
+        M_data_offset = size;
+    }
+
+    return M_log_version != 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+Index::read( const std::string & path )
+{
+    clear();
+
+    std::ifstream fin( path.c_str(), std::ios_base::in | std::ios_base::binary );
+    if ( ! fin )
+    {
+        return false;
+    }
+
+    char header[INDEX_HEADER_SIZE];
+    if ( ! fin.read( header, INDEX_HEADER_SIZE )
+         || std::memcmp( header, INDEX_MAGIC, INDEX_MAGIC_SIZE ) != 0 )
+    {
+        return false;
+    }
+
+    const char * p = header + INDEX_MAGIC_SIZE;
+    M_log_version = static_cast< int >( get_u32( p ) ); p += 4;
+    M_data_size = static_cast< std::size_t >( get_u64( p ) ); p += 8;
+    M_head_hash = get_u64( p ); p += 8;
+    M_tail_hash = get_u64( p ); p += 8;
+    M_data_offset = static_cast< std::size_t >( get_u64( p ) ); p += 8;
+    const boost::uint32_t n_entries = get_u32( p );
+
+    // the entry count must not exceed the file size.
+    const std::streampos data_pos = fin.tellg();
+    fin.seekg( 0, std::ios_base::end );
+    const std::streamoff rest = fin.tellg() - data_pos;
+    fin.seekg( data_pos );
+    if ( ! fin
+         || rest < 0
+         || static_cast< boost::uint64_t >( rest ) / INDEX_ENTRY_SIZE < n_entries )
+    {
+        clear();
+        return false;
+    }
+
+    if ( n_entries == 0 )
+    {
+        return true;
+    }
+
+    std::string data( static_cast< std::size_t >( n_entries ) * INDEX_ENTRY_SIZE, '\0' );
+    if ( ! fin.read( &data[0], data.size() ) )
+    {
+        clear();
+        return false;
+    }
+
+    p = data.data();
+    for ( boost::uint32_t i = 0; i < n_entries; ++i )
+    {
+        Entry e;
+        e.offset_ = static_cast< std::size_t >( get_u64( p ) ); p += 8;
+        e.line_ = static_cast< int >( get_u32( p ) ); p += 4;
+        e.time_ = static_cast< int >( get_u32( p ) ); p += 4;
+        e.type_ = static_cast< Type >( get_u32( p ) ); p += 4;
+        e.value_[0] = static_cast< int >( get_u32( p ) ); p += 4;
+        e.value_[1] = static_cast< int >( get_u32( p ) ); p += 4;
+
+        if ( e.type_ < SHOW || TEAM_GRAPHIC < e.type_
+             || M_data_size <= e.offset_ )
+        {
+            clear();
+            return false;
+        }
+
+        addEntry( e );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+Index::write( const std::string & path ) const
+{
+    const std::size_t n_entries = ( M_shows.size() + M_playmodes.size()
+                                    + M_teams.size() + M_team_graphics.size() );
+
+    std::string out;
+    out.reserve( INDEX_HEADER_SIZE + n_entries * INDEX_ENTRY_SIZE );
+
+    out.append( INDEX_MAGIC, INDEX_MAGIC_SIZE );
+    put_u32( out, static_cast< boost::uint32_t >( M_log_version ) );
+    put_u64( out, M_data_size );
+    put_u64( out, M_head_hash );
+    put_u64( out, M_tail_hash );
+    put_u64( out, M_data_offset );
+    put_u32( out, static_cast< boost::uint32_t >( n_entries ) );
+
+    const std::vector< Entry > * conts[] = { &M_shows, &M_playmodes, &M_teams, &M_team_graphics };
+    for ( std::size_t i = 0; i < sizeof( conts ) / sizeof( conts[0] ); ++i )
+    {
+        for ( std::vector< Entry >::const_iterator it = conts[i]->begin(), end = conts[i]->end();
+              it != end;
+              ++it )
+        {
+            put_u64( out, it->offset_ );
+            put_u32( out, static_cast< boost::uint32_t >( it->line_ ) );
+            put_u32( out, static_cast< boost::uint32_t >( it->time_ ) );
+            put_u32( out, static_cast< boost::uint32_t >( it->type_ ) );
+            put_u32( out, static_cast< boost::uint32_t >( it->value_[0] ) );
+            put_u32( out, static_cast< boost::uint32_t >( it->value_[1] ) );
+        }
+    }
+
+    std::ofstream fout( path.c_str(),
+                        std::ios_base::out
+                        | std::ios_base::trunc
+                        | std::ios_base::binary );
+    if ( ! fout
+         || ! fout.write( out.data(), out.size() ) )
+    {
+        return false;
+    }
+
+    fout.close();
+    return ! fout.fail();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+Index::isValidFor( const char * buf,
+                   const std::size_t size ) const
+{
+    return ( buf
+             && M_log_version != 0
+             && M_data_size == size
+             && M_head_hash == head_hash( buf, size )
+             && M_tail_hash == tail_hash( buf, size ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+const Index::Entry *
+Index::findShow( const int cycle ) const
+{
+    std::vector< Entry >::const_iterator it
+        = std::lower_bound( M_shows.begin(), M_shows.end(),
+                            cycle,
+                            TimeCmp() );
+    if ( it == M_shows.end() )
+    {
+        return 0;
+    }
+
+    return &(*it);
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+Index::getStateEntries( const std::size_t offset,
+                        std::vector< Entry > & entries ) const
+{
+    entries.clear();
+
+    // in the version 1 and 2, each show record contains the playmode and the team info.
+    if ( M_log_version >= REC_VERSION_3 )
+    {
+        const std::vector< Entry > * conts[] = { &M_playmodes, &M_teams };
+        for ( std::size_t i = 0; i < sizeof( conts ) / sizeof( conts[0] ); ++i )
+        {
+            std::vector< Entry >::const_iterator it
+                = std::lower_bound( conts[i]->begin(), conts[i]->end(),
+                                    offset,
+                                    OffsetCmp() );
+            if ( it != conts[i]->begin()
+                 && M_data_offset <= ( it - 1 )->offset_ )
+            {
+                entries.push_back( *( it - 1 ) );
+            }
+        }
+    }
+
+    // team graphic messages are accumulated.
+    for ( std::vector< Entry >::const_iterator it = M_team_graphics.begin(), end = M_team_graphics.end();
+          it != end && it->offset_ < offset;
+          ++it )
+    {
+        if ( M_data_offset <= it->offset_ )
+        {
+            entries.push_back( *it );
+        }
+    }
+
+    std::sort( entries.begin(), entries.end(), OffsetCmp() );
+}
+
+}
+}
@@ -0,0 +1,236 @@
+// -*-c++-*-
+
+/*!
+  \file index.h
+  \brief rcg offset index Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_INDEX_H
+#define RCSSLOGPLAYER_INDEX_H
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace rcss {
+namespace rcg {
+
+/*!
+  \class Index
+  \brief byte offset index of the records in the uncompressed rcg data.
+
+  The index records the head position of every show record, playmode changes,
+  team info changes (e.g. score changes) and team graphic messages.
+  It is saved as the sidecar file (.rcgidx) next to the rcg file,
+  and Parser::seek() can use it to jump to the show record of any cycle.
+
+  The sidecar file consists of the fixed size header and the entry array.
+  All integers are stored in little endian.
+  \verbatim
+  "RCGIDX01"
+  uint32 log version
+  uint64 size of the rcg data
+  uint64 hash of the first 4096 bytes
+  uint64 hash of the last 4096 bytes
+  uint64 offset of the first show record
+  uint32 number of entries
+  { uint64 offset, int32 line, int32 time, int32 type, int32 value[2] } * number of entries
+  \endverbatim
+*/
+class Index {
+public:
+
+    /*!
+      \enum Type
+      \brief indexed record type
+     */
+    enum Type {
+        SHOW = 0,
+        PLAYMODE = 1, //!< value_[0] is the playmode id
+        TEAM = 2, //!< value_[0] and value_[1] are the left and right scores
+        TEAM_GRAPHIC = 3 //!< value_[0] is 0 for left and 1 for right
+    };
+
+    /*!
+      \struct Entry
+      \brief position of one record
+     */
+    struct Entry {
+        std::size_t offset_; //!< byte offset of the record head
+        int line_; //!< line number of the record. 0 for the binary log.
+        int time_; //!< game time of the record
+        Type type_; //!< record type
+        int value_[2]; //!< type specific value
+
+        Entry()
+            : offset_( 0 ),
+              line_( 0 ),
+              time_( 0 ),
+              type_( SHOW )
+          {
+              value_[0] = value_[1] = 0;
+          }
+    };
+
+private:
+
+    int M_log_version;
+    std::size_t M_data_size; //!< size of the indexed data
+    boost::uint64_t M_head_hash; //!< hash value of the first bytes
+    boost::uint64_t M_tail_hash; //!< hash value of the last bytes
+    std::size_t M_data_offset; //!< offset of the first show record
+
+    std::vector< Entry > M_shows;
+    std::vector< Entry > M_playmodes;
+    std::vector< Entry > M_teams;
+    std::vector< Entry > M_team_graphics;
+
+public:
+
+    /*!
+      \brief construct an empty index
+     */
+    Index();
+
+    /*!
+      \brief clear all data
+     */
+    void clear();
+
+    /*!
+      \brief get the sidecar file path for the rcg file
+      \param rcg_path path of the rcg file
+      \return sidecar file path. ".rcg" extension is replaced with ".rcgidx".
+     */
+    static
+    std::string indexFilePath( const std::string & rcg_path );
+
+    /*!
+      \brief build the index by scanning the whole data block.
+      \param buf head of the whole rcg data (e.g. mapped file)
+      \param size byte length of the data
+      \return true if the header is successfully parsed.
+     */
+    bool build( const char * buf,
+                const std::size_t size );
+
+    /*!
+      \brief read the sidecar file.
+      \param path sidecar file path
+      \return true if successfully read.
+     */
+    bool read( const std::string & path );
+
+    /*!
+      \brief write the sidecar file.
+      \param path sidecar file path
+      \return true if successfully written.
+     */
+    bool write( const std::string & path ) const;
+
+    /*!
+      \brief check if this index was built from the given data.
+      \param buf head of the whole rcg data
+      \param size byte length of the data
+      \return true if the size and the hash values of the data are matched.
+     */
+    bool isValidFor( const char * buf,
+                     const std::size_t size ) const;
+
+    /*!
+      \brief get the log version of the indexed data
+      \return log version number. 0 if no data is indexed.
+     */
+    int logVersion() const
+      {
+          return M_log_version;
+      }
+
+    /*!
+      \brief get the offset of the first show record.
+      \return byte offset. The records before this position (e.g. parameters)
+      have to be parsed before seeking.
+     */
+    std::size_t dataOffset() const
+      {
+          return M_data_offset;
+      }
+
+    const
+    std::vector< Entry > & shows() const
+      {
+          return M_shows;
+      }
+
+    const
+    std::vector< Entry > & playModes() const
+      {
+          return M_playmodes;
+      }
+
+    const
+    std::vector< Entry > & teams() const
+      {
+          return M_teams;
+      }
+
+    const
+    std::vector< Entry > & teamGraphics() const
+      {
+          return M_team_graphics;
+      }
+
+    /*!
+      \brief find the first show record at or after the cycle.
+      \param cycle game cycle
+      \return pointer to the found entry or NULL
+     */
+    const Entry * findShow( const int cycle ) const;
+
+    /*!
+      \brief get the records that restore the playmode, team info and team graphics
+      at the specified position.
+      \param offset byte offset of the target record
+      \param entries reference to the result container. entries are sorted by offset.
+     */
+    void getStateEntries( const std::size_t offset,
+                          std::vector< Entry > & entries ) const;
+
+private:
+
+    void addEntry( const Entry & entry );
+
+    friend class IndexBuilder;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,282 @@
+// -*-c++-*-
+
+/*!
+  \file mappedfile.cpp
+  \brief read-only memory mapped file class Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "mappedfile.h"
+
+#include "gzinflate.h"
+#include "zfstream.h"
+
+#include <fstream>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H) && defined(HAVE_FCNTL_H) && defined(HAVE_UNISTD_H)
+#define RCSS_USE_MMAP
+#endif
+
+namespace {
+
+//! dummy contents used for the empty file
+const char s_empty_data[1] = { '\0' };
+
+}
+
+namespace rcss {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+MappedFile::MappedFile()
+    : M_data( 0 )
+    , M_size( 0 )
+    , M_mapped( false )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+MappedFile::MappedFile( const char * path )
+    : M_data( 0 )
+    , M_size( 0 )
+    , M_mapped( false )
+{
+    open( path );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+MappedFile::open( const char * path )
+{
+    close();
+
+#ifdef RCSS_USE_MMAP
+    int fd = ::open( path, O_RDONLY );
+    if ( fd < 0 )
+    {
+        return false;
+    }
+
+    bool ret = open( fd );
+    ::close( fd );
+    return ret;
+#else
+    // read the whole contents into the heap buffer.
+    std::ifstream fin( path, std::ios_base::in | std::ios_base::binary );
+    if ( ! fin )
+    {
+        return false;
+    }
+
+    fin.seekg( 0, std::ios_base::end );
+    std::streamoff len = fin.tellg();
+    fin.seekg( 0, std::ios_base::beg );
+    if ( len < 0 )
+    {
+        return false;
+    }
+
+    if ( len == 0 )
+    {
+        M_data = s_empty_data;
+        M_size = 0;
+        return true;
+    }
+
+    char * buf = new char[len];
+    fin.read( buf, len );
+    if ( fin.gcount() != len )
+    {
+        delete [] buf;
+        return false;
+    }
+
+    M_data = buf;
+    M_size = static_cast< std::size_t >( len );
+    return true;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+MappedFile::open( const int fd )
+{
+    close();
+
+#ifdef RCSS_USE_MMAP
+    struct stat st;
+    if ( ::fstat( fd, &st ) != 0
+         || ! S_ISREG( st.st_mode ) )
+    {
+        return false;
+    }
+
+    if ( st.st_size == 0 )
+    {
+        // mmap() does not accept the zero length.
+        M_data = s_empty_data;
+        M_size = 0;
+        return true;
+    }
+
+    void * addr = ::mmap( 0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if ( addr == MAP_FAILED )
+    {
+        return false;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    // the parser reads the data from front to back.
+    ::madvise( addr, st.st_size, MADV_SEQUENTIAL );
+#endif
+
+    M_data = static_cast< const char * >( addr );
+    M_size = static_cast< std::size_t >( st.st_size );
+    M_mapped = true;
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+MappedFile::close()
+{
+    if ( ! M_data )
+    {
+        return;
+    }
+
+    if ( M_mapped )
+    {
+#ifdef RCSS_USE_MMAP
+        ::munmap( const_cast< char * >( M_data ), M_size );
+#endif
+    }
+    else if ( ! M_inflated.empty()
+              && M_data == &M_inflated[0] )
+    {
+        std::vector< char >().swap( M_inflated );
+    }
+    else if ( M_data != s_empty_data )
+    {
+        delete [] M_data;
+    }
+
+    M_data = 0;
+    M_size = 0;
+    M_mapped = false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+MappedFile::isCompressed() const
+{
+    return zfilebuf::detect( M_data, M_size ) != zfilebuf::PLAIN;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+MappedFile::inflate( const int thread_count )
+{
+    if ( ! isCompressed() )
+    {
+        return false;
+    }
+
+    std::vector< char > buf;
+    if ( isGzipped()
+         ? ! inflate_gzip( M_data, M_size, thread_count, buf )
+         : ! zfilebuf::decompress( M_data, M_size, buf ) )
+    {
+        return false;
+    }
+
+    close();
+
+    if ( buf.empty() )
+    {
+        M_data = s_empty_data;
+        M_size = 0;
+        return true;
+    }
+
+    M_inflated.swap( buf );
+    M_data = &M_inflated[0];
+    M_size = M_inflated.size();
+    return true;
+}
+
+}
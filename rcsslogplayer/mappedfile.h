@@ -0,0 +1,165 @@
+// -*-c++-*-
+
+/*!
+  \file mappedfile.h
+  \brief read-only memory mapped file class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_MAPPEDFILE_H
+#define RCSSLOGPLAYER_MAPPEDFILE_H
+
+#include <vector>
+#include <cstddef>
+
+namespace rcss {
+
+/*!
+  \class MappedFile
+  \brief read-only view of the whole file contents.
+
+  The file is mapped into the memory by mmap() if it is available.
+  Otherwise, the contents are read into the heap buffer at once.
+  In both cases, the data can be accessed as a contiguous char array.
+  The compressed contents (gzip, zstd or lz4) can be replaced with
+  the uncompressed data by inflate().
+*/
+class MappedFile {
+private:
+    //! head of the file contents
+    const char * M_data;
+    //! length of the file contents
+    std::size_t M_size;
+    //! true if M_data is mapped by mmap(), false if M_data is allocated by new[].
+    bool M_mapped;
+    //! inflated contents. M_data points to this buffer after inflate().
+    std::vector< char > M_inflated;
+
+    //! not used
+    MappedFile( const MappedFile & );
+    //! not used
+    MappedFile & operator=( const MappedFile & );
+
+public:
+    /*!
+      \brief default constructor.
+     */
+    MappedFile();
+
+    /*!
+      \brief construct and open the file.
+      \param path file path
+     */
+    explicit
+    MappedFile( const char * path );
+
+    /*!
+      \brief destructor. release the mapped memory.
+     */
+    ~MappedFile();
+
+    /*!
+      \brief map the file.
+      \param path file path
+      \return true if the file is successfully mapped.
+
+      If other file is already opened, that file is closed at first.
+     */
+    bool open( const char * path );
+
+    /*!
+      \brief map the already opened file.
+      \param fd file descriptor. fd is not closed by this class.
+      \return true if the file is successfully mapped.
+
+      This method fails if fd is not a regular file (e.g. pipe).
+     */
+    bool open( const int fd );
+
+    /*!
+      \brief release the mapped memory.
+     */
+    void close();
+
+    /*!
+      \brief replace the compressed contents with the uncompressed data.
+      \param thread_count the number of threads used to inflate the gzip members.
+      zstd and lz4 data are always decompressed by one thread.
+      \return true if the contents are successfully inflated.
+
+      If this method fails, the original contents are kept.
+     */
+    bool inflate( const int thread_count = 1 );
+
+    /*!
+      \brief check if file is open.
+      \return true if file is opened.
+     */
+    bool is_open() const
+      {
+          return M_data != 0;
+      }
+
+    /*!
+      \brief get the head of the file contents.
+      \return const pointer to the head of the file contents.
+     */
+    const char * data() const
+      {
+          return M_data;
+      }
+
+    /*!
+      \brief get the length of the file contents.
+      \return byte length of the file
+     */
+    std::size_t size() const
+      {
+          return M_size;
+      }
+
+    /*!
+      \brief check the gzip magic number.
+      \return true if the file contents seem to be gzip compressed.
+     */
+    bool isGzipped() const
+      {
+          return ( M_size >= 2
+                   && static_cast< unsigned char >( M_data[0] ) == 0x1f
+                   && static_cast< unsigned char >( M_data[1] ) == 0x8b );
+      }
+
+    /*!
+      \brief check the magic number of the supported compression formats.
+      \return true if the file contents seem to be compressed.
+     */
+    bool isCompressed() const;
+};
+
+}
+
+#endif
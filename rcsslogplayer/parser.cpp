@@ -37,11 +37,15 @@
 #include "parser.h"
 
 #include "handler.h"
+#include "index.h"
+#include "scan_number.h"
 #include "util.h"
 
 #include <iostream>
 #include <string>
-#include <map>
+#include <vector>
+#include <algorithm>
+#include <climits>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -53,14 +57,9 @@
 #ifdef HAVE_WINDOWS_H
 #include <windows.h>
 #endif
-
-#include <boost/lexical_cast.hpp>
-
-
-typedef std::map< std::string, int * > IntMap;
-typedef std::map< std::string, double * > DoubleMap;
-typedef std::map< std::string, bool * > BoolMap;
-typedef std::map< std::string, std::string * > StringMap;
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
 
 namespace {
 
@@ -88,239 +87,1430 @@ clean_string( std::string str )
               escape_pos != std::string::npos;
               escape_pos = str.find( "\\'" ) )
         {
-            // replace "\'" with "'"
-            str.replace( escape_pos, 2, "'" );
+            // replace "\'" with "'"
+            str.replace( escape_pos, 2, "'" );
+        }
+    }
+    else if ( *str.begin() == '"' )
+    {
+        if ( *str.rbegin() == '"'  )
+        {
+            str = str.substr( 1, str.length() - 2 );
+        }
+        else
+        {
+            return str;
+        }
+
+        // replace escape character
+        for( std::string::size_type escape_pos = str.find( "\\\"" );
+             escape_pos != std::string::npos;
+             escape_pos = str.find( "\\\"" ) )
+        {
+            // replace "\"" with """
+            str.replace( escape_pos, 2, "\"" );
+        }
+    }
+
+    return str;
+}
+
+
+enum ParamType {
+    PARAM_INT,
+    PARAM_DOUBLE,
+    PARAM_BOOL,
+    PARAM_STRING
+};
+
+/*!
+  \class ParamTable
+  \brief sorted table of the parameter name and the member pointer of T.
+
+  The table is built only once for each parameter type, and the parameter name
+  is looked up by binary search without constructing std::string.
+*/
+template < typename T >
+class ParamTable {
+public:
+
+    struct Entry {
+        const char * name_;
+        ParamType type_;
+        int T::* int_;
+        double T::* double_;
+        bool T::* bool_;
+        std::string T::* string_;
+    };
+
+private:
+
+    std::vector< Entry > M_entries;
+
+    struct NameLess {
+        bool operator()( const Entry & lhs,
+                         const Entry & rhs ) const
+          {
+              return std::strcmp( lhs.name_, rhs.name_ ) < 0;
+          }
+    };
+
+public:
+
+    bool empty() const
+      {
+          return M_entries.empty();
+      }
+
+    void add( const char * name,
+              int T::* member )
+      {
+          Entry e = { name, PARAM_INT, member, 0, 0, 0 };
+          M_entries.push_back( e );
+      }
+
+    void add( const char * name,
+              double T::* member )
+      {
+          Entry e = { name, PARAM_DOUBLE, 0, member, 0, 0 };
+          M_entries.push_back( e );
+      }
+
+    void add( const char * name,
+              bool T::* member )
+      {
+          Entry e = { name, PARAM_BOOL, 0, 0, member, 0 };
+          M_entries.push_back( e );
+      }
+
+    void add( const char * name,
+              std::string T::* member )
+      {
+          Entry e = { name, PARAM_STRING, 0, 0, 0, member };
+          M_entries.push_back( e );
+      }
+
+    /*!
+      \brief sort the table. this method has to be called after all entries are added.
+     */
+    void sort()
+      {
+          std::sort( M_entries.begin(), M_entries.end(), NameLess() );
+      }
+
+    /*!
+      \brief find the entry.
+      \param name head of the parameter name. the name need not be null terminated.
+      \param len length of the parameter name
+      \return pointer to the found entry or NULL
+     */
+    const Entry * find( const char * name,
+                        const std::size_t len ) const
+      {
+          std::size_t first = 0;
+          std::size_t count = M_entries.size();
+          while ( count > 0 )
+          {
+              const std::size_t step = count / 2;
+              const Entry & e = M_entries[first + step];
+
+              int cmp = std::strncmp( e.name_, name, len );
+              if ( cmp == 0 && e.name_[len] != '\0' )
+              {
+                  cmp = 1; // e.name_ is longer than name
+              }
+
+              if ( cmp == 0 )
+              {
+                  return &e;
+              }
+
+              if ( cmp < 0 )
+              {
+                  first += step + 1;
+                  count -= step + 1;
+              }
+              else
+              {
+                  count = step;
+              }
+          }
+
+          return 0;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief convert the string to integer without exception.
+  \param first head of the value string
+  \param last end of the value string
+  \param value reference to the result variable
+  \return true if the whole string is successfully converted.
+ */
+bool
+to_int( const char * first,
+        const char * last,
+        int & value )
+{
+    char * end = 0;
+    long v = std::strtol( first, &end, 10 );
+    if ( first == last
+         || end != last
+         || v < INT_MIN || INT_MAX < v )
+    {
+        return false;
+    }
+
+    value = static_cast< int >( v );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief convert the string to floating point number without exception.
+  \param first head of the value string
+  \param last end of the value string
+  \param value reference to the result variable
+  \return true if the whole string is successfully converted.
+ */
+bool
+to_double( const char * first,
+           const char * last,
+           double & value )
+{
+    char * end = 0;
+    double v = std::strtod( first, &end );
+    if ( first == last
+         || end != last )
+    {
+        return false;
+    }
+
+    value = v;
+    return true;
+}
+
+
+template < typename T >
+bool
+parse_param_line( const int n_line,
+                  const std::string & line,
+                  const ParamTable< T > & table,
+                  T & param,
+                  rcss::rcg::Diagnostics & diagnostics )
+{
+    int n_read = 0;
+
+    char message_name[32];
+    if ( std::sscanf( line.c_str(), " ( %31s %n ", message_name, &n_read ) != 1 )
+    {
+        diagnostics.report( rcss::rcg::Diagnostics::PARAM_ERROR, n_line,
+                            "failed to parse the message id." );
+        return false;
+    }
+
+    const char * const buf = line.c_str();
+
+    for ( std::string::size_type pos = line.find_first_of( '(', n_read );
+          pos != std::string::npos;
+          pos = line.find_first_of( '(', pos ) )
+    {
+        std::string::size_type end_pos = line.find_first_of( ' ', pos );
+        if ( end_pos == std::string::npos )
+        {
+            diagnostics.report( rcss::rcg::Diagnostics::PARAM_ERROR, n_line,
+                                "failed to find parameter name." );
+            return false;
+        }
+        pos += 1;
+
+        const char * const name = buf + pos;
+        const std::size_t name_len = end_pos - pos;
+
+        pos = end_pos;
+
+        // search end paren or double quatation
+        end_pos = line.find_first_of( ")\"", end_pos ); //"
+        if ( end_pos == std::string::npos )
+        {
+            diagnostics.report( rcss::rcg::Diagnostics::PARAM_ERROR, n_line,
+                                "failed to parse parameter value for",
+                                name, name_len );
+            return false;
+        }
+
+        // found quated value
+        if ( line[end_pos] == '\"' )
+        {
+            pos = end_pos;
+            end_pos = line.find_first_of( '\"', end_pos + 1 ); //"
+            if ( end_pos == std::string::npos )
+            {
+                diagnostics.report( rcss::rcg::Diagnostics::PARAM_ERROR, n_line,
+                                    "failed to parse the quated value for",
+                                    name, name_len );
+                return false;
+            }
+            end_pos += 1; // skip double quatation
+        }
+        else
+        {
+            pos += 1; // skip white space
+        }
+
+        const char * const value = buf + pos;
+        const char * const value_end = buf + end_pos;
+        pos = end_pos;
+
+        //
+        // check parameter table
+        //
+        const typename ParamTable< T >::Entry * e = table.find( name, name_len );
+        if ( ! e )
+        {
+            diagnostics.report( rcss::rcg::Diagnostics::PARAM_WARNING, n_line,
+                                "unsupported parameter",
+                                name, value_end - name );
+            continue;
+        }
+
+        bool success = true;
+        switch ( e->type_ ) {
+        case PARAM_INT:
+            success = to_int( value, value_end, param.*(e->int_) );
+            break;
+        case PARAM_DOUBLE:
+            success = to_double( value, value_end, param.*(e->double_) );
+            break;
+        case PARAM_BOOL:
+            {
+                const std::string::size_type len = value_end - value;
+                param.*(e->bool_) = !( ( len == 1 && std::strncmp( value, "0", 1 ) == 0 )
+                                       || ( len == 5 && std::strncmp( value, "false", 5 ) == 0 )
+                                       || ( len == 3 && std::strncmp( value, "off", 3 ) == 0 ) );
+            }
+            break;
+        case PARAM_STRING:
+            param.*(e->string_) = clean_string( std::string( value, value_end ) );
+            break;
+        default:
+            break;
+        }
+
+        if ( ! success )
+        {
+            diagnostics.report( rcss::rcg::Diagnostics::PARAM_ERROR, n_line,
+                                "illegal parameter value.",
+                                name, value_end - name );
+        }
+    }
+
+    return true;
+}
+
+
+/*!
+  \brief get the log version from the header bytes
+  \param buf head of the data. at least, 4 bytes are required.
+  \return log version number.
+  REC_OLD_VERSION is returned if no header. 0 is returned if illegal header.
+ */
+int
+header_version( const char * buf )
+{
+    if ( buf[0] == 'U'
+         && buf[1] == 'L'
+         && buf[2] == 'G' )
+    {
+        int ver = static_cast< int >( buf[3] );
+        if ( ver != rcss::rcg::REC_VERSION_2
+             && ver != rcss::rcg::REC_VERSION_3 )
+        {
+            ver -= static_cast< int >( '0' );
+            if ( ver != rcss::rcg::REC_VERSION_4
+                 && ver != rcss::rcg::REC_VERSION_5 )
+            {
+                return 0;
+            }
+        }
+
+        return ver;
+    }
+
+    return rcss::rcg::REC_OLD_VERSION;
+}
+
+
+/*!
+  \class MemoryBuf
+  \brief read only stream buffer that refers the contiguous memory block.
+  This class is used to parse the binary format log in the mapped file.
+ */
+class MemoryBuf
+    : public std::streambuf {
+public:
+    MemoryBuf( const char * buf,
+               const std::size_t size,
+               const std::size_t pos )
+      {
+          char * b = const_cast< char * >( buf );
+          this->setg( b, b + pos, b + size );
+      }
+
+    std::size_t position() const
+      {
+          return this->gptr() - this->eback();
+      }
+
+protected:
+
+    virtual
+    std::streampos seekoff( std::streamoff off,
+                            std::ios_base::seekdir way,
+                            std::ios_base::openmode mode )
+      {
+          if ( ! ( mode & std::ios_base::in ) )
+          {
+              return -1;
+          }
+
+          std::streamoff pos = off;
+          if ( way == std::ios_base::cur )
+          {
+              pos += this->gptr() - this->eback();
+          }
+          else if ( way == std::ios_base::end )
+          {
+              pos += this->egptr() - this->eback();
+          }
+
+          if ( pos < 0
+               || this->egptr() - this->eback() < pos )
+          {
+              return -1;
+          }
+
+          this->setg( this->eback(), this->eback() + pos, this->egptr() );
+          return pos;
+      }
+
+    virtual
+    std::streampos seekpos( std::streampos pos,
+                            std::ios_base::openmode mode )
+      {
+          return seekoff( std::streamoff( pos ), std::ios_base::beg, mode );
+      }
+};
+
+}
+
+
+namespace rcss {
+namespace rcg {
+
+/*!
+  \class ChunkHandler
+  \brief records the data parsed from a chunk of text lines.
+
+  Parser threads use this handler instead of the user's handler.
+  Recorded data are replayed to the user's handler in the recorded order.
+*/
+class ChunkHandler
+    : public Handler {
+public:
+
+    enum Type {
+        SHOW,
+        MSG,
+        PLAYMODE,
+        TEAM,
+        DRAW_CLEAR,
+        DRAW_POINT,
+        DRAW_CIRCLE,
+        DRAW_LINE,
+        LINE
+    };
+
+    //! recorded item. index_ points to the element of the container for each type.
+    struct Record {
+        Type type_;
+        int time_;
+        std::size_t index_;
+
+        Record( const Type type,
+                const int time,
+                const std::size_t index )
+            : type_( type ),
+              time_( time ),
+              index_( index )
+          { }
+    };
+
+    //! raw line that has to be parsed in the file order (e.g. parameter lines).
+    struct Line {
+        int n_line_;
+        const char * first_;
+        const char * last_;
+
+        Line( const int n_line,
+              const char * first,
+              const char * last )
+            : n_line_( n_line ),
+              first_( first ),
+              last_( last )
+          { }
+    };
+
+    int M_version;
+
+    std::vector< Record > M_records;
+    std::vector< ShowInfoT > M_shows;
+    std::vector< std::pair< int, std::string > > M_msgs;
+    std::vector< std::pair< TeamT, TeamT > > M_teams;
+    std::vector< PointInfoT > M_points;
+    std::vector< CircleInfoT > M_circles;
+    std::vector< LineInfoT > M_lines;
+    std::vector< Line > M_raw_lines;
+
+    explicit
+    ChunkHandler( const int version )
+        : M_version( version )
+      { }
+
+    void addLine( const int n_line,
+                  const char * first,
+                  const char * last )
+      {
+          M_records.push_back( Record( LINE, 0, M_raw_lines.size() ) );
+          M_raw_lines.push_back( Line( n_line, first, last ) );
+      }
+
+protected:
+
+    void doHandleLogVersion( int ver )
+      {
+          M_version = ver;
+      }
+
+    int doGetLogVersion() const
+      {
+          return M_version;
+      }
+
+    void doHandleShowInfo( const ShowInfoT & show )
+      {
+          M_records.push_back( Record( SHOW, show.time_, M_shows.size() ) );
+          M_shows.push_back( show );
+      }
+
+    void doHandleMsgInfo( const int time,
+                          const int board,
+                          const std::string & msg )
+      {
+          M_records.push_back( Record( MSG, time, M_msgs.size() ) );
+          M_msgs.push_back( std::make_pair( board, msg ) );
+      }
+
+    void doHandlePlayMode( const int time,
+                           const PlayMode pm )
+      {
+          M_records.push_back( Record( PLAYMODE, time, static_cast< std::size_t >( pm ) ) );
+      }
+
+    void doHandleTeamInfo( const int time,
+                           const TeamT & team_l,
+                           const TeamT & team_r )
+      {
+          M_records.push_back( Record( TEAM, time, M_teams.size() ) );
+          M_teams.push_back( std::make_pair( team_l, team_r ) );
+      }
+
+    void doHandleDrawClear( const int time )
+      {
+          M_records.push_back( Record( DRAW_CLEAR, time, 0 ) );
+      }
+
+    void doHandleDrawPointInfo( const int time,
+                                const PointInfoT & p )
+      {
+          M_records.push_back( Record( DRAW_POINT, time, M_points.size() ) );
+          M_points.push_back( p );
+      }
+
+    void doHandleDrawCircleInfo( const int time,
+                                 const CircleInfoT & c )
+      {
+          M_records.push_back( Record( DRAW_CIRCLE, time, M_circles.size() ) );
+          M_circles.push_back( c );
+      }
+
+    void doHandleDrawLineInfo( const int time,
+                               const LineInfoT & l )
+      {
+          M_records.push_back( Record( DRAW_LINE, time, M_lines.size() ) );
+          M_lines.push_back( l );
+      }
+
+    // parameter lines are never parsed by parser threads.
+    void doHandleServerParam( const ServerParamT & )
+      { }
+    void doHandlePlayerParam( const PlayerParamT & )
+      { }
+    void doHandlePlayerType( const PlayerTypeT & )
+      { }
+    void doHandleEOF()
+      { }
+};
+
+namespace {
+
+//! approximate byte length of the chunk parsed by one thread
+const std::size_t PARALLEL_CHUNK_SIZE = 1024 * 1024;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief reset the player fields that may be omitted in the show data.
+
+  All other fields are overwritten by the show parsers, so the reused
+  ShowInfoT buffer does not have to be constructed for each frame.
+*/
+inline
+void
+reset_optional_fields( PlayerT & p )
+{
+    p.point_x_ = SHOWINFO_SCALE2F;
+    p.point_y_ = SHOWINFO_SCALE2F;
+    p.stamina_capacity_ = -1.0f;
+    p.focus_side_ = 'n';
+    p.focus_unum_ = 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief reset the players that did not appear in the show line.
+  \param found bit flags of the found players. bit i corresponds to player_[i].
+*/
+inline
+void
+reset_missing_players( const UInt32 found,
+                       ShowInfoT & show )
+{
+    for ( int i = 0; i < MAX_PLAYER*2; ++i )
+    {
+        if ( ! ( found & ( 1u << i ) ) )
+        {
+            show.player_[i] = PlayerT();
+        }
+    }
+}
+
+/*!
+  \struct ParseTask
+  \brief a chunk of text lines assigned to one parser thread.
+*/
+struct ParseTask {
+    const char * first_; //!< head of the chunk
+    const char * last_; //!< end of the chunk. the chunk always ends after the new line character or at the end of the data.
+    int first_line_; //!< the line number just before this chunk
+    int n_lines_; //!< the number of lines in this chunk
+    bool safe_mode_;
+    int field_mask_;
+    ChunkHandler handler_;
+    Diagnostics diagnostics_; //!< settings for the chunk parser, and its results after parsing
+
+    ParseTask( const int version,
+               const bool safe_mode,
+               const int field_mask )
+        : first_( 0 ),
+          last_( 0 ),
+          first_line_( 0 ),
+          n_lines_( 0 ),
+          safe_mode_( safe_mode ),
+          field_mask_( field_mask ),
+          handler_( version )
+      { }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the line can be parsed independently of other lines.
+
+  Parameter lines change the global default values (e.g. PlayerTypeT),
+  so they are parsed in the file order by the caller's parser.
+*/
+inline
+bool
+is_independent_line( const char * first,
+                     const char * last )
+{
+    const std::size_t len = last - first;
+    return ( ( len >= 6 && std::strncmp( first, "(show ", 6 ) == 0 )
+             || ( len >= 6 && std::strncmp( first, "(draw ", 6 ) == 0 )
+             || ( len >= 5 && std::strncmp( first, "(msg ", 5 ) == 0 )
+             || ( len >= 10 && std::strncmp( first, "(playmode ", 10 ) == 0 )
+             || ( len >= 6 && std::strncmp( first, "(team ", 6 ) == 0 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the time of the show line.
+  \param buf head of the whole data block
+  \param size byte length of the whole data block
+  \param pos head of the line
+  \return show time. -1 if the line is not the show line.
+*/
+inline
+int
+show_line_time( const char * buf,
+                const std::size_t size,
+                std::size_t pos )
+{
+    if ( size < pos + 6
+         || std::memcmp( buf + pos, "(show ", 6 ) != 0 )
+    {
+        return -1;
+    }
+
+    pos += 6;
+
+    int time = -1;
+    while ( pos < size
+            && '0' <= buf[pos] && buf[pos] <= '9' )
+    {
+        time = ( time < 0 ? 0 : time * 10 ) + ( buf[pos] - '0' );
+        ++pos;
+    }
+
+    return time;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check the playmode and team info written in the show line.
+  \param buf head of the whole data block
+  \param size byte length of the whole data block
+  \param pos head of the line
+  \return bit flags. 1: "(pm ...)" is found, 2: "(tm ...)" is found.
+  0 if the line is not the show line or has neither of them.
+*/
+inline
+int
+show_line_state( const char * buf,
+                 const std::size_t size,
+                 std::size_t pos )
+{
+    if ( show_line_time( buf, size, pos ) < 0 )
+    {
+        return 0;
+    }
+
+    pos += 6;
+    while ( pos < size
+            && ( ( '0' <= buf[pos] && buf[pos] <= '9' ) || buf[pos] == ' ' ) )
+    {
+        ++pos;
+    }
+
+    int flags = 0;
+    if ( pos + 4 <= size
+         && std::memcmp( buf + pos, "(pm ", 4 ) == 0 )
+    {
+        flags |= 1;
+
+        while ( pos < size
+                && buf[pos] != ')'
+                && buf[pos] != '\n' )
+        {
+            ++pos;
+        }
+        ++pos;
+        while ( pos < size
+                && buf[pos] == ' ' )
+        {
+            ++pos;
+        }
+    }
+
+    if ( pos + 4 <= size
+         && std::memcmp( buf + pos, "(tm ", 4 ) == 0 )
+    {
+        flags |= 2;
+    }
+
+    return flags;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief find the first show line after the specified position.
+  \param buf head of the whole data block
+  \param size byte length of the whole data block
+  \param pos search start position. if this is not the head of line,
+  the search starts from the next line.
+  \return head of the found show line. size if not found.
+*/
+std::size_t
+next_show_line( const char * buf,
+                const std::size_t size,
+                std::size_t pos )
+{
+    if ( pos > 0
+         && pos < size
+         && buf[pos - 1] != '\n' )
+    {
+        const char * nl = static_cast< const char * >( std::memchr( buf + pos, '\n', size - pos ) );
+        if ( ! nl )
+        {
+            return size;
+        }
+        pos = nl - buf + 1;
+    }
+
+    while ( pos < size )
+    {
+        if ( show_line_time( buf, size, pos ) >= 0 )
+        {
+            return pos;
+        }
+
+        const char * nl = static_cast< const char * >( std::memchr( buf + pos, '\n', size - pos ) );
+        if ( ! nl )
+        {
+            break;
+        }
+        pos = nl - buf + 1;
+    }
+
+    return size;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief find the first show line whose time is not less than cycle by bisection.
+  \param buf head of the whole data block
+  \param size byte length of the whole data block
+  \param first head of the first show line in the search range
+  \param cycle target cycle
+  \return head of the found show line. size if not found.
+
+  The show times in the text log must be monotonic.
+*/
+std::size_t
+lower_show_line( const char * buf,
+                 const std::size_t size,
+                 const std::size_t first,
+                 const int cycle )
+{
+    if ( size <= first
+         || show_line_time( buf, size, first ) >= cycle )
+    {
+        return first;
+    }
+
+    // invariant:
+    //   the time of the show line at lo is less than cycle.
+    //   all show lines at or after hi have the time not less than cycle.
+    std::size_t lo = first;
+    std::size_t hi = size;
+    while ( hi - lo > 1 )
+    {
+        const std::size_t mid = lo + ( hi - lo ) / 2;
+        const std::size_t s = next_show_line( buf, size, mid );
+        if ( s >= hi
+             || show_line_time( buf, size, s ) >= cycle )
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = s;
+        }
+    }
+
+    return next_show_line( buf, size, lo + 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief thread function to count the lines in the chunk.
+*/
+void *
+count_lines( void * arg )
+{
+    ParseTask * task = static_cast< ParseTask * >( arg );
+
+    int count = 0;
+    const char * p = task->first_;
+    while ( p < task->last_ )
+    {
+        p = static_cast< const char * >( std::memchr( p, '\n', task->last_ - p ) );
+        ++count;
+        if ( ! p )
+        {
+            break; // the last line without the new line character
+        }
+        ++p;
+    }
+
+    task->n_lines_ = count;
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief thread function to parse the lines in the chunk.
+*/
+void *
+parse_lines( void * arg )
+{
+    ParseTask * task = static_cast< ParseTask * >( arg );
+
+    Parser parser( task->handler_ );
+    parser.setSafeMode( task->safe_mode_ );
+    parser.setFieldMask( task->field_mask_ );
+    parser.diagnostics() = task->diagnostics_;
+
+    std::string line;
+    int n_line = task->first_line_;
+
+    const char * first = task->first_;
+    while ( first < task->last_ )
+    {
+        const char * last = static_cast< const char * >( std::memchr( first, '\n', task->last_ - first ) );
+        const char * next = last + 1;
+        if ( ! last )
+        {
+            last = task->last_;
+            next = last;
+        }
+
+        ++n_line;
+        if ( first != last )
+        {
+            if ( is_independent_line( first, last ) )
+            {
+                line.assign( first, last );
+                parser.parseLine( n_line, line );
+            }
+            else
+            {
+                task->handler_.addLine( n_line, first, last );
+            }
+        }
+
+        first = next;
+    }
+
+    task->diagnostics_ = parser.diagnostics();
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief execute the function for all tasks concurrently.
+
+  The first task is executed in the caller's thread.
+  If a thread cannot be created, its task is also executed in the caller's thread.
+*/
+void
+run_tasks( void * (*func)( void * ),
+           std::vector< ParseTask > & tasks )
+{
+#ifdef HAVE_LIBPTHREAD
+    std::vector< pthread_t > threads( tasks.size() );
+    std::vector< char > created( tasks.size(), 0 );
+
+    for ( std::size_t i = 1; i < tasks.size(); ++i )
+    {
+        if ( pthread_create( &threads[i], 0, func, &tasks[i] ) == 0 )
+        {
+            created[i] = 1;
+        }
+    }
+
+    if ( ! tasks.empty() )
+    {
+        func( &tasks[0] );
+    }
+
+    for ( std::size_t i = 1; i < tasks.size(); ++i )
+    {
+        if ( created[i] )
+        {
+            pthread_join( threads[i], 0 );
+        }
+        else
+        {
+            func( &tasks[i] );
+        }
+    }
+#else
+    for ( std::size_t i = 0; i < tasks.size(); ++i )
+    {
+        func( &tasks[i] );
+    }
+#endif
+}
+
+}
+
+const std::size_t Parser::DEFAULT_SHOW_BLOCK_SIZE;
+
+Parser::Parser( Handler & handler )
+    : M_handler( handler )
+    , M_safe_mode( false )
+    , M_field_mask( FIELD_ALL )
+    , M_thread_count( 1 )
+    , M_header_parsed( false )
+    , M_line_count( 0 )
+    , M_time( 0 )
+    , M_log_version( 0 )
+    , M_stamina_capacity( CAPACITY_UNKNOWN )
+    , M_show_kernel( 0 )
+    , M_show_count( 0 )
+{
+    selectShowKernel();
+}
+
+
+Parser::~Parser()
+{
+    flush();
+}
+
+
+void
+Parser::setShowBlockSize( const std::size_t size )
+{
+    flush();
+
+    if ( size < 2 )
+    {
+        std::vector< ShowInfoT >().swap( M_show_block );
+    }
+    else
+    {
+        M_show_block.resize( size );
+    }
+}
+
+
+void
+Parser::flush()
+{
+    if ( M_show_count > 0 )
+    {
+        const std::size_t n = M_show_count;
+        M_show_count = 0;
+        M_handler.handleShowBlock( &M_show_block[0], n );
+    }
+}
+
+
+ShowInfoT &
+Parser::showSlot()
+{
+    return ( M_show_block.empty()
+             ? M_show_buf
+             : M_show_block[M_show_count] );
+}
+
+
+void
+Parser::commitShow()
+{
+    if ( M_show_block.empty() )
+    {
+        M_handler.handleShowInfo( M_show_buf );
+    }
+    else if ( ++M_show_count == M_show_block.size() )
+    {
+        flush();
+    }
+}
+
+
+void
+Parser::handleShowInfo( const ShowInfoT & show )
+{
+    if ( M_show_block.empty() )
+    {
+        M_handler.handleShowInfo( show );
+        return;
+    }
+
+    M_show_block[M_show_count] = show;
+    if ( ++M_show_count == M_show_block.size() )
+    {
+        flush();
+    }
+}
+
+
+bool
+Parser::parse( std::istream & is )
+{
+    // check stream status
+    if ( ! is.good() )
+    {
+        return strmErr( is );
+    }
+
+    // parse header
+
+    if ( ! M_header_parsed )
+    {
+        M_header_parsed = true;
+        if ( ! parseHeader( is ) )
+        {
+            return false;
+        }
+    }
+
+    // parse data
+
+    const bool result = ( M_log_version >= REC_VERSION_4
+                          ? parseLine( is )
+                          : parseData( is ) );
+    if ( ! result )
+    {
+        flush();
+    }
+
+    return result;
+}
+
+
+bool
+Parser::parse( const char * buf,
+               const std::size_t size,
+               std::size_t & pos )
+{
+    if ( ! buf )
+    {
+        return false;
+    }
+
+    // parse header
+
+    if ( ! M_header_parsed )
+    {
+        M_header_parsed = true;
+        if ( ! parseHeader( buf, size, pos ) )
+        {
+            return false;
+        }
+    }
+
+    // check the end of data
+
+    if ( size <= pos )
+    {
+        handler().handleEOF();
+        return false;
+    }
+
+    // parse data
+
+    const bool result = ( M_log_version >= REC_VERSION_4
+                          ? ( M_thread_count > 1
+                              ? parseLines( buf, size, pos )
+                              : parseLine( buf, size, pos ) )
+                          : parseData( buf, size, pos ) );
+    if ( ! result )
+    {
+        flush();
+    }
+
+    return result;
+}
+
+
+bool
+Parser::seek( const Index & index,
+              const int cycle,
+              const char * buf,
+              const std::size_t size,
+              std::size_t & pos )
+{
+    const Index::Entry * target = index.findShow( cycle );
+    if ( ! buf
+         || ! target
+         || size <= target->offset_ )
+    {
+        return false;
+    }
+
+    if ( ! M_header_parsed )
+    {
+        M_header_parsed = true;
+        pos = 0;
+        if ( ! parseHeader( buf, size, pos ) )
+        {
+            return false;
+        }
+    }
+
+    const bool text = ( M_log_version >= REC_VERSION_4 );
+
+    // parameters and other leading records are parsed in the serial mode.
+    while ( pos < index.dataOffset() )
+    {
+        if ( ! ( text
+                 ? parseLine( buf, size, pos )
+                 : parseData( buf, size, pos ) ) )
+        {
+            return false;
         }
     }
-    else if ( *str.begin() == '"' )
+
+    std::vector< Index::Entry > state;
+    index.getStateEntries( target->offset_, state );
+
+    for ( std::vector< Index::Entry >::const_iterator it = state.begin(), end = state.end();
+          it != end;
+          ++it )
     {
-        if ( *str.rbegin() == '"'  )
+        std::size_t record_pos = it->offset_;
+        M_line_count = it->line_ - 1;
+        M_time = it->time_; // binary records refer the last time
+
+        if ( it->type_ == Index::PLAYMODE )
         {
-            str = str.substr( 1, str.length() - 2 );
+            // the playmode id is in the index.
+            handler().handlePlayMode( it->time_, static_cast< PlayMode >( it->value_[0] ) );
         }
-        else
+        else if ( text
+                  && show_line_time( buf, size, record_pos ) >= 0 )
         {
-            return str;
+            parseShowState( it->line_, buf, size, record_pos );
         }
-
-        // replace escape character
-        for( std::string::size_type escape_pos = str.find( "\\\"" );
-             escape_pos != std::string::npos;
-             escape_pos = str.find( "\\\"" ) )
+        else if ( text )
         {
-            // replace "\"" with """
-            str.replace( escape_pos, 2, "\"" );
+            parseLine( buf, size, record_pos );
+        }
+        else
+        {
+            parseData( buf, size, record_pos );
         }
     }
 
-    return str;
+    M_line_count = target->line_ - 1;
+    pos = target->offset_;
+    return true;
 }
 
 
 bool
-parse_param_line( const int n_line,
-                  const std::string & line,
-                  IntMap & int_map,
-                  DoubleMap & double_map,
-                  BoolMap & bool_map,
-                  StringMap & string_map )
+Parser::parseRange( const int begin_cycle,
+                    const int end_cycle,
+                    const char * buf,
+                    const std::size_t size,
+                    std::size_t & pos )
 {
-    int n_read = 0;
-
-    char message_name[32];
-    if ( std::sscanf( line.c_str(), " ( %31s %n ", message_name, &n_read ) != 1 )
+    if ( ! buf )
     {
-        std::cerr << ":error: failed to the parse message id."
-                  << std::endl;
         return false;
     }
 
-    for ( std::string::size_type pos = line.find_first_of( '(', n_read );
-          pos != std::string::npos;
-          pos = line.find_first_of( '(', pos ) )
+    if ( ! M_header_parsed )
     {
-        std::string::size_type end_pos = line.find_first_of( ' ', pos );
-        if ( end_pos == std::string::npos )
+        M_header_parsed = true;
+        pos = 0;
+        if ( ! parseHeader( buf, size, pos ) )
         {
-            std::cerr << n_line << ":error: failed to find parameter name."
-                      << std::endl;
             return false;
         }
-        pos += 1;
+    }
 
-        const std::string name_str( line, pos, end_pos - pos );
+    if ( M_log_version < REC_VERSION_4 )
+    {
+        return false;
+    }
 
-        pos = end_pos;
+    // parameters and other leading records are parsed in the serial mode.
+    while ( pos < size
+            && show_line_time( buf, size, pos ) < 0 )
+    {
+        parseLine( buf, size, pos );
+    }
 
-        // search end paren or double quatation
-        end_pos = line.find_first_of( ")\"", end_pos ); //"
-        if ( end_pos == std::string::npos )
-        {
-            std::cerr << n_line << ":error: failed to parse parameter value for ["
-                      << name_str << "] "
-                      << std::endl;
-            return false;
-        }
+    const std::size_t first_show = pos;
+    const std::size_t first = ( begin_cycle < 0
+                                ? first_show
+                                : lower_show_line( buf, size, first_show, begin_cycle ) );
+    const std::size_t last = ( end_cycle < 0
+                               ? size
+                               : lower_show_line( buf, size, first, end_cycle + 1 ) );
 
-        // found quated value
-        if ( line[end_pos] == '\"' )
-        {
-            pos = end_pos;
-            end_pos = line.find_first_of( '\"', end_pos + 1 ); //"
-            if ( end_pos == std::string::npos )
-            {
-                std::cerr << n_line << ":error: ailed to parse the quated value for ["
-                          << name_str << "] "
-                          << std::endl;
-                return false;
-            }
-            end_pos += 1; // skip double quatation
-        }
-        else
+    //
+    // count the skipped lines for the error messages
+    //
+
+    int first_line = M_line_count;
+    for ( const char * p = buf + first_show, * const end = buf + first; p < end; ++first_line )
+    {
+        p = static_cast< const char * >( std::memchr( p, '\n', end - p ) );
+        if ( ! p )
         {
-            pos += 1; // skip white space
+            break;
         }
+        ++p;
+    }
 
-        std::string value_str( line, pos, end_pos - pos );
-        pos = end_pos;
-
+    //
+    // find the last playmode and team lines before the range by the backward scan.
+    //
 
-        //
-        // check parameter maps
-        //
-        try
+    std::size_t state_pos[2] = { size, size };
+    int state_line[2] = { 0, 0 };
+    {
+        int n_line = first_line;
+        std::size_t line_end = first;
+        while ( first_show < line_end
+                && ( state_pos[0] == size || state_pos[1] == size ) )
         {
-            IntMap::iterator int_it = int_map.find( name_str );
-            if ( int_it != int_map.end() )
+            std::size_t head = line_end - 1;
+            while ( first_show < head
+                    && buf[head - 1] != '\n' )
             {
-                *(int_it->second) = boost::lexical_cast< int >( value_str );
-                continue;
+                --head;
             }
 
-            DoubleMap::iterator double_it = double_map.find( name_str );
-            if ( double_it != double_map.end() )
+            const std::size_t len = line_end - head;
+            const int inline_state = show_line_state( buf, line_end, head );
+            if ( state_pos[0] == size
+                 && ( ( inline_state & 1 )
+                      || ( len >= 10
+                           && std::memcmp( buf + head, "(playmode ", 10 ) == 0 ) ) )
             {
-                *(double_it->second) = boost::lexical_cast< double >( value_str );
-                continue;
+                state_pos[0] = head;
+                state_line[0] = n_line;
             }
-
-            BoolMap::iterator bool_it = bool_map.find( name_str );
-            if ( bool_it != bool_map.end() )
+            if ( state_pos[1] == size
+                 && ( ( inline_state & 2 )
+                      || ( len >= 6
+                           && std::memcmp( buf + head, "(team ", 6 ) == 0 ) ) )
             {
-                *(bool_it->second) = !( value_str == "0"
-                                        || value_str == "false"
-                                        || value_str == "off" );
-                continue;
+                state_pos[1] = head;
+                state_line[1] = n_line;
             }
 
-            StringMap::iterator string_it = string_map.find( name_str );
-            if ( string_it != string_map.end() )
+            line_end = head;
+            --n_line;
+        }
+    }
+
+    // the state records are passed to the handler in the file order.
+    // a show line that has both of them is parsed once.
+    const int order = ( state_pos[0] < state_pos[1] ? 0 : 1 );
+    for ( int n = 0; n < 2; ++n )
+    {
+        const int i = ( n == 0 ? order : 1 - order );
+        if ( state_pos[i] < size
+             && ( n == 0 || state_pos[i] != state_pos[1 - i] ) )
+        {
+            std::size_t record_pos = state_pos[i];
+            M_line_count = state_line[i] - 1;
+            if ( show_line_time( buf, size, record_pos ) >= 0 )
+            {
+                parseShowState( state_line[i], buf, size, record_pos );
+            }
+            else
             {
-                *(string_it->second) = clean_string( value_str );
-                continue;
+                parseLine( buf, size, record_pos );
             }
+        }
+    }
 
+    //
+    // parse the records in the range
+    //
 
-            std::cerr << n_line << ": warning: " << message_name
-                      << " unsupported parameter=(" << name_str
-                      << ' ' << value_str << ")"
-                      << std::endl;
+    M_line_count = first_line;
+    pos = first;
+    while ( pos < last )
+    {
+        if ( M_thread_count > 1 )
+        {
+            parseLines( buf, last, pos );
         }
-        catch ( boost::bad_lexical_cast & e )
+        else
         {
-            std::cerr << e.what() << '\n'
-                      << " param_name=" << name_str
-                      << " value=" << value_str
-                      << std::endl;
+            parseLine( buf, last, pos );
         }
     }
 
-    return true;
-}
-
-}
-
-
-namespace rcss {
-namespace rcg {
+    flush();
 
-Parser::Parser( Handler & handler )
-    : M_handler( handler )
-    , M_safe_mode( false )
-    , M_header_parsed( false )
-    , M_line_count( 0 )
-    , M_time( 0 )
-{
+    if ( size <= pos )
+    {
+        handler().handleEOF();
+    }
 
+    return true;
 }
 
 
 bool
-Parser::parse( std::istream & is )
+Parser::parseHeader( std::istream & is )
 {
-    // check stream status
+    char buf[4];
+    is.read( buf, 4 );
+
     if ( ! is.good() )
     {
         return strmErr( is );
     }
 
-    // parse header
-
-    if ( ! M_header_parsed )
+    const int ver = header_version( buf );
+    if ( ver == 0 )
     {
-        M_header_parsed = true;
-        if ( ! parseHeader( is ) )
-        {
-            return false;
-        }
+        return false;
     }
 
-    // parse data
-
-    if ( M_handler.getLogVersion() >= REC_VERSION_4 )
+    if ( ver == REC_OLD_VERSION )
     {
-        return parseLine( is );
+        is.seekg( 0 );
     }
 
-    return parseData( is );
+    handler().handleLogVersion( ver );
+    M_log_version = M_handler.getLogVersion();
+    M_stamina_capacity = CAPACITY_UNKNOWN;
+    selectShowKernel();
+
+    return true;
 }
 
 
 bool
-Parser::parseHeader( std::istream & is )
+Parser::parseHeader( const char * buf,
+                     const std::size_t size,
+                     std::size_t & pos )
 {
-    char buf[4];
-    is.read( buf, 4 );
-
-    if ( ! is.good() )
+    if ( size < pos + 4 )
     {
-        return strmErr( is );
+        handler().handleEOF();
+        return false;
     }
 
-    if ( buf[0] == 'U'
-         && buf[1] == 'L'
-         && buf[2] == 'G' )
+    const int ver = header_version( buf + pos );
+    if ( ver == 0 )
     {
-        int ver = static_cast< int >( buf[3] );
-        if ( ver != REC_VERSION_2
-             && ver != REC_VERSION_3 )
-        {
-            ver -= static_cast< int >( '0' );
-            if ( ver != REC_VERSION_4
-                 && ver != REC_VERSION_5 )
-            {
-                return false;
-            }
-        }
-
-        M_handler.handleLogVersion( ver );
+        return false;
     }
-    else
+
+    if ( ver != REC_OLD_VERSION )
     {
-        is.seekg( 0 );
-        M_handler.handleLogVersion( 1 );
+        pos += 4;
     }
 
+    handler().handleLogVersion( ver );
+    M_log_version = M_handler.getLogVersion();
+    M_stamina_capacity = CAPACITY_UNKNOWN;
+    selectShowKernel();
+
     return true;
 }
 
@@ -328,7 +1518,7 @@ Parser::parseHeader( std::istream & is )
 bool
 Parser::parseData( std::istream & is )
 {
-    if ( M_handler.getLogVersion() == REC_OLD_VERSION )
+    if ( M_log_version == REC_OLD_VERSION )
     {
         return parseDispInfo( is );
     }
@@ -339,6 +1529,22 @@ Parser::parseData( std::istream & is )
 }
 
 
+bool
+Parser::parseData( const char * buf,
+                   const std::size_t size,
+                   std::size_t & pos )
+{
+    // binary data is read through the stream buffer that refers the memory block.
+    MemoryBuf mem_buf( buf, size, pos );
+    std::istream is( &mem_buf );
+
+    const bool result = parseData( is );
+    pos = mem_buf.position();
+
+    return result;
+}
+
+
 bool
 Parser::parseDispInfo( std::istream & is )
 {
@@ -364,13 +1570,13 @@ Parser::parseDispInfo( std::istream & is )
             convert( disp.body.show.team[1], team[1] );
 
             M_time = show.time_;
-            M_handler.handlePlayMode( M_time, static_cast< PlayMode >( disp.body.show.pmode ) );
-            M_handler.handleTeamInfo( M_time, team[0], team[1] );
-            M_handler.handleShowInfo( show );
+            handler().handlePlayMode( M_time, static_cast< PlayMode >( disp.body.show.pmode ) );
+            handler().handleTeamInfo( M_time, team[0], team[1] );
+            handleShowInfo( show );
         }
         return true;
     case MSG_MODE:
-        M_handler.handleMsgInfo( M_time,
+        handler().handleMsgInfo( M_time,
                                  ntohs( disp.body.msg.board ),
                                  disp.body.msg.message );
         return true;
@@ -379,8 +1585,12 @@ Parser::parseDispInfo( std::istream & is )
     case BLANK_MODE:
         return true;
     default:
-        std::cerr << is.tellg() <<": Unknown mode " << mode
-                  << std::endl;
+        {
+            char mode_str[16];
+            std::sprintf( mode_str, "%d", static_cast< int >( mode ) );
+            M_diagnostics.report( Diagnostics::UNKNOWN_RECORD, is.tellg(),
+                                  "Unknown mode", mode_str, std::strlen( mode_str ) );
+        }
         break;
     }
 
@@ -421,8 +1631,12 @@ Parser::parseMode( std::istream & is )
     case PT_MODE:
         return parsePlayerType( is );
     default:
-        std::cerr << is.tellg() <<": Unknown mode " << ntohs( mode )
-                  << std::endl;
+        {
+            char mode_str[16];
+            std::sprintf( mode_str, "%d", static_cast< int >( ntohs( mode ) ) );
+            M_diagnostics.report( Diagnostics::UNKNOWN_RECORD, is.tellg(),
+                                  "Unknown mode", mode_str, std::strlen( mode_str ) );
+        }
         break;
     }
 
@@ -433,9 +1647,7 @@ Parser::parseMode( std::istream & is )
 bool
 Parser::parseShowInfo( std::istream & is )
 {
-    ShowInfoT new_show;
-
-    if ( M_handler.getLogVersion() == REC_VERSION_3 )
+    if ( M_log_version == REC_VERSION_3 )
     {
         short_showinfo_t2 show;
         is.read( reinterpret_cast< char * >( &show ), sizeof( short_showinfo_t2 ) );
@@ -445,13 +1657,26 @@ Parser::parseShowInfo( std::istream & is )
             return strmErr( is );
         }
 
+        // convert() writes all fields except the following ones.
+        ShowInfoT & new_show = showSlot();
+        for ( int i = 0; i < MAX_PLAYER * 2; ++i )
+        {
+            PlayerT & p = new_show.player_[i];
+            reset_optional_fields( p );
+            p.tackle_count_ = 0;
+            p.pointto_count_ = 0;
+            p.attentionto_count_ = 0;
+        }
+
         convert( show, new_show );
 
         M_time = new_show.time_;
-        M_handler.handleShowInfo( new_show );
+        commitShow();
     }
     else
     {
+        ShowInfoT new_show;
+
         showinfo_t show;
         is.read( reinterpret_cast< char * >( &show ), sizeof( showinfo_t ) );
 
@@ -468,9 +1693,9 @@ Parser::parseShowInfo( std::istream & is )
         convert( show.team[1], team[1] );
 
         M_time = new_show.time_;
-        M_handler.handlePlayMode( M_time, static_cast< PlayMode >( show.pmode ) );
-        M_handler.handleTeamInfo( M_time, team[0], team[1] );
-        M_handler.handleShowInfo( new_show );
+        handler().handlePlayMode( M_time, static_cast< PlayMode >( show.pmode ) );
+        handler().handleTeamInfo( M_time, team[0], team[1] );
+        handleShowInfo( new_show );
     }
 
     return true;
@@ -517,7 +1742,7 @@ Parser::parseMsgInfo( std::istream & is )
     std::string str( msg );
     delete [] msg;
 
-    M_handler.handleMsgInfo( M_time, ntohs( board ), str );
+    handler().handleMsgInfo( M_time, ntohs( board ), str );
     return true;
 }
 
@@ -543,23 +1768,23 @@ Parser::parseDrawInfo( const std::streampos pos,
 {
     switch ( ntohs( draw.mode ) ) {
     case DrawClear:
-        M_handler.handleDrawClear( M_time );
+        handler().handleDrawClear( M_time );
         return true;
     case DrawPoint:
-        M_handler.handleDrawPointInfo( M_time,
+        handler().handleDrawPointInfo( M_time,
                                        PointInfoT( nstohf( draw.object.pinfo.x ),
                                                    nstohf( draw.object.pinfo.y ),
                                                    draw.object.pinfo.color ) );
         return true;
     case DrawCircle:
-        M_handler.handleDrawCircleInfo( M_time,
+        handler().handleDrawCircleInfo( M_time,
                                         CircleInfoT( nstohf( draw.object.cinfo.x ),
                                                      nstohf( draw.object.cinfo.y ),
                                                      nstohf( draw.object.cinfo.r ),
                                                      draw.object.cinfo.color ) );
         return true;
     case DrawLine:
-        M_handler.handleDrawLineInfo( M_time,
+        handler().handleDrawLineInfo( M_time,
                                       LineInfoT( nstohf( draw.object.linfo.x1 ),
                                                  nstohf( draw.object.linfo.y1 ),
                                                  nstohf( draw.object.linfo.x2 ),
@@ -567,8 +1792,12 @@ Parser::parseDrawInfo( const std::streampos pos,
                                                  draw.object.linfo.color ) );
         return true;
     default:
-        std::cerr << pos <<": Unknown draw mode " << ntohs( draw.mode )
-                  << std::endl;
+        {
+            char mode_str[16];
+            std::sprintf( mode_str, "%d", static_cast< int >( ntohs( draw.mode ) ) );
+            M_diagnostics.report( Diagnostics::DRAW_ERROR, pos,
+                                  "Unknown draw mode", mode_str, std::strlen( mode_str ) );
+        }
         return false;
     }
 
@@ -587,7 +1816,7 @@ Parser::parsePlayMode( std::istream & is )
         return strmErr( is );
     }
 
-    M_handler.handlePlayMode( M_time, static_cast< PlayMode >( playmode ) );
+    handler().handlePlayMode( M_time, static_cast< PlayMode >( playmode ) );
     return true;
 }
 
@@ -607,7 +1836,7 @@ Parser::parseTeamInfo( std::istream & is )
     convert( teams[0], new_teams[0] );
     convert( teams[1], new_teams[1] );
 
-    M_handler.handleTeamInfo( M_time, new_teams[0], new_teams[1] );
+    handler().handleTeamInfo( M_time, new_teams[0], new_teams[1] );
     return true;
 }
 
@@ -628,7 +1857,7 @@ Parser::parseServerParam( std::istream & is )
 
     PlayerTypeT::set_default_param( new_params );
 
-    M_handler.handleServerParam( new_params );
+    handler().handleServerParam( new_params );
     return true;
 }
 
@@ -647,7 +1876,7 @@ Parser::parsePlayerParam( std::istream & is )
     PlayerParamT new_params;
     convert( params, new_params );
 
-    M_handler.handlePlayerParam( new_params );
+    handler().handlePlayerParam( new_params );
     return true;
 }
 
@@ -666,7 +1895,7 @@ Parser::parsePlayerType( std::istream & is )
     PlayerTypeT new_type;
     convert( type, new_type );
 
-    M_handler.handlePlayerType( new_type );
+    handler().handlePlayerType( new_type );
     return true;
 }
 
@@ -676,7 +1905,7 @@ Parser::strmErr( std::istream & is )
 {
     if ( is.eof() )
     {
-        M_handler.handleEOF();
+        handler().handleEOF();
         return false;
     }
 
@@ -687,40 +1916,223 @@ Parser::strmErr( std::istream & is )
 bool
 Parser::parseLine( std::istream & is )
 {
-    std::string line;
-
-    if ( std::getline( is, line ) )
+    if ( std::getline( is, M_line_buf ) )
     {
         ++M_line_count;
-        if ( line.empty() )
+        if ( M_line_buf.empty() )
         {
             return true;
         }
 
-        parseLine( M_line_count, line );
+        parseLine( M_line_count, M_line_buf );
         return true;
     }
 
     if ( ! is.eof() )
     {
-        std::cerr << M_line_count << ": error: "
-                  << "Failed to get line."
-                  << std::endl;
+        M_diagnostics.report( Diagnostics::READ_ERROR, M_line_count,
+                              "Failed to get line." );
+    }
+
+    return true;
+}
+
+
+bool
+Parser::parseLine( const char * buf,
+                   const std::size_t size,
+                   std::size_t & pos )
+{
+    const char * first = buf + pos;
+    const char * last = static_cast< const char * >( std::memchr( first, '\n', size - pos ) );
+
+    if ( last )
+    {
+        pos = last - buf + 1; // skip the new line character
+    }
+    else
+    {
+        last = buf + size; // the last line without the new line character
+        pos = size;
+    }
+
+    ++M_line_count;
+    if ( first == last )
+    {
+        return true;
+    }
+
+    // The line is copied to the reused buffer, because each line parser
+    // requires the null terminated string. No memory is allocated here
+    // once the buffer capacity reaches the longest line length.
+    M_line_buf.assign( first, last );
+    parseLine( M_line_count, M_line_buf );
+
+    return true;
+}
+
+
+bool
+Parser::parseLines( const char * buf,
+                    const std::size_t size,
+                    std::size_t & pos )
+{
+    //
+    // split the block at the line boundaries
+    //
+
+    std::vector< ParseTask > tasks;
+    tasks.reserve( M_thread_count );
+
+    const char * first = buf + pos;
+    const char * const buf_end = buf + size;
+    for ( int i = 0; i < M_thread_count && first < buf_end; ++i )
+    {
+        const char * last = buf_end;
+        if ( static_cast< std::size_t >( buf_end - first ) > PARALLEL_CHUNK_SIZE )
+        {
+            last = static_cast< const char * >( std::memchr( first + PARALLEL_CHUNK_SIZE, '\n',
+                                                             buf_end - first - PARALLEL_CHUNK_SIZE ) );
+            last = ( last ? last + 1 : buf_end );
+        }
+
+        tasks.push_back( ParseTask( M_log_version, M_safe_mode, M_field_mask ) );
+        tasks.back().first_ = first;
+        tasks.back().last_ = last;
+        // samples are printed when they are merged into this parser
+        tasks.back().diagnostics_.setPrint( false );
+        tasks.back().diagnostics_.setSampleLimit( M_diagnostics.sampleLimit() );
+
+        first = last;
+    }
+
+    //
+    // numbering lines
+    //
+
+    run_tasks( count_lines, tasks );
+
+    for ( std::vector< ParseTask >::iterator it = tasks.begin(), end = tasks.end();
+          it != end;
+          ++it )
+    {
+        it->first_line_ = M_line_count;
+        M_line_count += it->n_lines_;
+    }
+
+    //
+    // parse and replay
+    //
+
+    run_tasks( parse_lines, tasks );
+
+    for ( std::vector< ParseTask >::const_iterator it = tasks.begin(), end = tasks.end();
+          it != end;
+          ++it )
+    {
+        replay( it->handler_ );
+        M_diagnostics.merge( it->diagnostics_ );
+    }
+
+    pos = first - buf;
+    return true;
+}
+
+
+void
+Parser::replay( const ChunkHandler & chunk )
+{
+    for ( std::vector< ChunkHandler::Record >::const_iterator it = chunk.M_records.begin(), end = chunk.M_records.end();
+          it != end;
+          ++it )
+    {
+        switch ( it->type_ ) {
+        case ChunkHandler::SHOW:
+            M_time = it->time_;
+            handleShowInfo( chunk.M_shows[it->index_] );
+            break;
+        case ChunkHandler::MSG:
+            M_time = it->time_;
+            handler().handleMsgInfo( it->time_,
+                                     chunk.M_msgs[it->index_].first,
+                                     chunk.M_msgs[it->index_].second );
+            break;
+        case ChunkHandler::PLAYMODE:
+            M_time = it->time_;
+            handler().handlePlayMode( it->time_, static_cast< PlayMode >( it->index_ ) );
+            break;
+        case ChunkHandler::TEAM:
+            M_time = it->time_;
+            handler().handleTeamInfo( it->time_,
+                                      chunk.M_teams[it->index_].first,
+                                      chunk.M_teams[it->index_].second );
+            break;
+        case ChunkHandler::DRAW_CLEAR:
+            M_time = it->time_;
+            handler().handleDrawClear( it->time_ );
+            break;
+        case ChunkHandler::DRAW_POINT:
+            M_time = it->time_;
+            handler().handleDrawPointInfo( it->time_, chunk.M_points[it->index_] );
+            break;
+        case ChunkHandler::DRAW_CIRCLE:
+            M_time = it->time_;
+            handler().handleDrawCircleInfo( it->time_, chunk.M_circles[it->index_] );
+            break;
+        case ChunkHandler::DRAW_LINE:
+            M_time = it->time_;
+            handler().handleDrawLineInfo( it->time_, chunk.M_lines[it->index_] );
+            break;
+        case ChunkHandler::LINE:
+            {
+                const ChunkHandler::Line & l = chunk.M_raw_lines[it->index_];
+                M_line_buf.assign( l.first_, l.last_ );
+                parseLine( l.n_line_, M_line_buf );
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+
+bool
+Parser::parseLine( const int n_line,
+                   const std::string & line )
+{
+    if ( line.compare( 0, 6, "(show " ) == 0 )
+    {
+        parseShowLine( n_line, line.c_str(), line.length() );
+        return true;
     }
 
-    return true;
+    return parseOtherLine( n_line, line );
 }
 
 
 bool
 Parser::parseLine( const int n_line,
-                   const std::string & line )
+                   const char * line,
+                   const std::size_t len )
 {
-    if ( line.compare( 0, 6, "(show " ) == 0 )
+    if ( len >= 6
+         && std::strncmp( line, "(show ", 6 ) == 0 )
     {
-        parseShowLine( n_line, line );
+        parseShowLine( n_line, line, len );
+        return true;
     }
-    else if ( line.compare( 0, 6, "(draw " ) == 0 )
+
+    // other records are rare. they are copied into the string.
+    return parseOtherLine( n_line, std::string( line, len ) );
+}
+
+
+bool
+Parser::parseOtherLine( const int n_line,
+                        const std::string & line )
+{
+    if ( line.compare( 0, 6, "(draw " ) == 0 )
     {
         parseDrawLine( n_line, line );
     }
@@ -750,9 +2162,8 @@ Parser::parseLine( const int n_line,
     }
     else
     {
-        std::cerr << n_line << ": error: "
-                  << "Unknown info. " << "\"" << line << "\""
-                  << std::endl;
+        M_diagnostics.report( Diagnostics::UNKNOWN_RECORD, n_line,
+                              "Unknown info.", line );
     }
 
     return true;
@@ -761,12 +2172,63 @@ Parser::parseLine( const int n_line,
 
 bool
 Parser::parseShowLine( const int n_line,
-                       const std::string & line )
+                       const char * line,
+                       const std::size_t len )
 {
-    const char * buf = line.c_str();
-    int n_read = 0;
+    const char * buf = line;
+    if ( ! parseShowHead( n_line, line, len, &buf ) )
+    {
+        return false;
+    }
+
+    // The show data is written to the reused buffer.
+    // The slot has to be taken after the playmode and team info are handled,
+    // because they may flush the show block.
+    ShowInfoT & show = showSlot();
+    show.time_ = static_cast< UInt32 >( M_time );
+
+    const ShowKernel kernel = M_show_kernel;
+    if ( ! ( this->*kernel )( n_line, line, len, buf, show ) )
+    {
+        // the stamina capacity format differs from the probed one.
+        // the line is decoded again by the probing decoder.
+        if ( kernel == M_show_kernel
+             || ! ( this->*M_show_kernel )( n_line, line, len, buf, show ) )
+        {
+            return false;
+        }
+    }
+
+    commitShow();
+
+    return true;
+}
+
+
+void
+Parser::parseShowState( const int n_line,
+                        const char * buf,
+                        const std::size_t size,
+                        const std::size_t pos )
+{
+    const char * first = buf + pos;
+    const char * last = static_cast< const char * >( std::memchr( first, '\n', size - pos ) );
+    M_line_buf.assign( first, ( last ? last : buf + size ) );
+
+    // the show data itself is not handled.
+    const char * body = 0;
+    parseShowHead( n_line, M_line_buf.c_str(), M_line_buf.length(), &body );
+}
+
 
-    ShowInfoT show;
+bool
+Parser::parseShowHead( const int n_line,
+                       const char * line,
+                       const std::size_t len,
+                       const char ** body )
+{
+    const char * buf = line;
+    int n_read = 0;
 
     // time
     int time = 0;
@@ -774,15 +2236,13 @@ Parser::parseShowLine( const int n_line,
         if ( std::sscanf( buf, "(show %d %n",
                           &time, &n_read ) != 1 )
         {
-            std::cerr << n_line << ": error: "
-                      << "Illegal time info \"" << line << "\""
-                      << std::endl;
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal time info", line, len );
             return false;
         }
         buf += n_read;
 
         M_time = time;
-        show.time_ = static_cast< UInt32 >( time );
     }
 
     // playmode
@@ -793,14 +2253,13 @@ Parser::parseShowLine( const int n_line,
                           "(pm %d) %n ",
                           &pm, &n_read ) != 1 )
         {
-            std::cerr << n_line << ": error: "
-                      << "Illegal playmode info \"" << line << "\""
-                      << std::endl;
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal playmode info", line, len );
             return false;
         }
         buf += n_read;
 
-        M_handler.handlePlayMode( time, static_cast< PlayMode >( pm ) );
+        handler().handlePlayMode( time, static_cast< PlayMode >( pm ) );
     }
 
     // team
@@ -819,9 +2278,8 @@ Parser::parseShowLine( const int n_line,
 
         if ( n != 4 && n != 8 )
         {
-            std::cerr << n_line << ": error: "
-                      << "Illegal team info. n=" << n << ' '
-                      << "\"" << line << "\"" << std::endl;;
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal team info", line, len );
             return false;
         }
         while ( *buf != ')' && *buf != '\0' ) ++buf;
@@ -833,253 +2291,332 @@ Parser::parseShowLine( const int n_line,
         TeamT team_l( name_l, score_l, pen_score_l, pen_miss_l );
         TeamT team_r( name_r, score_r, pen_score_r, pen_miss_r );
 
-        M_handler.handleTeamInfo( time, team_l, team_r );
+        handler().handleTeamInfo( time, team_l, team_r );
     }
 
+    *body = buf;
+    return true;
+}
 
-    if ( M_safe_mode )
+
+bool
+Parser::parseShowBodySafe( const int n_line,
+                           const char * line,
+                           const std::size_t len,
+                           const char * buf,
+                           ShowInfoT & show )
+{
+    int n_read = 0;
+
+    // bit flags of the players found in this line
+    UInt32 found = 0;
+
+    // ball
     {
-        // ball
+        BallT & ball = show.ball_;
+        if ( std::sscanf( buf, " ((b) %f %f %f %f) %n",
+                          &ball.x_, &ball.y_, &ball.vx_, &ball.vy_,
+                          &n_read ) != 4 )
         {
-            BallT & ball = show.ball_;
-            if ( std::sscanf( buf, " ((b) %f %f %f %f) %n",
-                              &ball.x_, &ball.y_, &ball.vx_, &ball.vy_,
-                              &n_read ) != 4 )
-            {
-                std::cerr << n_line << ": error: "
-                          << "Illegal ball info \"" << line << "\""
-                          << std::endl;
-                return false;
-            }
-            buf += n_read;
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal ball info", line, len );
+            return false;
         }
+        buf += n_read;
+    }
 
-        // players
-        char side;
-        short unum;
-        short type;
-        int state;
-        float x, y, vx, vy, body, neck;
-        for ( int i = 0; i < MAX_PLAYER * 2; ++i )
+    // players
+    char side;
+    short unum;
+    short type;
+    int state;
+    float x, y, vx, vy, body, neck;
+    for ( int i = 0; i < MAX_PLAYER * 2; ++i )
+    {
+        if ( *buf == '\0' || *buf == ')' ) break;
+
+        if ( std::sscanf( buf,
+                          " ((%c %hd) %hd %x %f %f %f %f %f %f %n",
+                          &side, &unum,
+                          &type, &state,
+                          &x, &y, &vx, &vy, &body, &neck,
+                          &n_read ) != 10 )
         {
-            if ( *buf == '\0' || *buf == ')' ) break;
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal player id or pos", line, len );
+            return false;
+        }
+        buf += n_read;
 
-            if ( std::sscanf( buf,
-                              " ((%c %hd) %hd %x %f %f %f %f %f %f %n",
-                              &side, &unum,
-                              &type, &state,
-                              &x, &y, &vx, &vy, &body, &neck,
-                              &n_read ) != 10 )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player id or pos. " << side << ' ' << unum
-                          << " \"" << line << "\""
-                          << std::endl;
-                return false;
-            }
+        int idx = unum - 1;
+        if ( side == 'r' ) idx += MAX_PLAYER;
+        if ( idx < 0 || MAX_PLAYER*2 <= idx )
+        {
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal player id", line, len );
+            return false;
+        }
+
+        found |= ( 1u << idx );
+
+        PlayerT & p = show.player_[idx];
+        reset_optional_fields( p );
+        p.side_ = side;
+        p.unum_ = unum;
+        p.type_ = type;
+        p.state_ = state;
+        p.x_ = x;
+        p.y_ = y;
+        p.vx_ = vx;
+        p.vy_ = vy;
+        p.body_ = body;
+        p.neck_ = neck;
+
+        if ( *buf != '('
+             && std::sscanf( buf,
+                             "%f %f %n",
+                             &p.point_x_, &p.point_y_,
+                             &n_read ) == 2 )
+        {
             buf += n_read;
+        }
 
-            int idx = unum - 1;
-            if ( side == 'r' ) idx += MAX_PLAYER;
-            if ( idx < 0 || MAX_PLAYER*2 <= idx )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player id. " << side << ' ' << unum
-                          << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
+        if ( std::sscanf( buf,
+                          " (v %c %f) %n ",
+                          &p.view_quality_, &p.view_width_,
+                          &n_read ) != 2 )
+        {
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal player view", line, len );
+            return false;
+        }
+        buf += n_read;
 
-            PlayerT & p = show.player_[idx];
-            p.side_ = side;
-            p.unum_ = unum;
-            p.type_ = type;
-            p.state_ = state;
-            p.x_ = x;
-            p.y_ = y;
-            p.vx_ = vx;
-            p.vy_ = vy;
-            p.body_ = body;
-            p.neck_ = neck;
-
-            if ( *buf != '('
-                 && std::sscanf( buf,
-                                 "%f %f %n",
-                                 &p.point_x_, &p.point_y_,
-                                 &n_read ) == 2 )
-            {
-                buf += n_read;
-            }
+        if ( std::sscanf( buf,
+                          "(s %f %f %f %f) %n",
+                          &p.stamina_, &p.effort_, &p.recovery_, &p.stamina_capacity_,
+                          &n_read ) != 4
+             && std::sscanf( buf,
+                             "(s %f %f %f) %n",
+                             &p.stamina_, &p.effort_, &p.recovery_,
+                             &n_read ) != 3 )
+        {
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal player view or stamina", line, len );
+            return false;
+        }
+        buf += n_read;
 
-            if ( std::sscanf( buf,
-                              " (v %c %f) %n ",
-                              &p.view_quality_, &p.view_width_,
-                              &n_read ) != 2 )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player view . " << side << ' ' << unum
-                          << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
+        if ( *(buf + 1) == 'f'
+             && std::sscanf( buf,
+                             " (f %c %hd) %n",
+                             &p.focus_side_, &p.focus_unum_,
+                             &n_read ) == 2 )
+        {
             buf += n_read;
+        }
 
-            if ( std::sscanf( buf,
-                              "(s %f %f %f %f) %n",
-                              &p.stamina_, &p.effort_, &p.recovery_, &p.stamina_capacity_,
-                              &n_read ) != 4
-                 && std::sscanf( buf,
-                                 "(s %f %f %f) %n",
-                                 &p.stamina_, &p.effort_, &p.recovery_,
-                                 &n_read ) != 3 )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player view or stamina. " << side << ' ' << unum
-                          << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
-            buf += n_read;
+        if ( std::sscanf( buf,
+                          " (c %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd )) %n",
+                          &p.kick_count_, &p.dash_count_, &p.turn_count_, &p.catch_count_, &p.move_count_,
+                          &p.turn_neck_count_, &p.change_view_count_, &p.say_count_, &p.tackle_count_,
+                          &p.pointto_count_, &p.attentionto_count_,
+                          &n_read ) != 11 )
+        {
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal player count", line, len );
+            return false;
+        }
+        buf += n_read;
+    }
 
-            if ( *(buf + 1) == 'f'
-                 && std::sscanf( buf,
-                                 " (f %c %hd) %n",
-                                 &p.focus_side_, &p.focus_unum_,
-                                 &n_read ) == 2 )
-            {
-                buf += n_read;
-            }
+    reset_missing_players( found, show );
+    return true;
+}
 
-            if ( std::sscanf( buf,
-                              " (c %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd )) %n",
-                              &p.kick_count_, &p.dash_count_, &p.turn_count_, &p.catch_count_, &p.move_count_,
-                              &p.turn_neck_count_, &p.change_view_count_, &p.say_count_, &p.tackle_count_,
-                              &p.pointto_count_, &p.attentionto_count_,
-                              &n_read ) != 11 )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player count. " << side << ' ' << unum
-                          << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
-            buf += n_read;
+
+template < int MASK, int CAPACITY >
+bool
+Parser::parseShowBody( const int n_line,
+                       const char * line,
+                       const std::size_t len,
+                       const char * buf,
+                       ShowInfoT & show )
+{
+    // bit flags of the players found in this line
+    UInt32 found = 0;
+    // stamina capacity format found in this line
+    int capacity = CAPACITY_UNKNOWN;
+
+    char * next;
+
+    // ball
+    {
+        // ((b) x y vx vy)
+        while ( *buf != '\0' && *buf != ')' ) ++buf;
+        while ( *buf == ')' ) ++buf;
+        BallT & ball = show.ball_;
+        ball.x_ = scan_float( buf, &next ); buf = next;
+        ball.y_ = scan_float( buf, &next ); buf = next;
+        if ( MASK & FIELD_KINEMATICS )
+        {
+            ball.vx_ = scan_float( buf, &next ); buf = next;
+            ball.vy_ = scan_float( buf, &next ); buf = next;
+        }
+        else
+        {
+            ball.vx_ = SHOWINFO_SCALE2F;
+            ball.vy_ = SHOWINFO_SCALE2F;
+            while ( *buf != '\0' && *buf != ')' ) ++buf;
+        }
+        while ( *buf == ')' ) ++buf;
+        while ( *buf == ' ' ) ++buf;
+
+        if ( ball.y_ == HUGE_VALF
+             || ball.vy_ == HUGE_VALF )
+        {
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal ball info", line, len );
+            return false;
         }
     }
-    else
+
+    // players
+    // ((side unum) type state x y vx vy body neck [pointx pointy] (v h 90) (s 4000 1 1)[(f side unum)])
+    //              (c 1 1 1 1 1 1 1 1 1 1 1))
+    for ( int i = 0; i < MAX_PLAYER * 2; ++i )
     {
-        char * next;
+        if ( *buf == '\0' || *buf == ')' ) break;
 
-        // ball
+        // ((side unum)
+        while ( *buf == ' ' ) ++buf;
+        while ( *buf == '(' ) ++buf;
+        char side = *buf;
+        if ( side != 'l' && side != 'r' )
         {
-            // ((b) x y vx vy)
-            while ( *buf != '\0' && *buf != ')' ) ++buf;
-            while ( *buf == ')' ) ++buf;
-            BallT & ball = show.ball_;
-            ball.x_ = strtof( buf, &next ); buf = next;
-            ball.y_ = strtof( buf, &next ); buf = next;
-            ball.vx_ = strtof( buf, &next ); buf = next;
-            ball.vy_ = strtof( buf, &next ); buf = next;
-            while ( *buf == ')' ) ++buf;
-            while ( *buf == ' ' ) ++buf;
-
-            if ( ball.vy_ == HUGE_VALF )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal ball info. "
-                          << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal player side", buf, std::strlen( buf ) );
+            return false;
         }
 
-        // players
-        // ((side unum) type state x y vx vy body neck [pointx pointy] (v h 90) (s 4000 1 1)[(f side unum)])
-        //              (c 1 1 1 1 1 1 1 1 1 1 1))
-        for ( int i = 0; i < MAX_PLAYER * 2; ++i )
+        ++buf;
+        long unum = scan_long( buf, &next, 10 ); buf = next;
+        if ( unum < 1 || MAX_PLAYER < unum )
         {
-            if ( *buf == '\0' || *buf == ')' ) break;
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal player unum", buf, std::strlen( buf ) );
+            return false;
+        }
 
-            // ((side unum)
-            while ( *buf == ' ' ) ++buf;
-            while ( *buf == '(' ) ++buf;
-            char side = *buf;
-            if ( side != 'l' && side != 'r' )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player side. " << side << ' ' << i
-                          << " \"" << buf << "\""
-                          << std::endl;;
-                return false;
-            }
+        while ( *buf == ')' ) ++buf;
 
-            ++buf;
-            long unum = std::strtol( buf, &next, 10 ); buf = next;
-            if ( unum < 0 || MAX_PLAYER < unum )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player unum. " << side << ' ' << i
-                          << " \"" << buf << "\""
-                          << std::endl;;
-                return false;
-            }
+        const int idx = ( side == 'l' ? unum - 1 : unum - 1 + MAX_PLAYER );
 
-            while ( *buf == ')' ) ++buf;
+        found |= ( 1u << idx );
 
-            const int idx = ( side == 'l' ? unum - 1 : unum - 1 + MAX_PLAYER );
+        PlayerT & p = show.player_[idx];
+        if ( ( MASK & FIELD_ALL ) == FIELD_ALL )
+        {
+            reset_optional_fields( p );
+        }
+        else
+        {
+            // unselected fields keep the default values.
+            p = PlayerT();
+        }
+        p.side_ = side;
+        p.unum_ = static_cast< Int16 >( unum );
 
-            PlayerT & p = show.player_[idx];
-            p.side_ = side;
-            p.unum_ = static_cast< Int16 >( unum );
+        // x y vx vy body neck
+        p.type_ = static_cast< Int16 >( scan_long( buf, &next, 10 ) ); buf = next;
+        p.state_ = static_cast< Int32 >( scan_long( buf, &next, 16 ) ); buf = next;
+        p.x_ = scan_float( buf, &next ); buf = next;
+        p.y_ = scan_float( buf, &next ); buf = next;
 
-            // x y vx vy body neck
-            p.type_ = static_cast< Int16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.state_ = static_cast< Int32 >( std::strtol( buf, &next, 16 ) ); buf = next;
-            p.x_ = strtof( buf, &next ); buf = next;
-            p.y_ = strtof( buf, &next ); buf = next;
-            p.vx_ = strtof( buf, &next ); buf = next;
-            p.vy_ = strtof( buf, &next ); buf = next;
-            p.body_ = strtof( buf, &next ); buf = next;
-            p.neck_ = strtof( buf, &next ); buf = next;
+        if ( MASK & FIELD_KINEMATICS )
+        {
+            p.vx_ = scan_float( buf, &next ); buf = next;
+            p.vy_ = scan_float( buf, &next ); buf = next;
+            p.body_ = scan_float( buf, &next ); buf = next;
+            p.neck_ = scan_float( buf, &next ); buf = next;
             while ( *buf == ' ' ) ++buf;
 
             // x y vx vy body neck
             if ( *buf != '\0' && *buf != '(' )
             {
-                p.point_x_ = strtof( buf, &next ); buf = next;
-                p.point_y_ = strtof( buf, &next ); buf = next;
+                p.point_x_ = scan_float( buf, &next ); buf = next;
+                p.point_y_ = scan_float( buf, &next ); buf = next;
             }
+        }
+        else
+        {
+            // skip vx vy body neck [pointx pointy]
+            while ( *buf != '\0' && *buf != '(' ) ++buf;
+        }
 
-            // (v quality width)
-            while ( *buf != '\0' && *buf != 'v' ) ++buf;
-            ++buf; // skip 'v'
+        // (v quality width)
+        while ( *buf != '\0' && *buf != 'v' ) ++buf;
+        ++buf; // skip 'v'
+        if ( MASK & FIELD_OTHERS )
+        {
             while ( *buf == ' ' ) ++buf;
             p.view_quality_ = *buf; ++buf;
-            p.view_width_ = strtof( buf, &next ); buf = next;
-
-            // (s stamina effort recovery[ capacity])
-            while ( *buf != '\0' && *buf != 's' ) ++buf;
-            ++buf; // skip 's' //while ( *buf != '\0' && *buf != ' ' ) ++buf;
-            p.stamina_ = strtof( buf, &next ); buf = next;
-            p.effort_ = strtof( buf, &next ); buf = next;
-            p.recovery_ = strtof( buf, &next ); buf = next;
-            while ( *buf == ' ' ) ++buf;
-            if ( *buf != ')' )
+            p.view_width_ = scan_float( buf, &next ); buf = next;
+        }
+
+        // (s stamina effort recovery[ capacity])
+        while ( *buf != '\0' && *buf != 's' ) ++buf;
+        ++buf; // skip 's' //while ( *buf != '\0' && *buf != ' ' ) ++buf;
+        if ( MASK & FIELD_STAMINA )
+        {
+            p.stamina_ = scan_float( buf, &next ); buf = next;
+            p.effort_ = scan_float( buf, &next ); buf = next;
+            p.recovery_ = scan_float( buf, &next ); buf = next;
+            if ( CAPACITY == CAPACITY_FOUND )
             {
-                p.stamina_capacity_ = strtof( buf, &next ); buf = next;
+                p.stamina_capacity_ = scan_float( buf, &next );
+                if ( next == buf )
+                {
+                    return reprobeStaminaCapacity();
+                }
+                buf = next;
             }
-            while ( *buf != '\0' && *buf != ')' ) ++buf;
-            while ( *buf == ')' ) ++buf;
+            else if ( CAPACITY == CAPACITY_NONE )
+            {
+                while ( *buf == ' ' ) ++buf;
+                if ( *buf != ')' )
+                {
+                    return reprobeStaminaCapacity();
+                }
+            }
+            else
+            {
+                while ( *buf == ' ' ) ++buf;
+                if ( *buf != ')' )
+                {
+                    p.stamina_capacity_ = scan_float( buf, &next ); buf = next;
+                    capacity = CAPACITY_FOUND;
+                }
+                else if ( capacity == CAPACITY_UNKNOWN )
+                {
+                    capacity = CAPACITY_NONE;
+                }
+            }
+        }
+        while ( *buf != '\0' && *buf != ')' ) ++buf;
+        while ( *buf == ')' ) ++buf;
 
-            while ( *buf != '\0' && *buf != '(' ) ++buf;
+        while ( *buf != '\0' && *buf != '(' ) ++buf;
 
+        if ( MASK & FIELD_OTHERS )
+        {
             // (f side unum)
             if ( *(buf + 1) == 'f' )
             {
                 while ( *buf != '\0' && *buf != ' ' ) ++buf;
                 while ( *buf == ' ' ) ++buf;
                 p.focus_side_ = *buf; ++buf;
-                p.focus_unum_ = static_cast< Int16 >( std::strtol( buf, &next, 10 ) ); buf = next;
+                p.focus_unum_ = static_cast< Int16 >( scan_long( buf, &next, 10 ) ); buf = next;
                 while ( *buf == ' ' ) ++buf;
                 while ( *buf == ')' ) ++buf;
                 while ( *buf == ' ' ) ++buf;
@@ -1088,38 +2625,101 @@ Parser::parseShowLine( const int n_line,
             // (c kick dash turn catch move tneck cview say tackle pointto atttention)
             while ( *buf == '(' ) ++buf;
             ++buf; // skip 'c' //while ( *buf != '\0' && *buf != ' ' ) ++buf;
-            p.kick_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.dash_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.turn_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.catch_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.move_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.turn_neck_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.change_view_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.say_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.tackle_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.pointto_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.attentionto_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            while ( *buf == ')' ) ++buf;
-            while ( *buf == ' ' ) ++buf;
+            p.kick_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.dash_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.turn_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.catch_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.move_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.turn_neck_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.change_view_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.say_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.tackle_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.pointto_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+            p.attentionto_count_ = static_cast< UInt16 >( scan_long( buf, &next, 10 ) ); buf = next;
+        }
+        else
+        {
+            // skip [(f side unum)] (c ...)
+            while ( *buf != '\0' && *buf != 'c' ) ++buf;
+            while ( *buf != '\0' && *buf != ')' ) ++buf;
+        }
+        while ( *buf == ')' ) ++buf;
+        while ( *buf == ' ' ) ++buf;
 
-            if ( *buf == '\0'
-                 && i != MAX_PLAYER*2 - 1 )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player info. " << side << ' ' << unum
-                          << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
+        if ( *buf == '\0'
+             && i != MAX_PLAYER*2 - 1 )
+        {
+            M_diagnostics.report( Diagnostics::SHOW_ERROR, n_line,
+                                  "Illegal player info", line, len );
+            return false;
         }
     }
 
-    M_handler.handleShowInfo( show );
+    reset_missing_players( found, show );
+
+    if ( CAPACITY == CAPACITY_UNKNOWN
+         && capacity != CAPACITY_UNKNOWN )
+    {
+        // the following lines are decoded without probing.
+        M_stamina_capacity = capacity;
+        selectShowKernel();
+    }
 
     return true;
 }
 
 
+void
+Parser::selectShowKernel()
+{
+    if ( M_safe_mode )
+    {
+        M_show_kernel = &Parser::parseShowBodySafe;
+        return;
+    }
+
+    // [field mask][stamina capacity + 1]
+    // the capacity is not probed if the stamina is not decoded.
+    static const ShowKernel kernels[FIELD_ALL + 1][3] = {
+        { &Parser::parseShowBody< 0, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 0, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 0, CAPACITY_UNKNOWN > },
+        { &Parser::parseShowBody< 1, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 1, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 1, CAPACITY_UNKNOWN > },
+        { &Parser::parseShowBody< 2, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 2, CAPACITY_NONE >,
+          &Parser::parseShowBody< 2, CAPACITY_FOUND > },
+        { &Parser::parseShowBody< 3, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 3, CAPACITY_NONE >,
+          &Parser::parseShowBody< 3, CAPACITY_FOUND > },
+        { &Parser::parseShowBody< 4, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 4, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 4, CAPACITY_UNKNOWN > },
+        { &Parser::parseShowBody< 5, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 5, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 5, CAPACITY_UNKNOWN > },
+        { &Parser::parseShowBody< 6, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 6, CAPACITY_NONE >,
+          &Parser::parseShowBody< 6, CAPACITY_FOUND > },
+        { &Parser::parseShowBody< 7, CAPACITY_UNKNOWN >,
+          &Parser::parseShowBody< 7, CAPACITY_NONE >,
+          &Parser::parseShowBody< 7, CAPACITY_FOUND > },
+    };
+
+    M_show_kernel = kernels[ M_field_mask & FIELD_ALL ][ M_stamina_capacity + 1 ];
+}
+
+
+bool
+Parser::reprobeStaminaCapacity()
+{
+    M_stamina_capacity = CAPACITY_UNKNOWN;
+    selectShowKernel();
+    return false;
+}
+
+
 bool
 Parser::parseDrawLine( const int n_line,
                        const std::string & line )
@@ -1139,9 +2739,8 @@ Parser::parseDrawLine( const int n_line,
     if ( std::sscanf( buf, " ( draw %d %n ",
                       &time, &n_read ) != 1 )
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal time info \"" << line << "\""
-                  << std::endl;
+        M_diagnostics.report( Diagnostics::DRAW_ERROR, n_line,
+                              "Illegal time info", line );
         return false;
     }
     buf += n_read;
@@ -1158,13 +2757,12 @@ Parser::parseDrawLine( const int n_line,
                           " (point %f %f \"%63[^\"]\" ) ",
                           &x, &y, col ) != 3 )
         {
-            std::cerr << n_line << ": error: "
-                      << "Illegal draw point info \"" << line << "\""
-                      << std::endl;
+            M_diagnostics.report( Diagnostics::DRAW_ERROR, n_line,
+                                  "Illegal draw point info", line );
             return false;
         }
 
-        M_handler.handleDrawPointInfo( M_time, PointInfoT( x, y, col ) );
+        handler().handleDrawPointInfo( M_time, PointInfoT( x, y, col ) );
     }
     else if ( ! std::strncmp( buf, "(circle ", 8 ) )
     {
@@ -1174,13 +2772,12 @@ Parser::parseDrawLine( const int n_line,
                           " (circle %f %f %f \"%63[^\"]\" ) ",
                           &x, &y, &r, col ) != 4 )
         {
-            std::cerr << n_line << ": error: "
-                      << "Illegal draw circle info \"" << line << "\""
-                      << std::endl;
+            M_diagnostics.report( Diagnostics::DRAW_ERROR, n_line,
+                                  "Illegal draw circle info", line );
             return false;
         }
 
-        M_handler.handleDrawCircleInfo( M_time, CircleInfoT( x, y, r, col ) );
+        handler().handleDrawCircleInfo( M_time, CircleInfoT( x, y, r, col ) );
     }
     else if ( ! std::strncmp( buf, "(line ", 6 ) )
     {
@@ -1191,23 +2788,21 @@ Parser::parseDrawLine( const int n_line,
                           " (line %f %f %f %f \"%63[^\"]\" ) ",
                           &x1, &y1, &x2, &y2, col ) != 5 )
         {
-            std::cerr << n_line << ": error: "
-                      << "Illegal draw line info \"" << line << "\""
-                      << std::endl;
+            M_diagnostics.report( Diagnostics::DRAW_ERROR, n_line,
+                                  "Illegal draw line info", line );
             return false;
         }
 
-        M_handler.handleDrawLineInfo( M_time, LineInfoT( x1, y1, x2, y2, col ) );
+        handler().handleDrawLineInfo( M_time, LineInfoT( x1, y1, x2, y2, col ) );
     }
     else if ( ! std::strncmp( buf, "(clear)", 7 ) )
     {
-        M_handler.handleDrawClear( M_time );
+        handler().handleDrawClear( M_time );
     }
     else
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal draw info \"" << line << "\""
-                  << std::endl;
+        M_diagnostics.report( Diagnostics::DRAW_ERROR, n_line,
+                              "Illegal draw info", line );
         return false;
     }
 
@@ -1232,8 +2827,8 @@ Parser::parseMsgLine( const int n_line,
                       " ( msg %d %d \"%n",
                       &time, &board, &n_read ) != 2 )
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal msg line. \"" << line << "\"" << std::endl;;
+        M_diagnostics.report( Diagnostics::MSG_ERROR, n_line,
+                              "Illegal msg line.", line );
         return false;
     }
 
@@ -1248,14 +2843,14 @@ Parser::parseMsgLine( const int n_line,
     std::string::size_type pos = msg.rfind( "\")" );
     if ( pos == std::string::npos )
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal msg [" << line << "]" << std::endl;;
+        M_diagnostics.report( Diagnostics::MSG_ERROR, n_line,
+                              "Illegal msg", line );
         return false;
     }
 
     msg.erase( pos );
 
-    M_handler.handleMsgInfo( M_time, board, msg );
+    handler().handleMsgInfo( M_time, board, msg );
 
     return true;
 }
@@ -1274,8 +2869,8 @@ Parser::parsePlayModeLine( const int n_line,
                       " ( playmode %d %31[^)] ) ",
                       &time, pm_string ) != 2 )
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal playmode line. \"" << line << "\"" << std::endl;;
+        M_diagnostics.report( Diagnostics::PLAYMODE_ERROR, n_line,
+                              "Illegal playmode line.", line );
         return false;
     }
 
@@ -1291,7 +2886,7 @@ Parser::parsePlayModeLine( const int n_line,
         }
     }
 
-    M_handler.handlePlayMode( M_time, pm );
+    handler().handlePlayMode( M_time, pm );
 
     return true;
 }
@@ -1316,8 +2911,8 @@ Parser::parseTeamLine( const int n_line,
                          &pen_score_r, &pen_miss_r );
     if ( n != 5 && n != 9 )
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal team line. \"" << line << "\"" << std::endl;;
+        M_diagnostics.report( Diagnostics::TEAM_ERROR, n_line,
+                              "Illegal team line.", line );
         return false;
     }
 
@@ -1326,194 +2921,205 @@ Parser::parseTeamLine( const int n_line,
     TeamT team_l( name_l, score_l, pen_score_l, pen_miss_l );
     TeamT team_r( name_r, score_r, pen_score_r, pen_miss_r );
 
-    M_handler.handleTeamInfo( M_time, team_l, team_r );
+    handler().handleTeamInfo( M_time, team_l, team_r );
 
     return true;
 }
 
 
+namespace {
+
+ParamTable< PlayerTypeT >
+create_player_type_table()
+{
+    ParamTable< PlayerTypeT > table;
+
+    table.add( "id", &PlayerTypeT::id_ );
+
+    table.add( "player_speed_max", &PlayerTypeT::player_speed_max_ );
+    table.add( "stamina_inc_max", &PlayerTypeT::stamina_inc_max_ );
+    table.add( "player_decay", &PlayerTypeT::player_decay_ );
+    table.add( "inertia_moment", &PlayerTypeT::inertia_moment_ );
+    table.add( "dash_power_rate", &PlayerTypeT::dash_power_rate_ );
+    table.add( "player_size", &PlayerTypeT::player_size_ );
+    table.add( "kickable_margin", &PlayerTypeT::kickable_margin_ );
+    table.add( "kick_rand", &PlayerTypeT::kick_rand_ );
+    table.add( "extra_stamina", &PlayerTypeT::extra_stamina_ );
+    table.add( "effort_max", &PlayerTypeT::effort_max_ );
+    table.add( "effort_min", &PlayerTypeT::effort_min_ );
+    // 14.0.0
+    table.add( "kick_power_rate", &PlayerTypeT::kick_power_rate_ );
+    table.add( "foul_detect_probability", &PlayerTypeT::foul_detect_probability_ );
+    table.add( "catchable_area_l_stretch", &PlayerTypeT::catchable_area_l_stretch_ );
+
+    table.sort();
+
+    return table;
+}
+
+//! built at the static initialization, and never modified after that.
+const ParamTable< PlayerTypeT > g_player_type_table = create_player_type_table();
+
+}
+
+
 bool
 Parser::parsePlayerTypeLine( const int n_line,
                              const std::string & line )
 {
     PlayerTypeT param;
 
-    //
-    // prepare param map
-    //
-    IntMap int_map;
-    DoubleMap double_map;
-    BoolMap bool_map;
-    StringMap string_map;
-
-    int_map.insert( IntMap::value_type( "id", &param.id_ ) );
-
-    double_map.insert( DoubleMap::value_type( "player_speed_max", &param.player_speed_max_ ) );
-    double_map.insert( DoubleMap::value_type( "stamina_inc_max", &param.stamina_inc_max_ ) );
-    double_map.insert( DoubleMap::value_type( "player_decay", &param.player_decay_ ) );
-    double_map.insert( DoubleMap::value_type( "inertia_moment", &param.inertia_moment_ ) );
-    double_map.insert( DoubleMap::value_type( "dash_power_rate", &param.dash_power_rate_ ) );
-    double_map.insert( DoubleMap::value_type( "player_size", &param.player_size_ ) );
-    double_map.insert( DoubleMap::value_type( "kickable_margin", &param.kickable_margin_ ) );
-    double_map.insert( DoubleMap::value_type( "kick_rand", &param.kick_rand_ ) );
-    double_map.insert( DoubleMap::value_type( "extra_stamina", &param.extra_stamina_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_max", &param.effort_max_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_min", &param.effort_min_ ) );
-    // 14.0.0
-    double_map.insert( DoubleMap::value_type( "kick_power_rate", &param.kick_power_rate_ ) );
-    double_map.insert( DoubleMap::value_type( "foul_detect_probability", &param.foul_detect_probability_ ) );
-    double_map.insert( DoubleMap::value_type( "catchable_area_l_stretch", &param.catchable_area_l_stretch_ ) );
-
     //
     // parse
     //
 
-    if ( ! parse_param_line( n_line, line,
-                             int_map, double_map, bool_map, string_map ) )
+    if ( ! parse_param_line( n_line, line, g_player_type_table, param, M_diagnostics ) )
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal player_type line. \"" << line << "\"" << std::endl;;
+        M_diagnostics.report( Diagnostics::PARAM_ERROR, n_line,
+                              "Illegal player_type line.", line );
         return false;
     }
 
-    M_handler.handlePlayerType( param );
+    handler().handlePlayerType( param );
 
     return true;
 }
 
 
+namespace {
+
+ParamTable< PlayerParamT >
+create_player_param_table()
+{
+    ParamTable< PlayerParamT > table;
+
+    table.add( "player_types", &PlayerParamT::player_types_ );
+    table.add( "subs_max", &PlayerParamT::subs_max_ );
+    table.add( "pt_max", &PlayerParamT::pt_max_ );
+    table.add( "allow_mult_default_type", &PlayerParamT::allow_mult_default_type_ );
+    table.add( "player_speed_max_delta_min", &PlayerParamT::player_speed_max_delta_min_ );
+    table.add( "player_speed_max_delta_max", &PlayerParamT::player_speed_max_delta_max_ );
+    table.add( "stamina_inc_max_delta_factor", &PlayerParamT::stamina_inc_max_delta_factor_ );
+    table.add( "player_decay_delta_min", &PlayerParamT::player_decay_delta_min_ );
+    table.add( "player_decay_delta_max", &PlayerParamT::player_decay_delta_max_ );
+    table.add( "inertia_moment_delta_factor", &PlayerParamT::inertia_moment_delta_factor_ );
+    table.add( "dash_power_rate_delta_min", &PlayerParamT::dash_power_rate_delta_min_ );
+    table.add( "dash_power_rate_delta_max", &PlayerParamT::dash_power_rate_delta_max_ );
+    table.add( "player_size_delta_factor", &PlayerParamT::player_size_delta_factor_ );
+    table.add( "kickable_margin_delta_min", &PlayerParamT::kickable_margin_delta_min_ );
+    table.add( "kickable_margin_delta_max", &PlayerParamT::kickable_margin_delta_max_ );
+    table.add( "kick_rand_delta_factor", &PlayerParamT::kick_rand_delta_factor_ );
+    table.add( "extra_stamina_delta_min", &PlayerParamT::extra_stamina_delta_min_ );
+    table.add( "extra_stamina_delta_max", &PlayerParamT::extra_stamina_delta_max_ );
+    table.add( "effort_max_delta_factor", &PlayerParamT::effort_max_delta_factor_ );
+    table.add( "effort_min_delta_factor", &PlayerParamT::effort_min_delta_factor_ );
+    table.add( "random_seed", &PlayerParamT::random_seed_ );
+    table.add( "new_dash_power_rate_delta_min", &PlayerParamT::new_dash_power_rate_delta_min_ );
+    table.add( "new_dash_power_rate_delta_max", &PlayerParamT::new_dash_power_rate_delta_max_ );
+    table.add( "new_stamina_inc_max_delta_factor", &PlayerParamT::new_stamina_inc_max_delta_factor_ );
+    // 14.0.0
+    table.add( "kick_power_rate_delta_min", &PlayerParamT::kick_power_rate_delta_min_ );
+    table.add( "kick_power_rate_delta_max", &PlayerParamT::kick_power_rate_delta_max_ );
+    table.add( "foul_detect_probability_delta_factor", &PlayerParamT::foul_detect_probability_delta_factor_ );
+    table.add( "catchable_area_l_stretch_min", &PlayerParamT::catchable_area_l_stretch_min_ );
+    table.add( "catchable_area_l_stretch_max", &PlayerParamT::catchable_area_l_stretch_max_ );
+
+    table.sort();
+
+    return table;
+}
+
+//! built at the static initialization, and never modified after that.
+const ParamTable< PlayerParamT > g_player_param_table = create_player_param_table();
+
+}
+
+
 bool
 Parser::parsePlayerParamLine( const int n_line,
                               const std::string & line )
 {
     PlayerParamT param;
 
-    //
-    // prepare param map
-    //
-    IntMap int_map;
-    DoubleMap double_map;
-    BoolMap bool_map;
-    StringMap string_map;
-
-    int_map.insert( IntMap::value_type( "player_types", &param.player_types_ ) );
-    int_map.insert( IntMap::value_type( "subs_max", &param.subs_max_ ) );
-    int_map.insert( IntMap::value_type( "pt_max", &param.pt_max_ ) );
-    bool_map.insert( BoolMap::value_type( "allow_mult_default_type", &param.allow_mult_default_type_ ) );
-    double_map.insert( DoubleMap::value_type( "player_speed_max_delta_min", &param.player_speed_max_delta_min_ ) );
-    double_map.insert( DoubleMap::value_type( "player_speed_max_delta_max", &param.player_speed_max_delta_max_ ) );
-    double_map.insert( DoubleMap::value_type( "stamina_inc_max_delta_factor", &param.stamina_inc_max_delta_factor_ ) );
-    double_map.insert( DoubleMap::value_type( "player_decay_delta_min", &param.player_decay_delta_min_ ) );
-    double_map.insert( DoubleMap::value_type( "player_decay_delta_max", &param.player_decay_delta_max_ ) );
-    double_map.insert( DoubleMap::value_type( "inertia_moment_delta_factor", &param.inertia_moment_delta_factor_ ) );
-    double_map.insert( DoubleMap::value_type( "dash_power_rate_delta_min", &param.dash_power_rate_delta_min_ ) );
-    double_map.insert( DoubleMap::value_type( "dash_power_rate_delta_max", &param.dash_power_rate_delta_max_ ) );
-    double_map.insert( DoubleMap::value_type( "player_size_delta_factor", &param.player_size_delta_factor_ ) );
-    double_map.insert( DoubleMap::value_type( "kickable_margin_delta_min", &param.kickable_margin_delta_min_ ) );
-    double_map.insert( DoubleMap::value_type( "kickable_margin_delta_max", &param.kickable_margin_delta_max_ ) );
-    double_map.insert( DoubleMap::value_type( "kick_rand_delta_factor", &param.kick_rand_delta_factor_ ) );
-    double_map.insert( DoubleMap::value_type( "extra_stamina_delta_min", &param.extra_stamina_delta_min_ ) );
-    double_map.insert( DoubleMap::value_type( "extra_stamina_delta_max", &param.extra_stamina_delta_max_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_max_delta_factor", &param.effort_max_delta_factor_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_min_delta_factor", &param.effort_min_delta_factor_ ) );
-    int_map.insert( IntMap::value_type( "random_seed", &param.random_seed_ ) );
-    double_map.insert( DoubleMap::value_type( "new_dash_power_rate_delta_min", &param.new_dash_power_rate_delta_min_ ) );
-    double_map.insert( DoubleMap::value_type( "new_dash_power_rate_delta_max", &param.new_dash_power_rate_delta_max_ ) );
-    double_map.insert( DoubleMap::value_type( "new_stamina_inc_max_delta_factor", &param.new_stamina_inc_max_delta_factor_ ) );
-    // 14.0.0
-    double_map.insert( DoubleMap::value_type( "kick_power_rate_delta_min", &param.kick_power_rate_delta_min_ ) );
-    double_map.insert( DoubleMap::value_type( "kick_power_rate_delta_max", &param.kick_power_rate_delta_max_ ) );
-    double_map.insert( DoubleMap::value_type( "foul_detect_probability_delta_factor", &param.foul_detect_probability_delta_factor_ ) );
-    double_map.insert( DoubleMap::value_type( "catchable_area_l_stretch_min", &param.catchable_area_l_stretch_min_ ) );
-    double_map.insert( DoubleMap::value_type( "catchable_area_l_stretch_max", &param.catchable_area_l_stretch_max_ ) );
-
     //
     // parse
     //
 
-    if ( ! parse_param_line( n_line, line,
-                             int_map, double_map, bool_map, string_map ) )
+    if ( ! parse_param_line( n_line, line, g_player_param_table, param, M_diagnostics ) )
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal player_param line. \"" << line << "\"" << std::endl;;
+        M_diagnostics.report( Diagnostics::PARAM_ERROR, n_line,
+                              "Illegal player_param line.", line );
         return false;
     }
 
-    M_handler.handlePlayerParam( param );
+    handler().handlePlayerParam( param );
 
     return true;
 }
 
 
-bool
-Parser::parseServerParamLine( const int n_line,
-                              const std::string & line )
-{
-    ServerParamT param;
+namespace {
 
-    //
-    // prepare param map
-    //
-    IntMap int_map;
-    DoubleMap double_map;
-    BoolMap bool_map;
-    StringMap string_map;
-
-    double_map.insert( DoubleMap::value_type( "goal_width", &param.goal_width_ ) );
-    double_map.insert( DoubleMap::value_type( "inertia_moment", &param.inertia_moment_ ) );
-    double_map.insert( DoubleMap::value_type( "player_size", &param.player_size_ ) );
-    double_map.insert( DoubleMap::value_type( "player_decay", &param.player_decay_ ) );
-    double_map.insert( DoubleMap::value_type( "player_rand", &param.player_rand_ ) );
-    double_map.insert( DoubleMap::value_type( "player_weight", &param.player_weight_ ) );
-    double_map.insert( DoubleMap::value_type( "player_speed_max", &param.player_speed_max_ ) );
-    double_map.insert( DoubleMap::value_type( "player_accel_max", &param.player_accel_max_ ) );
-    double_map.insert( DoubleMap::value_type( "stamina_max", &param.stamina_max_ ) );
-    double_map.insert( DoubleMap::value_type( "stamina_inc_max", &param.stamina_inc_max_ ) );
-    double_map.insert( DoubleMap::value_type( "recover_init", &param.recover_init_ ) ); // not necessary
-    double_map.insert( DoubleMap::value_type( "recover_dec_thr", &param.recover_dec_thr_ ) );
-    double_map.insert( DoubleMap::value_type( "recover_min", &param.recover_min_ ) );
-    double_map.insert( DoubleMap::value_type( "recover_dec", &param.recover_dec_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_init", &param.effort_init_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_dec_thr", &param.effort_dec_thr_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_min", &param.effort_min_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_dec", &param.effort_dec_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_inc_thr", &param.effort_inc_thr_ ) );
-    double_map.insert( DoubleMap::value_type( "effort_inc",  &param.effort_inc_ ) );
-    double_map.insert( DoubleMap::value_type( "kick_rand", &param.kick_rand_ ) );
-    bool_map.insert( BoolMap::value_type( "team_actuator_noise", &param.team_actuator_noise_ ) );
-    double_map.insert( DoubleMap::value_type( "prand_factor_l", &param.player_rand_factor_l_ ) );
-    double_map.insert( DoubleMap::value_type( "prand_factor_r", &param.player_rand_factor_r_ ) );
-    double_map.insert( DoubleMap::value_type( "kick_rand_factor_l", &param.kick_rand_factor_l_ ) );
-    double_map.insert( DoubleMap::value_type( "kick_rand_factor_r", &param.kick_rand_factor_r_ ) );
-    double_map.insert( DoubleMap::value_type( "ball_size", &param.ball_size_ ) );
-    double_map.insert( DoubleMap::value_type( "ball_decay", &param.ball_decay_ ) );
-    double_map.insert( DoubleMap::value_type( "ball_rand", &param.ball_rand_ ) );
-    double_map.insert( DoubleMap::value_type( "ball_weight", &param.ball_weight_ ) );
-    double_map.insert( DoubleMap::value_type( "ball_speed_max", &param.ball_speed_max_ ) );
-    double_map.insert( DoubleMap::value_type( "ball_accel_max", &param.ball_accel_max_ ) );
-    double_map.insert( DoubleMap::value_type( "dash_power_rate", &param.dash_power_rate_ ) );
-    double_map.insert( DoubleMap::value_type( "kick_power_rate", &param.kick_power_rate_ ) );
-    double_map.insert( DoubleMap::value_type( "kickable_margin", &param.kickable_margin_ ) );
-    double_map.insert( DoubleMap::value_type( "control_radius", &param.control_radius_ ) );
+ParamTable< ServerParamT >
+create_server_param_table()
+{
+    ParamTable< ServerParamT > table;
+
+    table.add( "goal_width", &ServerParamT::goal_width_ );
+    table.add( "inertia_moment", &ServerParamT::inertia_moment_ );
+    table.add( "player_size", &ServerParamT::player_size_ );
+    table.add( "player_decay", &ServerParamT::player_decay_ );
+    table.add( "player_rand", &ServerParamT::player_rand_ );
+    table.add( "player_weight", &ServerParamT::player_weight_ );
+    table.add( "player_speed_max", &ServerParamT::player_speed_max_ );
+    table.add( "player_accel_max", &ServerParamT::player_accel_max_ );
+    table.add( "stamina_max", &ServerParamT::stamina_max_ );
+    table.add( "stamina_inc_max", &ServerParamT::stamina_inc_max_ );
+    table.add( "recover_init", &ServerParamT::recover_init_ ); // not necessary
+    table.add( "recover_dec_thr", &ServerParamT::recover_dec_thr_ );
+    table.add( "recover_min", &ServerParamT::recover_min_ );
+    table.add( "recover_dec", &ServerParamT::recover_dec_ );
+    table.add( "effort_init", &ServerParamT::effort_init_ );
+    table.add( "effort_dec_thr", &ServerParamT::effort_dec_thr_ );
+    table.add( "effort_min", &ServerParamT::effort_min_ );
+    table.add( "effort_dec", &ServerParamT::effort_dec_ );
+    table.add( "effort_inc_thr", &ServerParamT::effort_inc_thr_ );
+    table.add( "effort_inc", &ServerParamT::effort_inc_ );
+    table.add( "kick_rand", &ServerParamT::kick_rand_ );
+    table.add( "team_actuator_noise", &ServerParamT::team_actuator_noise_ );
+    table.add( "prand_factor_l", &ServerParamT::player_rand_factor_l_ );
+    table.add( "prand_factor_r", &ServerParamT::player_rand_factor_r_ );
+    table.add( "kick_rand_factor_l", &ServerParamT::kick_rand_factor_l_ );
+    table.add( "kick_rand_factor_r", &ServerParamT::kick_rand_factor_r_ );
+    table.add( "ball_size", &ServerParamT::ball_size_ );
+    table.add( "ball_decay", &ServerParamT::ball_decay_ );
+    table.add( "ball_rand", &ServerParamT::ball_rand_ );
+    table.add( "ball_weight", &ServerParamT::ball_weight_ );
+    table.add( "ball_speed_max", &ServerParamT::ball_speed_max_ );
+    table.add( "ball_accel_max", &ServerParamT::ball_accel_max_ );
+    table.add( "dash_power_rate", &ServerParamT::dash_power_rate_ );
+    table.add( "kick_power_rate", &ServerParamT::kick_power_rate_ );
+    table.add( "kickable_margin", &ServerParamT::kickable_margin_ );
+    table.add( "control_radius", &ServerParamT::control_radius_ );
     //( "control_radius_width", &param.control_radius_width_ ) );
     //( "kickable_area", &param.kickable_area_ ) ); // not needed
-    double_map.insert( DoubleMap::value_type( "catch_probability", &param.catch_probability_ ) );
-    double_map.insert( DoubleMap::value_type( "catchable_area_l", &param.catchable_area_l_ ) );
-    double_map.insert( DoubleMap::value_type( "catchable_area_w", &param.catchable_area_w_ ) );
-    int_map.insert( IntMap::value_type( "goalie_max_moves", &param.goalie_max_moves_ ) );
-    double_map.insert( DoubleMap::value_type( "maxpower", &param.max_power_ ) );
-    double_map.insert( DoubleMap::value_type( "minpower", &param.min_power_ ) );
-    double_map.insert( DoubleMap::value_type( "maxmoment", &param.max_moment_ ) );
-    double_map.insert( DoubleMap::value_type( "minmoment", &param.min_moment_ ) );
-    double_map.insert( DoubleMap::value_type( "maxneckmoment", &param.max_neck_moment_ ) );
-    double_map.insert( DoubleMap::value_type( "minneckmoment", &param.min_neck_moment_ ) );
-    double_map.insert( DoubleMap::value_type( "maxneckang", &param.max_neck_angle_ ) );
-    double_map.insert( DoubleMap::value_type( "minneckang", &param.min_neck_angle_ ) );
-    double_map.insert( DoubleMap::value_type( "visible_angle", &param.visible_angle_ ) );
-    double_map.insert( DoubleMap::value_type( "visible_distance", &param.visible_distance_ ) );
-    double_map.insert( DoubleMap::value_type( "audio_cut_dist", &param.audio_cut_dist_ ) );
-    double_map.insert( DoubleMap::value_type( "quantize_step", &param.quantize_step_ ) );
-    double_map.insert( DoubleMap::value_type( "quantize_step_l", &param.landmark_quantize_step_ ) );
+    table.add( "catch_probability", &ServerParamT::catch_probability_ );
+    table.add( "catchable_area_l", &ServerParamT::catchable_area_l_ );
+    table.add( "catchable_area_w", &ServerParamT::catchable_area_w_ );
+    table.add( "goalie_max_moves", &ServerParamT::goalie_max_moves_ );
+    table.add( "maxpower", &ServerParamT::max_power_ );
+    table.add( "minpower", &ServerParamT::min_power_ );
+    table.add( "maxmoment", &ServerParamT::max_moment_ );
+    table.add( "minmoment", &ServerParamT::min_moment_ );
+    table.add( "maxneckmoment", &ServerParamT::max_neck_moment_ );
+    table.add( "minneckmoment", &ServerParamT::min_neck_moment_ );
+    table.add( "maxneckang", &ServerParamT::max_neck_angle_ );
+    table.add( "minneckang", &ServerParamT::min_neck_angle_ );
+    table.add( "visible_angle", &ServerParamT::visible_angle_ );
+    table.add( "visible_distance", &ServerParamT::visible_distance_ );
+    table.add( "audio_cut_dist", &ServerParamT::audio_cut_dist_ );
+    table.add( "quantize_step", &ServerParamT::quantize_step_ );
+    table.add( "quantize_step_l", &ServerParamT::landmark_quantize_step_ );
     //( "quantize_step_dir", &param.dir_quantize_step_ ) );
     //( "quantize_step_dist_team_l", &param.dist_quantize_step_l_ ) );
     //( "quantize_step_dist_team_r", &param.dist_quantize_step_r_ ) );
@@ -1521,164 +3127,180 @@ Parser::parseServerParamLine( const int n_line,
     //( "quantize_step_dist_l_team_r", &param.landmark_dist_quantize_step_r_ ) );
     //( "quantize_step_dir_team_l", &param.dir_quantize_step_l_ ) );
     //( "quantize_step_dir_team_r", &param.dir_quantize_step_r_ ) );
-    double_map.insert( DoubleMap::value_type( "ckick_margin", &param.corner_kick_margin_ ) );
-    double_map.insert( DoubleMap::value_type( "wind_dir", &param.wind_dir_ ) );
-    double_map.insert( DoubleMap::value_type( "wind_force", &param.wind_force_ ) );
-    double_map.insert( DoubleMap::value_type( "wind_ang", &param.wind_angle_ ) );
-    double_map.insert( DoubleMap::value_type( "wind_rand", &param.wind_rand_ ) );
-    bool_map.insert( BoolMap::value_type( "wind_none", &param.wind_none_ ) );
-    bool_map.insert( BoolMap::value_type( "wind_random", &param.wind_random_ ) );
-    int_map.insert( IntMap::value_type( "half_time", &param.half_time_ ) );
-    int_map.insert( IntMap::value_type( "drop_ball_time", &param.drop_ball_time_ ) );
-    int_map.insert( IntMap::value_type( "port", &param.port_ ) );
-    int_map.insert( IntMap::value_type( "coach_port", &param.coach_port_ ) );
-    int_map.insert( IntMap::value_type( "olcoach_port", &param.online_coach_port_ ) );
-    int_map.insert( IntMap::value_type( "say_coach_cnt_max", &param.say_coach_count_max_ ) );
-    int_map.insert( IntMap::value_type( "say_coach_msg_size", &param.say_coach_msg_size_ ) );
-    int_map.insert( IntMap::value_type( "simulator_step", &param.simulator_step_ ) );
-    int_map.insert( IntMap::value_type( "send_step", &param.send_step_ ) );
-    int_map.insert( IntMap::value_type( "recv_step", &param.recv_step_ ) );
-    int_map.insert( IntMap::value_type( "sense_body_step", &param.sense_body_step_ ) );
+    table.add( "ckick_margin", &ServerParamT::corner_kick_margin_ );
+    table.add( "wind_dir", &ServerParamT::wind_dir_ );
+    table.add( "wind_force", &ServerParamT::wind_force_ );
+    table.add( "wind_ang", &ServerParamT::wind_angle_ );
+    table.add( "wind_rand", &ServerParamT::wind_rand_ );
+    table.add( "wind_none", &ServerParamT::wind_none_ );
+    table.add( "wind_random", &ServerParamT::wind_random_ );
+    table.add( "half_time", &ServerParamT::half_time_ );
+    table.add( "drop_ball_time", &ServerParamT::drop_ball_time_ );
+    table.add( "port", &ServerParamT::port_ );
+    table.add( "coach_port", &ServerParamT::coach_port_ );
+    table.add( "olcoach_port", &ServerParamT::online_coach_port_ );
+    table.add( "say_coach_cnt_max", &ServerParamT::say_coach_count_max_ );
+    table.add( "say_coach_msg_size", &ServerParamT::say_coach_msg_size_ );
+    table.add( "simulator_step", &ServerParamT::simulator_step_ );
+    table.add( "send_step", &ServerParamT::send_step_ );
+    table.add( "recv_step", &ServerParamT::recv_step_ );
+    table.add( "sense_body_step", &ServerParamT::sense_body_step_ );
     //( "lcm_step", &param.lcm_step_ ) ); // not needed
-    int_map.insert( IntMap::value_type( "say_msg_size", &param.say_msg_size_ ) );
-    int_map.insert( IntMap::value_type( "clang_win_size", &param.clang_win_size_ ) );
-    int_map.insert( IntMap::value_type( "clang_define_win", &param.clang_define_win_ ) );
-    int_map.insert( IntMap::value_type( "clang_meta_win", &param.clang_meta_win_ ) );
-    int_map.insert( IntMap::value_type( "clang_advice_win", &param.clang_advice_win_ ) );
-    int_map.insert( IntMap::value_type( "clang_info_win", &param.clang_info_win_ ) );
-    int_map.insert( IntMap::value_type( "clang_del_win", &param.clang_del_win_ ) );
-    int_map.insert( IntMap::value_type( "clang_rule_win", &param.clang_rule_win_ ) );
-    int_map.insert( IntMap::value_type( "clang_mess_delay", &param.clang_mess_delay_ ) );
-    int_map.insert( IntMap::value_type( "clang_mess_per_cycle", &param.clang_mess_per_cycle_ ) );
-    int_map.insert( IntMap::value_type( "hear_max", &param.hear_max_ ) );
-    int_map.insert( IntMap::value_type( "hear_inc", &param.hear_inc_ ) );
-    int_map.insert( IntMap::value_type( "hear_decay", &param.hear_decay_ ) );
-    int_map.insert( IntMap::value_type( "catch_ban_cycle", &param.catch_ban_cycle_ ) );
-    bool_map.insert( BoolMap::value_type( "coach", &param.coach_mode_ ) );
-    bool_map.insert( BoolMap::value_type( "coach_w_referee", &param.coach_with_referee_mode_ ) );
-    bool_map.insert( BoolMap::value_type( "old_coach_hear", &param.old_coach_hear_ ) );
-    int_map.insert( IntMap::value_type( "send_vi_step", &param.send_vi_step_ ) );
-    bool_map.insert( BoolMap::value_type( "use_offside", &param.use_offside_ ) );
-    double_map.insert( DoubleMap::value_type( "offside_kick_margin", &param.offside_kick_margin_ ) );
-    bool_map.insert( BoolMap::value_type( "forbid_kick_off_offside", &param.forbid_kick_off_offside_ ) );
-    bool_map.insert( BoolMap::value_type( "verbose", &param.verbose_ ) );
-    double_map.insert( DoubleMap::value_type( "offside_active_area_size", &param.offside_active_area_size_ ) );
-    int_map.insert( IntMap::value_type( "slow_down_factor", &param.slow_down_factor_ ) );
-    bool_map.insert( BoolMap::value_type( "synch_mode", &param.synch_mode_ ) );
-    int_map.insert( IntMap::value_type( "synch_offset", &param.synch_offset_ ) );
-    int_map.insert( IntMap::value_type( "synch_micro_sleep", &param.synch_micro_sleep_ ) );
-    int_map.insert( IntMap::value_type( "start_goal_l", &param.start_goal_l_ ) );
-    int_map.insert( IntMap::value_type( "start_goal_r", &param.start_goal_r_ ) );
-    bool_map.insert( BoolMap::value_type( "fullstate_l", &param.fullstate_l_ ) );
-    bool_map.insert( BoolMap::value_type( "fullstate_r", &param.fullstate_r_ ) );
-    double_map.insert( DoubleMap::value_type( "slowness_on_top_for_left_team", &param.slowness_on_top_for_left_team_ ) );
-    double_map.insert( DoubleMap::value_type( "slowness_on_top_for_right_team", &param.slowness_on_top_for_right_team_ ) );
-    string_map.insert( StringMap::value_type( "landmark_file", &param.landmark_file_ ) );
-    bool_map.insert( BoolMap::value_type( "send_comms", &param.send_comms_ ) );
-    bool_map.insert( BoolMap::value_type( "text_logging", &param.text_logging_ ) );
-    bool_map.insert( BoolMap::value_type( "game_logging", &param.game_logging_ ) );
-    int_map.insert( IntMap::value_type( "game_log_version", &param.game_log_version_ ) );
-    string_map.insert( StringMap::value_type( "text_log_dir", &param.text_log_dir_ ) );
-    string_map.insert( StringMap::value_type( "game_log_dir", &param.game_log_dir_ ) );
-    string_map.insert( StringMap::value_type( "text_log_fixed_name", &param.text_log_fixed_name_ ) );
-    string_map.insert( StringMap::value_type( "game_log_fixed_name", &param.game_log_fixed_name_ ) );
-    bool_map.insert( BoolMap::value_type( "text_log_fixed", &param.text_log_fixed_ ) );
-    bool_map.insert( BoolMap::value_type( "game_log_fixed", &param.game_log_fixed_ ) );
-    bool_map.insert( BoolMap::value_type( "text_log_dated", &param.text_log_dated_ ) );
-    bool_map.insert( BoolMap::value_type( "game_log_dated", &param.game_log_dated_ ) );
-    string_map.insert( StringMap::value_type( "log_date_format", &param.log_date_format_ ) );
-    bool_map.insert( BoolMap::value_type( "log_times", &param.log_times_ ) );
-    bool_map.insert( BoolMap::value_type( "record_messages", &param.record_messages_ ) );
-    int_map.insert( IntMap::value_type( "text_log_compression", &param.text_log_compression_ ) );
-    int_map.insert( IntMap::value_type( "game_log_compression", &param.game_log_compression_ ) );
-    bool_map.insert( BoolMap::value_type( "profile", &param.profile_ ) );
-    int_map.insert( IntMap::value_type( "point_to_ban", &param.point_to_ban_ ) );
-    int_map.insert( IntMap::value_type( "point_to_duration", &param.point_to_duration_ ) );
-    double_map.insert( DoubleMap::value_type( "tackle_dist", &param.tackle_dist_ ) );
-    double_map.insert( DoubleMap::value_type( "tackle_back_dist", &param.tackle_back_dist_ ) );
-    double_map.insert( DoubleMap::value_type( "tackle_width", &param.tackle_width_ ) );
-    double_map.insert( DoubleMap::value_type( "tackle_exponent", &param.tackle_exponent_ ) );
-    int_map.insert( IntMap::value_type( "tackle_cycles", &param.tackle_cycles_ ) );
-    double_map.insert( DoubleMap::value_type( "tackle_power_rate", &param.tackle_power_rate_ ) );
-    int_map.insert( IntMap::value_type( "freeform_wait_period", &param.freeform_wait_period_ ) );
-    int_map.insert( IntMap::value_type( "freeform_send_period", &param.freeform_send_period_ ) );
-    bool_map.insert( BoolMap::value_type( "free_kick_faults", &param.free_kick_faults_ ) );
-    bool_map.insert( BoolMap::value_type( "back_passes", &param.back_passes_ ) );
-    bool_map.insert( BoolMap::value_type( "proper_goal_kicks", &param.proper_goal_kicks_ ) );
-    double_map.insert( DoubleMap::value_type( "stopped_ball_vel", &param.stopped_ball_vel_ ) );
-    int_map.insert( IntMap::value_type( "max_goal_kicks", &param.max_goal_kicks_ ) );
-    bool_map.insert( BoolMap::value_type( "auto_mode", &param.auto_mode_ ) );
-    int_map.insert( IntMap::value_type( "kick_off_wait", &param.kick_off_wait_ ) );
-    int_map.insert( IntMap::value_type( "connect_wait", &param.connect_wait_ ) );
-    int_map.insert( IntMap::value_type( "game_over_wait", &param.game_over_wait_ ) );
-    string_map.insert( StringMap::value_type( "team_l_start", &param.team_l_start_ ) );
-    string_map.insert( StringMap::value_type( "team_r_start", &param.team_r_start_ ) );
-    bool_map.insert( BoolMap::value_type( "keepaway", &param.keepaway_mode_ ) );
-    double_map.insert( DoubleMap::value_type( "keepaway_length", &param.keepaway_length_ ) );
-    double_map.insert( DoubleMap::value_type( "keepaway_width", &param.keepaway_width_ ) );
-    bool_map.insert( BoolMap::value_type( "keepaway_logging", &param.keepaway_logging_ ) );
-    string_map.insert( StringMap::value_type( "keepaway_log_dir", &param.keepaway_log_dir_ ) );
-    string_map.insert( StringMap::value_type( "keepaway_log_fixed_name", &param.keepaway_log_fixed_name_ ) );
-    bool_map.insert( BoolMap::value_type( "keepaway_log_fixed", &param.keepaway_log_fixed_ ) );
-    bool_map.insert( BoolMap::value_type( "keepaway_log_dated", &param.keepaway_log_dated_ ) );
-    int_map.insert( IntMap::value_type( "keepaway_start", &param.keepaway_start_ ) );
-    int_map.insert( IntMap::value_type( "nr_normal_halfs", &param.nr_normal_halfs_ ) );
-    int_map.insert( IntMap::value_type( "nr_extra_halfs", &param.nr_extra_halfs_ ) );
-    bool_map.insert( BoolMap::value_type( "penalty_shoot_outs", &param.penalty_shoot_outs_ ) );
-    int_map.insert( IntMap::value_type( "pen_before_setup_wait", &param.pen_before_setup_wait_ ) );
-    int_map.insert( IntMap::value_type( "pen_setup_wait", &param.pen_setup_wait_ ) );
-    int_map.insert( IntMap::value_type( "pen_ready_wait", &param.pen_ready_wait_ ) );
-    int_map.insert( IntMap::value_type( "pen_taken_wait", &param.pen_taken_wait_ ) );
-    int_map.insert( IntMap::value_type( "pen_nr_kicks", &param.pen_nr_kicks_ ) );
-    int_map.insert( IntMap::value_type( "pen_max_extra_kicks", &param.pen_max_extra_kicks_ ) );
-    double_map.insert( DoubleMap::value_type( "pen_dist_x", &param.pen_dist_x_ ) );
-    bool_map.insert( BoolMap::value_type( "pen_random_winner", &param.pen_random_winner_ ) );
-    double_map.insert( DoubleMap::value_type( "pen_max_goalie_dist_x", &param.pen_max_goalie_dist_x_ ) );
-    bool_map.insert( BoolMap::value_type( "pen_allow_mult_kicks", &param.pen_allow_mult_kicks_ ) );
-    bool_map.insert( BoolMap::value_type( "pen_coach_moves_players", &param.pen_coach_moves_players_ ) );
+    table.add( "say_msg_size", &ServerParamT::say_msg_size_ );
+    table.add( "clang_win_size", &ServerParamT::clang_win_size_ );
+    table.add( "clang_define_win", &ServerParamT::clang_define_win_ );
+    table.add( "clang_meta_win", &ServerParamT::clang_meta_win_ );
+    table.add( "clang_advice_win", &ServerParamT::clang_advice_win_ );
+    table.add( "clang_info_win", &ServerParamT::clang_info_win_ );
+    table.add( "clang_del_win", &ServerParamT::clang_del_win_ );
+    table.add( "clang_rule_win", &ServerParamT::clang_rule_win_ );
+    table.add( "clang_mess_delay", &ServerParamT::clang_mess_delay_ );
+    table.add( "clang_mess_per_cycle", &ServerParamT::clang_mess_per_cycle_ );
+    table.add( "hear_max", &ServerParamT::hear_max_ );
+    table.add( "hear_inc", &ServerParamT::hear_inc_ );
+    table.add( "hear_decay", &ServerParamT::hear_decay_ );
+    table.add( "catch_ban_cycle", &ServerParamT::catch_ban_cycle_ );
+    table.add( "coach", &ServerParamT::coach_mode_ );
+    table.add( "coach_w_referee", &ServerParamT::coach_with_referee_mode_ );
+    table.add( "old_coach_hear", &ServerParamT::old_coach_hear_ );
+    table.add( "send_vi_step", &ServerParamT::send_vi_step_ );
+    table.add( "use_offside", &ServerParamT::use_offside_ );
+    table.add( "offside_kick_margin", &ServerParamT::offside_kick_margin_ );
+    table.add( "forbid_kick_off_offside", &ServerParamT::forbid_kick_off_offside_ );
+    table.add( "verbose", &ServerParamT::verbose_ );
+    table.add( "offside_active_area_size", &ServerParamT::offside_active_area_size_ );
+    table.add( "slow_down_factor", &ServerParamT::slow_down_factor_ );
+    table.add( "synch_mode", &ServerParamT::synch_mode_ );
+    table.add( "synch_offset", &ServerParamT::synch_offset_ );
+    table.add( "synch_micro_sleep", &ServerParamT::synch_micro_sleep_ );
+    table.add( "start_goal_l", &ServerParamT::start_goal_l_ );
+    table.add( "start_goal_r", &ServerParamT::start_goal_r_ );
+    table.add( "fullstate_l", &ServerParamT::fullstate_l_ );
+    table.add( "fullstate_r", &ServerParamT::fullstate_r_ );
+    table.add( "slowness_on_top_for_left_team", &ServerParamT::slowness_on_top_for_left_team_ );
+    table.add( "slowness_on_top_for_right_team", &ServerParamT::slowness_on_top_for_right_team_ );
+    table.add( "landmark_file", &ServerParamT::landmark_file_ );
+    table.add( "send_comms", &ServerParamT::send_comms_ );
+    table.add( "text_logging", &ServerParamT::text_logging_ );
+    table.add( "game_logging", &ServerParamT::game_logging_ );
+    table.add( "game_log_version", &ServerParamT::game_log_version_ );
+    table.add( "text_log_dir", &ServerParamT::text_log_dir_ );
+    table.add( "game_log_dir", &ServerParamT::game_log_dir_ );
+    table.add( "text_log_fixed_name", &ServerParamT::text_log_fixed_name_ );
+    table.add( "game_log_fixed_name", &ServerParamT::game_log_fixed_name_ );
+    table.add( "text_log_fixed", &ServerParamT::text_log_fixed_ );
+    table.add( "game_log_fixed", &ServerParamT::game_log_fixed_ );
+    table.add( "text_log_dated", &ServerParamT::text_log_dated_ );
+    table.add( "game_log_dated", &ServerParamT::game_log_dated_ );
+    table.add( "log_date_format", &ServerParamT::log_date_format_ );
+    table.add( "log_times", &ServerParamT::log_times_ );
+    table.add( "record_messages", &ServerParamT::record_messages_ );
+    table.add( "text_log_compression", &ServerParamT::text_log_compression_ );
+    table.add( "game_log_compression", &ServerParamT::game_log_compression_ );
+    table.add( "profile", &ServerParamT::profile_ );
+    table.add( "point_to_ban", &ServerParamT::point_to_ban_ );
+    table.add( "point_to_duration", &ServerParamT::point_to_duration_ );
+    table.add( "tackle_dist", &ServerParamT::tackle_dist_ );
+    table.add( "tackle_back_dist", &ServerParamT::tackle_back_dist_ );
+    table.add( "tackle_width", &ServerParamT::tackle_width_ );
+    table.add( "tackle_exponent", &ServerParamT::tackle_exponent_ );
+    table.add( "tackle_cycles", &ServerParamT::tackle_cycles_ );
+    table.add( "tackle_power_rate", &ServerParamT::tackle_power_rate_ );
+    table.add( "freeform_wait_period", &ServerParamT::freeform_wait_period_ );
+    table.add( "freeform_send_period", &ServerParamT::freeform_send_period_ );
+    table.add( "free_kick_faults", &ServerParamT::free_kick_faults_ );
+    table.add( "back_passes", &ServerParamT::back_passes_ );
+    table.add( "proper_goal_kicks", &ServerParamT::proper_goal_kicks_ );
+    table.add( "stopped_ball_vel", &ServerParamT::stopped_ball_vel_ );
+    table.add( "max_goal_kicks", &ServerParamT::max_goal_kicks_ );
+    table.add( "auto_mode", &ServerParamT::auto_mode_ );
+    table.add( "kick_off_wait", &ServerParamT::kick_off_wait_ );
+    table.add( "connect_wait", &ServerParamT::connect_wait_ );
+    table.add( "game_over_wait", &ServerParamT::game_over_wait_ );
+    table.add( "team_l_start", &ServerParamT::team_l_start_ );
+    table.add( "team_r_start", &ServerParamT::team_r_start_ );
+    table.add( "keepaway", &ServerParamT::keepaway_mode_ );
+    table.add( "keepaway_length", &ServerParamT::keepaway_length_ );
+    table.add( "keepaway_width", &ServerParamT::keepaway_width_ );
+    table.add( "keepaway_logging", &ServerParamT::keepaway_logging_ );
+    table.add( "keepaway_log_dir", &ServerParamT::keepaway_log_dir_ );
+    table.add( "keepaway_log_fixed_name", &ServerParamT::keepaway_log_fixed_name_ );
+    table.add( "keepaway_log_fixed", &ServerParamT::keepaway_log_fixed_ );
+    table.add( "keepaway_log_dated", &ServerParamT::keepaway_log_dated_ );
+    table.add( "keepaway_start", &ServerParamT::keepaway_start_ );
+    table.add( "nr_normal_halfs", &ServerParamT::nr_normal_halfs_ );
+    table.add( "nr_extra_halfs", &ServerParamT::nr_extra_halfs_ );
+    table.add( "penalty_shoot_outs", &ServerParamT::penalty_shoot_outs_ );
+    table.add( "pen_before_setup_wait", &ServerParamT::pen_before_setup_wait_ );
+    table.add( "pen_setup_wait", &ServerParamT::pen_setup_wait_ );
+    table.add( "pen_ready_wait", &ServerParamT::pen_ready_wait_ );
+    table.add( "pen_taken_wait", &ServerParamT::pen_taken_wait_ );
+    table.add( "pen_nr_kicks", &ServerParamT::pen_nr_kicks_ );
+    table.add( "pen_max_extra_kicks", &ServerParamT::pen_max_extra_kicks_ );
+    table.add( "pen_dist_x", &ServerParamT::pen_dist_x_ );
+    table.add( "pen_random_winner", &ServerParamT::pen_random_winner_ );
+    table.add( "pen_max_goalie_dist_x", &ServerParamT::pen_max_goalie_dist_x_ );
+    table.add( "pen_allow_mult_kicks", &ServerParamT::pen_allow_mult_kicks_ );
+    table.add( "pen_coach_moves_players", &ServerParamT::pen_coach_moves_players_ );
     // v11
-    double_map.insert( DoubleMap::value_type( "ball_stuck_area", &param.ball_stuck_area_ ) );
-    string_map.insert( StringMap::value_type( "coach_msg_file", &param.coach_msg_file_ ) );
+    table.add( "ball_stuck_area", &ServerParamT::ball_stuck_area_ );
+    table.add( "coach_msg_file", &ServerParamT::coach_msg_file_ );
     // v12
-    double_map.insert( DoubleMap::value_type( "max_tackle_power", &param.max_tackle_power_ ) );
-    double_map.insert( DoubleMap::value_type( "max_back_tackle_power", &param.max_back_tackle_power_ ) );
-    double_map.insert( DoubleMap::value_type( "player_speed_max_min", &param.player_speed_max_min_ ) );
-    double_map.insert( DoubleMap::value_type( "extra_stamina", &param.extra_stamina_ ) );
-    int_map.insert( IntMap::value_type( "synch_see_offset", &param.synch_see_offset_ ) );
-    int_map.insert( IntMap::value_type( "max_monitors", &param.max_monitors_ ) );
+    table.add( "max_tackle_power", &ServerParamT::max_tackle_power_ );
+    table.add( "max_back_tackle_power", &ServerParamT::max_back_tackle_power_ );
+    table.add( "player_speed_max_min", &ServerParamT::player_speed_max_min_ );
+    table.add( "extra_stamina", &ServerParamT::extra_stamina_ );
+    table.add( "synch_see_offset", &ServerParamT::synch_see_offset_ );
+    table.add( "max_monitors", &ServerParamT::max_monitors_ );
     // v12.1.3
-    int_map.insert( IntMap::value_type( "extra_half_time", &param.extra_half_time_ ) );
+    table.add( "extra_half_time", &ServerParamT::extra_half_time_ );
     // v13
-    double_map.insert( DoubleMap::value_type( "stamina_capacity", &param.stamina_capacity_ ) );
-    double_map.insert( DoubleMap::value_type( "max_dash_angle", &param.max_dash_angle_ ) );
-    double_map.insert( DoubleMap::value_type( "min_dash_angle", &param.min_dash_angle_ ) );
-    double_map.insert( DoubleMap::value_type( "dash_angle_step", &param.dash_angle_step_ ) );
-    double_map.insert( DoubleMap::value_type( "side_dash_rate", &param.side_dash_rate_ ) );
-    double_map.insert( DoubleMap::value_type( "back_dash_rate", &param.back_dash_rate_ ) );
-    double_map.insert( DoubleMap::value_type( "max_dash_power", &param.max_dash_power_ ) );
-    double_map.insert( DoubleMap::value_type( "min_dash_power", &param.min_dash_power_ ) );
+    table.add( "stamina_capacity", &ServerParamT::stamina_capacity_ );
+    table.add( "max_dash_angle", &ServerParamT::max_dash_angle_ );
+    table.add( "min_dash_angle", &ServerParamT::min_dash_angle_ );
+    table.add( "dash_angle_step", &ServerParamT::dash_angle_step_ );
+    table.add( "side_dash_rate", &ServerParamT::side_dash_rate_ );
+    table.add( "back_dash_rate", &ServerParamT::back_dash_rate_ );
+    table.add( "max_dash_power", &ServerParamT::max_dash_power_ );
+    table.add( "min_dash_power", &ServerParamT::min_dash_power_ );
     // 14.0.0
-    double_map.insert( DoubleMap::value_type( "tackle_rand_factor", &param.tackle_rand_factor_ ) );
-    double_map.insert( DoubleMap::value_type( "foul_detect_probability", &param.foul_detect_probability_ ) );
-    double_map.insert( DoubleMap::value_type( "foul_exponent", &param.foul_exponent_ ) );
-    int_map.insert( IntMap::value_type( "foul_cycles", &param.foul_cycles_ ) );
-    bool_map.insert( BoolMap::value_type( "golden_goal", &param.golden_goal_ ) );
+    table.add( "tackle_rand_factor", &ServerParamT::tackle_rand_factor_ );
+    table.add( "foul_detect_probability", &ServerParamT::foul_detect_probability_ );
+    table.add( "foul_exponent", &ServerParamT::foul_exponent_ );
+    table.add( "foul_cycles", &ServerParamT::foul_cycles_ );
+    table.add( "golden_goal", &ServerParamT::golden_goal_ );
     // 15.0
-    double_map.insert( DoubleMap::value_type( "red_card_probability", &param.red_card_probability_ ) );
+    table.add( "red_card_probability", &ServerParamT::red_card_probability_ );
+
+    table.sort();
+
+    return table;
+}
+
+//! built at the static initialization, and never modified after that.
+const ParamTable< ServerParamT > g_server_param_table = create_server_param_table();
+
+}
+
+
+bool
+Parser::parseServerParamLine( const int n_line,
+                              const std::string & line )
+{
+    ServerParamT param;
 
     //
     // parse
     //
 
-    if ( ! parse_param_line( n_line, line,
-                             int_map, double_map, bool_map, string_map ) )
+    if ( ! parse_param_line( n_line, line, g_server_param_table, param, M_diagnostics ) )
     {
-        std::cerr << n_line << ": error: "
-                  << "Illegal server_param line. \"" << line << "\"" << std::endl;;
+        M_diagnostics.report( Diagnostics::PARAM_ERROR, n_line,
+                              "Illegal server_param line.", line );
         return false;
     }
 
-    M_handler.handleServerParam( param );
+    handler().handleServerParam( param );
     PlayerTypeT::set_default_param( param );
 
     return true;
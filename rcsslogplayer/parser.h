@@ -34,29 +34,90 @@
 #define RCSSLOGPLAYER_RCG_PARSER_H
 
 #include <rcsslogplayer/types.h>
+#include <rcsslogplayer/diagnostics.h>
 
 #include <iosfwd>
 #include <string>
+#include <vector>
+#include <cstddef>
 
 namespace rcss {
 namespace rcg {
 
 class Handler;
+class ChunkHandler;
+class Index;
 
 /*!
   class Parser
   \brief rcg parser
  */
 class Parser {
+public:
+
+    /*!
+      \enum FieldMask
+      \brief flags to select the player and ball fields decoded from the show line.
+
+      FIELD_POSITION is always decoded.
+     */
+    enum FieldMask {
+        FIELD_POSITION = 0x00, //!< time, ball position, player id, type, state and position
+        FIELD_KINEMATICS = 0x01, //!< ball velocity, player velocity, body, neck and pointing position
+        FIELD_STAMINA = 0x02, //!< player stamina, effort, recovery and capacity
+        FIELD_OTHERS = 0x04, //!< player view, focus and command counts
+        FIELD_ALL = 0x07
+    };
+
+    //! recommended number of the show records delivered in one block
+    static const std::size_t DEFAULT_SHOW_BLOCK_SIZE = 256;
+
 private:
 
     //! reference to the data handler instance
     Handler & M_handler;
 
+    /*!
+      \brief format of the stamina capacity in the show line of v4+ log.
+     */
+    enum StaminaCapacity {
+        CAPACITY_UNKNOWN = -1, //!< not probed yet
+        CAPACITY_NONE = 0, //!< (s stamina effort recovery)
+        CAPACITY_FOUND = 1 //!< (s stamina effort recovery capacity)
+    };
+
+    /*!
+      \brief show line decoder selected by the parser options.
+     */
+    typedef bool (Parser::*ShowKernel)( const int,
+                                        const char *,
+                                        const std::size_t,
+                                        const char *,
+                                        ShowInfoT & );
+
     bool M_safe_mode; //!< if this variable is true, parser uses safety but slow algorithm.
+    int M_field_mask; //!< bit flags of FieldMask
+    int M_thread_count; //!< the number of threads used to parse the text lines in the memory block.
     bool M_header_parsed; //!< flag to determin whether the header data is parsed or not
     int M_line_count; //!< total number of parsed line. This variable is used only for v4+ log.
     int M_time; //!< current time
+    int M_log_version; //!< log version cached when the header is parsed
+    int M_stamina_capacity; //!< StaminaCapacity format probed from the show line
+    ShowKernel M_show_kernel; //!< decoder for the body of the show line
+
+    //! error counts and samples
+    Diagnostics M_diagnostics;
+
+    //! reused line buffer. This variable is used only for v4+ log.
+    std::string M_line_buf;
+
+    //! reused show buffer. This variable is used only if the show block is disabled.
+    ShowInfoT M_show_buf;
+
+    //! show records not yet delivered to the handler. empty if the show block is disabled.
+    std::vector< ShowInfoT > M_show_block;
+    //! the number of the pending show records in M_show_block
+    std::size_t M_show_count;
 
     // not used
     Parser();
@@ -72,10 +133,9 @@ public:
     Parser( Handler & handler );
 
     /*!
-      \brief destructor
+      \brief destructor. the pending show records are delivered to the handler.
      */
-    ~Parser()
-      { }
+    ~Parser();
 
     /*!
       \brief analyze rcg data from input stream
@@ -84,6 +144,71 @@ public:
      */
     bool parse( std::istream & is );
 
+    /*!
+      \brief analyze rcg data in the contiguous memory block (e.g. mapped file).
+      \param buf head of the whole data block
+      \param size byte length of the whole data block
+      \param pos read position in the data block.
+      This value is advanced to the head of the next record.
+      \return true if one record is successfully parsed and there may be remained data.
+
+      This method parses only one record per call, in the same way as parse( std::istream & ).
+      The data block must not be changed and must be alive while parsing.
+     */
+    bool parse( const char * buf,
+                const std::size_t size,
+                std::size_t & pos );
+
+    /*!
+      \brief move the read position to the show record of the specified cycle.
+      \param index offset index built from the same data block
+      \param cycle game cycle
+      \param buf head of the whole data block
+      \param size byte length of the whole data block
+      \param pos read position in the data block.
+      This value is set to the head of the show record found by Index::findShow().
+      \return true if the show record is found.
+
+      If the records before the first show (e.g. header and parameters) are not parsed yet,
+      they are parsed at first. Then, the last playmode and team info and the team graphic
+      messages before the target are passed to the handler again, so that the handler has
+      the same state as the sequential parsing. The playmode is taken from the index. If the
+      team info is written in a show line, only that part is parsed, and the show is not passed.
+      Other records before the target are skipped.
+     */
+    bool seek( const Index & index,
+               const int cycle,
+               const char * buf,
+               const std::size_t size,
+               std::size_t & pos );
+
+    /*!
+      \brief parse the records in the cycle range of v4+ log.
+      \param begin_cycle first cycle of the range. negative value means the first cycle in the data.
+      \param end_cycle last cycle of the range. negative value means the last cycle in the data.
+      \param buf head of the whole data block
+      \param size byte length of the whole data block
+      \param pos read position in the data block.
+      This value is set to the head of the first record after the range.
+      \return true if the range is parsed. false if the log is not the text format.
+
+      The show times of v4+ log are monotonic, so the first show record of the range is
+      found by bisection over the byte offsets without the index. The header, the parameters
+      and the last playmode and team info before the range are parsed at first, so that
+      the handler has the same state as the sequential parsing. They may be written in the
+      show line as "(pm ...)" and "(tm ...)". Then, only that part of the line is parsed.
+      Other records before the range are skipped. The records after the last show of the range
+      are parsed until the next show. If the range reaches the end of the data, Handler::handleEOF()
+      is called.
+      If this method returns false for the binary log, pos is set to the head of the data records,
+      and they can be parsed by parse().
+     */
+    bool parseRange( const int begin_cycle,
+                     const int end_cycle,
+                     const char * buf,
+                     const std::size_t size,
+                     std::size_t & pos );
+
     /*!
       \brief set safety parsing mode.
       \param on if this value is true, parser uses safety but slow algorithm.
@@ -91,17 +216,118 @@ public:
     void setSafeMode( const bool on )
       {
           M_safe_mode = on;
+          selectShowKernel();
+      }
+
+    /*!
+      \brief set the fields decoded from the show line of v4+ log.
+      \param mask bit flags of FieldMask
+
+      Unselected fields are skipped without conversion, and they keep the default values.
+      The field mask is ignored in the safety mode and in the binary log.
+     */
+    void setFieldMask( const int mask )
+      {
+          M_field_mask = mask;
+          selectShowKernel();
+      }
+
+    /*!
+      \brief get the current field mask
+      \return bit flags of FieldMask
+     */
+    int fieldMask() const
+      {
+          return M_field_mask;
+      }
+
+    /*!
+      \brief set the number of parser threads.
+      \param count the number of threads. if this value is less than 2, parallel parsing is disabled.
+
+      The parallel parsing is applied only to the v4+ log given as the memory block.
+      In this mode, parse( buf, size, pos ) analyzes a block of lines at once.
+      The block is split into chunks at the line boundaries and each chunk is parsed by its own thread.
+      Parsed data are replayed to the handler in the file order, so the handler receives
+      the same sequence as in the serial mode.
+      If the thread support is not available, chunks are parsed in the caller's thread.
+     */
+    void setThreadCount( const int count )
+      {
+          M_thread_count = count;
+      }
+
+    /*!
+      \brief get the number of parser threads.
+      \return the number of parser threads.
+     */
+    int threadCount() const
+      {
+          return M_thread_count;
       }
 
+    /*!
+      \brief get the diagnostics sink to change its settings or to read the results.
+      \return reference to the diagnostics sink
+
+      Illegal records are reported to this sink instead of being printed one by one.
+     */
+    Diagnostics & diagnostics()
+      {
+          return M_diagnostics;
+      }
+
+    /*!
+      \brief get the diagnostics sink.
+      \return const reference to the diagnostics sink
+     */
+    const Diagnostics & diagnostics() const
+      {
+          return M_diagnostics;
+      }
+
+    /*!
+      \brief set the number of the show records delivered to the handler at once.
+      \param size block size. if this value is less than 2, the show block is disabled.
+
+      In the block mode, the parsed show records are kept in the parser and
+      they are passed to Handler::doHandleShowBlock() when the block becomes full.
+      The block is also flushed before any other record is passed to the handler,
+      and when parse() returns false, so the handler receives all records in the file order.
+      The block mode should not be used if the show must be handled immediately
+      (e.g. monitor client).
+     */
+    void setShowBlockSize( const std::size_t size );
+
+    /*!
+      \brief get the show block size
+      \return the number of the show records delivered at once. 0 if disabled.
+     */
+    std::size_t showBlockSize() const
+      {
+          return M_show_block.size();
+      }
+
+    /*!
+      \brief deliver the pending show records to the handler.
+     */
+    void flush();
+
 private:
 
     bool parseHeader( std::istream & is );
+    bool parseHeader( const char * buf,
+                      const std::size_t size,
+                      std::size_t & pos );
 
     //
     // version 3 or older
     //
 
     bool parseData( std::istream & is );
+    bool parseData( const char * buf,
+                    const std::size_t size,
+                    std::size_t & pos );
 
     bool parseDispInfo( std::istream & is );
     bool parseMode( std::istream & is );
@@ -123,13 +349,70 @@ private:
     //
 
     bool parseLine( std::istream & is );
+    bool parseLine( const char * buf,
+                    const std::size_t size,
+                    std::size_t & pos );
+    bool parseLines( const char * buf,
+                     const std::size_t size,
+                     std::size_t & pos );
+    void replay( const ChunkHandler & chunk );
 public:
     // can be used by monitor client
     bool parseLine( const int n_line,
                     const std::string & line );
+
+    /*!
+      \brief analyze one line without copying it.
+      \param n_line line number. negative value if unknown.
+      \param line head of the line data. line[len] must be '\0'.
+      \param len length of the line data
+      \return true if the line is processed.
+
+      The show line is parsed directly from the given buffer (e.g. the receive buffer of
+      the monitor client), so no memory is allocated for it.
+     */
+    bool parseLine( const int n_line,
+                    const char * line,
+                    const std::size_t len );
 private:
+    bool parseOtherLine( const int n_line,
+                         const std::string & line );
     bool parseShowLine( const int n_line,
-                        const std::string & line );
+                        const char * line,
+                        const std::size_t len );
+    bool parseShowHead( const int n_line,
+                        const char * line,
+                        const std::size_t len,
+                        const char ** body );
+    void parseShowState( const int n_line,
+                         const char * buf,
+                         const std::size_t size,
+                         const std::size_t pos );
+    bool parseShowBodySafe( const int n_line,
+                            const char * line,
+                            const std::size_t len,
+                            const char * buf,
+                            ShowInfoT & show );
+    template < int MASK, int CAPACITY >
+    bool parseShowBody( const int n_line,
+                        const char * line,
+                        const std::size_t len,
+                        const char * buf,
+                        ShowInfoT & show );
+
+    /*!
+      \brief select the show line decoder for the current options.
+
+      The decoder is instantiated for each field mask and stamina capacity format,
+      so the per-line loop does not test the mask and does not probe the capacity.
+     */
+    void selectShowKernel();
+
+    /*!
+      \brief forget the probed stamina capacity format, and select the probing decoder.
+      \return always false
+     */
+    bool reprobeStaminaCapacity();
     bool parseDrawLine( const int n_line,
                         const std::string & line );
     bool parseMsgLine( const int n_line,
@@ -151,6 +434,32 @@ private:
 
     bool strmErr( std::istream & is );
 
+    /*!
+      \brief get the handler after delivering the pending show records.
+      \return reference to the handler
+     */
+    Handler & handler()
+      {
+          if ( M_show_count > 0 )
+          {
+              flush();
+          }
+          return M_handler;
+      }
+
+    /*!
+      \brief get the buffer to which the next show data is written.
+      \return reference to the reused buffer. the previous frame may remain in it.
+     */
+    ShowInfoT & showSlot();
+
+    /*!
+      \brief deliver the show data written in showSlot().
+     */
+    void commitShow();
+
+    void handleShowInfo( const ShowInfoT & show );
+
 };
 
 }
@@ -24,9 +24,13 @@ win32 {
 }
 unix {
   DEFINES += HAVE_NETINET_IN_H
+  DEFINES += HAVE_FCNTL_H HAVE_UNISTD_H HAVE_SYS_MMAN_H HAVE_MMAP
+  DEFINES += HAVE_LIBPTHREAD
 }
 macx {
   DEFINES += HAVE_NETINET_IN_H
+  DEFINES += HAVE_FCNTL_H HAVE_UNISTD_H HAVE_SYS_MMAN_H HAVE_MMAP
+  DEFINES += HAVE_LIBPTHREAD
 }
 
 CONFIG += staticlib warn_on release
@@ -38,14 +42,33 @@ CONFIG += staticlib warn_on release
 
 # Input
 HEADERS += \
+    diagnostics.h \
+    frame_store.h \
     gzfstream.h \
+    gzindex.h \
+    gzinflate.h \
     handler.h \
+    index.h \
+    mappedfile.h \
     parser.h \
+    reader.h \
+    scan_number.h \
+    time_index.h \
     types.h \
-    util.h
+    util.h \
+    zfstream.h
 
 SOURCES += \
+    diagnostics.cpp \
+    frame_store.cpp \
     gzfstream.cpp \
+    gzindex.cpp \
+    gzinflate.cpp \
+    index.cpp \
+    mappedfile.cpp \
     parser.cpp \
+    reader.cpp \
+    time_index.cpp \
     types.cpp \
-    util.cpp
+    util.cpp \
+    zfstream.cpp
@@ -0,0 +1,375 @@
+// -*-c++-*-
+
+/*!
+  \file reader.cpp
+  \brief pull style rcg reader Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "reader.h"
+
+#include "handler.h"
+#include "parser.h"
+
+#include <vector>
+#include <utility>
+
+namespace rcss {
+namespace rcg {
+
+/*!
+  \struct ReaderImpl
+  \brief queue of the records parsed by one Parser::parse() call.
+
+  All containers are cleared before each parse() call, but their capacity is kept.
+  Therefore, no memory is allocated for the show data after the first record.
+*/
+struct ReaderImpl
+    : public Handler {
+
+    //! queued record. index_ points to the element of the container for each type.
+    struct Item {
+        Reader::Type type_;
+        int time_;
+        int value_;
+        std::size_t index_;
+
+        Item( const Reader::Type type,
+              const int time,
+              const int value,
+              const std::size_t index )
+            : type_( type ),
+              time_( time ),
+              value_( value ),
+              index_( index )
+          { }
+    };
+
+    Parser M_parser;
+
+    std::istream * M_is; //!< input stream. NULL if memory block is used.
+    const char * M_buf; //!< input memory block
+    std::size_t M_size; //!< length of the memory block
+    std::size_t M_pos; //!< read position in the memory block
+
+    int M_version;
+    int M_time; //!< last game time
+    bool M_end; //!< true if parser reaches the end of input
+
+    std::vector< Item > M_items;
+    std::size_t M_index; //!< index of the next item
+
+    std::vector< ShowInfoT > M_shows;
+    std::vector< std::string > M_msgs;
+    std::vector< std::pair< TeamT, TeamT > > M_teams;
+    std::vector< PointInfoT > M_points;
+    std::vector< CircleInfoT > M_circles;
+    std::vector< LineInfoT > M_lines;
+    std::vector< ServerParamT > M_server_params;
+    std::vector< PlayerParamT > M_player_params;
+    std::vector< PlayerTypeT > M_player_types;
+
+    Reader::Record M_record; //!< view of the current item
+
+    ReaderImpl()
+        : M_parser( *this ),
+          M_is( 0 ),
+          M_buf( 0 ),
+          M_size( 0 ),
+          M_pos( 0 ),
+          M_version( 0 ),
+          M_time( 0 ),
+          M_end( false ),
+          M_index( 0 )
+      { }
+
+    void clear()
+      {
+          M_items.clear();
+          M_index = 0;
+
+          M_shows.clear();
+          M_msgs.clear();
+          M_teams.clear();
+          M_points.clear();
+          M_circles.clear();
+          M_lines.clear();
+          M_server_params.clear();
+          M_player_params.clear();
+          M_player_types.clear();
+      }
+
+    /*!
+      \brief parse the input until at least one record is queued.
+      \return true if any record is queued.
+     */
+    bool fill()
+      {
+          clear();
+
+          while ( M_items.empty()
+                  && ! M_end )
+          {
+              const bool result = ( M_is
+                                    ? M_parser.parse( *M_is )
+                                    : M_parser.parse( M_buf, M_size, M_pos ) );
+              if ( ! result )
+              {
+                  M_end = true;
+              }
+          }
+
+          return ! M_items.empty();
+      }
+
+    const Reader::Record * next()
+      {
+          if ( M_index >= M_items.size()
+               && ! fill() )
+          {
+              return 0;
+          }
+
+          const Item & item = M_items[M_index++];
+
+          M_record.M_type = item.type_;
+          M_record.M_time = item.time_;
+          M_record.M_value = item.value_;
+          M_record.M_data = 0;
+          M_record.M_data2 = 0;
+
+          switch ( item.type_ ) {
+          case Reader::SHOW:
+              M_record.M_data = &M_shows[item.index_];
+              break;
+          case Reader::MSG:
+              M_record.M_data = &M_msgs[item.index_];
+              break;
+          case Reader::TEAM:
+              M_record.M_data = &M_teams[item.index_].first;
+              M_record.M_data2 = &M_teams[item.index_].second;
+              break;
+          case Reader::DRAW_POINT:
+              M_record.M_data = &M_points[item.index_];
+              break;
+          case Reader::DRAW_CIRCLE:
+              M_record.M_data = &M_circles[item.index_];
+              break;
+          case Reader::DRAW_LINE:
+              M_record.M_data = &M_lines[item.index_];
+              break;
+          case Reader::SERVER_PARAM:
+              M_record.M_data = &M_server_params[item.index_];
+              break;
+          case Reader::PLAYER_PARAM:
+              M_record.M_data = &M_player_params[item.index_];
+              break;
+          case Reader::PLAYER_TYPE:
+              M_record.M_data = &M_player_types[item.index_];
+              break;
+          default:
+              break;
+          }
+
+          return &M_record;
+      }
+
+protected:
+
+    void doHandleLogVersion( int ver )
+      {
+          M_version = ver;
+      }
+
+    int doGetLogVersion() const
+      {
+          return M_version;
+      }
+
+    void doHandleShowInfo( const ShowInfoT & show )
+      {
+          M_time = show.time_;
+          M_items.push_back( Item( Reader::SHOW, M_time, 0, M_shows.size() ) );
+          M_shows.push_back( show );
+      }
+
+    void doHandleMsgInfo( const int time,
+                          const int board,
+                          const std::string & msg )
+      {
+          M_time = time;
+          M_items.push_back( Item( Reader::MSG, time, board, M_msgs.size() ) );
+          M_msgs.push_back( msg );
+      }
+
+    void doHandlePlayMode( const int time,
+                           const PlayMode pm )
+      {
+          M_time = time;
+          M_items.push_back( Item( Reader::PLAYMODE, time, pm, 0 ) );
+      }
+
+    void doHandleTeamInfo( const int time,
+                           const TeamT & team_l,
+                           const TeamT & team_r )
+      {
+          M_time = time;
+          M_items.push_back( Item( Reader::TEAM, time, 0, M_teams.size() ) );
+          M_teams.push_back( std::make_pair( team_l, team_r ) );
+      }
+
+    void doHandleDrawClear( const int time )
+      {
+          M_time = time;
+          M_items.push_back( Item( Reader::DRAW_CLEAR, time, 0, 0 ) );
+      }
+
+    void doHandleDrawPointInfo( const int time,
+                                const PointInfoT & p )
+      {
+          M_time = time;
+          M_items.push_back( Item( Reader::DRAW_POINT, time, 0, M_points.size() ) );
+          M_points.push_back( p );
+      }
+
+    void doHandleDrawCircleInfo( const int time,
+                                 const CircleInfoT & c )
+      {
+          M_time = time;
+          M_items.push_back( Item( Reader::DRAW_CIRCLE, time, 0, M_circles.size() ) );
+          M_circles.push_back( c );
+      }
+
+    void doHandleDrawLineInfo( const int time,
+                               const LineInfoT & l )
+      {
+          M_time = time;
+          M_items.push_back( Item( Reader::DRAW_LINE, time, 0, M_lines.size() ) );
+          M_lines.push_back( l );
+      }
+
+    void doHandleServerParam( const ServerParamT & param )
+      {
+          M_items.push_back( Item( Reader::SERVER_PARAM, M_time, 0, M_server_params.size() ) );
+          M_server_params.push_back( param );
+      }
+
+    void doHandlePlayerParam( const PlayerParamT & param )
+      {
+          M_items.push_back( Item( Reader::PLAYER_PARAM, M_time, 0, M_player_params.size() ) );
+          M_player_params.push_back( param );
+      }
+
+    void doHandlePlayerType( const PlayerTypeT & param )
+      {
+          M_items.push_back( Item( Reader::PLAYER_TYPE, M_time, 0, M_player_types.size() ) );
+          M_player_types.push_back( param );
+      }
+
+    void doHandleEOF()
+      {
+          M_end = true;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+Reader::Reader( std::istream & is )
+    : M_impl( new ReaderImpl() )
+{
+    M_impl->M_is = &is;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+Reader::Reader( const char * buf,
+                const std::size_t size )
+    : M_impl( new ReaderImpl() )
+{
+    M_impl->M_buf = buf;
+    M_impl->M_size = size;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+Reader::~Reader()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+Reader::setSafeMode( const bool on )
+{
+    M_impl->M_parser.setSafeMode( on );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+Reader::setFieldMask( const int mask )
+{
+    M_impl->M_parser.setFieldMask( mask );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+Reader::logVersion() const
+{
+    return M_impl->M_version;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+const Reader::Record *
+Reader::next()
+{
+    return M_impl->next();
+}
+
+}
+}
@@ -0,0 +1,259 @@
+// -*-c++-*-
+
+/*!
+  \file reader.h
+  \brief pull style rcg reader Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_READER_H
+#define RCSSLOGPLAYER_READER_H
+
+#include <rcsslogplayer/types.h>
+
+#include <boost/scoped_ptr.hpp>
+
+#include <iosfwd>
+#include <string>
+#include <cstddef>
+
+namespace rcss {
+namespace rcg {
+
+struct ReaderImpl;
+
+/*!
+  \class Reader
+  \brief pull style rcg reader.
+
+  Reader returns the parsed data one by one without implementing Handler.
+  The caller can stop reading at any time.
+
+  \code
+  rcss::rcg::Reader reader( fin );
+  while ( const rcss::rcg::Reader::Record * rec = reader.next() )
+  {
+      if ( rec->type() == rcss::rcg::Reader::SHOW )
+      {
+          const rcss::rcg::ShowInfoT & show = rec->show();
+          ...
+      }
+  }
+  \endcode
+*/
+class Reader {
+public:
+
+    /*!
+      \enum Type
+      \brief record type
+     */
+    enum Type {
+        SHOW,
+        MSG,
+        PLAYMODE,
+        TEAM,
+        DRAW_CLEAR,
+        DRAW_POINT,
+        DRAW_CIRCLE,
+        DRAW_LINE,
+        SERVER_PARAM,
+        PLAYER_PARAM,
+        PLAYER_TYPE
+    };
+
+    /*!
+      \class Record
+      \brief view of one parsed record.
+
+      The referred data are owned by Reader, and they are valid until the next call of Reader::next().
+      Only the accessor corresponding to type() can be used.
+     */
+    class Record {
+    private:
+        friend struct ReaderImpl;
+
+        Type M_type;
+        int M_time;
+        int M_value; //!< message board or playmode
+        const void * M_data;
+        const void * M_data2;
+
+    public:
+        Record()
+            : M_type( SHOW ),
+              M_time( 0 ),
+              M_value( 0 ),
+              M_data( 0 ),
+              M_data2( 0 )
+          { }
+
+        Type type() const
+          {
+              return M_type;
+          }
+
+        //! game time of this record. parameter records have the last time.
+        int time() const
+          {
+              return M_time;
+          }
+
+        //! SHOW
+        const ShowInfoT & show() const
+          {
+              return *static_cast< const ShowInfoT * >( M_data );
+          }
+
+        //! MSG
+        int board() const
+          {
+              return M_value;
+          }
+
+        //! MSG
+        const std::string & msg() const
+          {
+              return *static_cast< const std::string * >( M_data );
+          }
+
+        //! PLAYMODE
+        PlayMode playMode() const
+          {
+              return static_cast< PlayMode >( M_value );
+          }
+
+        //! TEAM
+        const TeamT & teamLeft() const
+          {
+              return *static_cast< const TeamT * >( M_data );
+          }
+
+        //! TEAM
+        const TeamT & teamRight() const
+          {
+              return *static_cast< const TeamT * >( M_data2 );
+          }
+
+        //! DRAW_POINT
+        const PointInfoT & point() const
+          {
+              return *static_cast< const PointInfoT * >( M_data );
+          }
+
+        //! DRAW_CIRCLE
+        const CircleInfoT & circle() const
+          {
+              return *static_cast< const CircleInfoT * >( M_data );
+          }
+
+        //! DRAW_LINE
+        const LineInfoT & line() const
+          {
+              return *static_cast< const LineInfoT * >( M_data );
+          }
+
+        //! SERVER_PARAM
+        const ServerParamT & serverParam() const
+          {
+              return *static_cast< const ServerParamT * >( M_data );
+          }
+
+        //! PLAYER_PARAM
+        const PlayerParamT & playerParam() const
+          {
+              return *static_cast< const PlayerParamT * >( M_data );
+          }
+
+        //! PLAYER_TYPE
+        const PlayerTypeT & playerType() const
+          {
+              return *static_cast< const PlayerTypeT * >( M_data );
+          }
+    };
+
+private:
+
+    boost::scoped_ptr< ReaderImpl > M_impl;
+
+    // not used
+    Reader();
+    Reader( const Reader & );
+    Reader & operator=( const Reader & );
+
+public:
+
+    /*!
+      \brief construct with the input stream.
+      \param is reference to the input stream. the stream must be alive while reading.
+     */
+    explicit
+    Reader( std::istream & is );
+
+    /*!
+      \brief construct with the contiguous memory block (e.g. mapped file).
+      \param buf head of the whole data block. the block must be alive while reading.
+      \param size byte length of the whole data block
+     */
+    Reader( const char * buf,
+            const std::size_t size );
+
+    /*!
+      \brief destructor
+     */
+    ~Reader();
+
+    /*!
+      \brief set safety parsing mode.
+      \param on if this value is true, parser uses safety but slow algorithm.
+     */
+    void setSafeMode( const bool on );
+
+    /*!
+      \brief set the fields decoded from the show line.
+      \param mask bit flags of Parser::FieldMask
+     */
+    void setFieldMask( const int mask );
+
+    /*!
+      \brief get the log version. available after the first call of next().
+      \return log version number. 0 if the header is not parsed yet.
+     */
+    int logVersion() const;
+
+    /*!
+      \brief get the next record.
+      \return pointer to the record view. NULL if no more record.
+     */
+    const Record * next();
+
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,190 @@
+// -*-c++-*-
+
+/*!
+  \file scan_number.h
+  \brief fixed format number scanners for the show line Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_SCAN_NUMBER_H
+#define RCSSLOGPLAYER_SCAN_NUMBER_H
+
+#include <cstdlib>
+
+namespace rcss {
+namespace rcg {
+
+/*
+  The show line consists of the fixed format decimal numbers.
+  The following scanners convert such numbers without the locale and errno handling.
+  Any unusual format (exponent, too many digits, inf, nan, ...) is delegated to the C library,
+  so the result is always identical to strtof/strtol.
+  This header is not installed. It is shared by the parser and its tests.
+*/
+
+#if ! defined(__FLT_EVAL_METHOD__) || __FLT_EVAL_METHOD__ == 0
+// float expressions are evaluated in the float precision.
+#define RCSS_FAST_SCAN_FLOAT
+#endif
+
+//! the exact power of 10 in float
+const float POW10F[] = { 1.0f, 1.0e1f, 1.0e2f, 1.0e3f, 1.0e4f, 1.0e5f,
+                         1.0e6f, 1.0e7f, 1.0e8f, 1.0e9f, 1.0e10f };
+
+inline
+bool
+is_digit( const char c )
+{
+    return static_cast< unsigned char >( c - '0' ) < 10;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief replacement of strtof() for the fixed format decimal number.
+  \param buf head of the number string
+  \param next pointer to the character after the number
+  \return converted value
+
+  If both the significand and 10^(fraction digits) are exactly represented in float,
+  the single division gives the correctly rounded result as same as strtof().
+ */
+inline
+float
+scan_float( const char * buf,
+            char ** next )
+{
+#ifdef RCSS_FAST_SCAN_FLOAT
+    const char * p = buf;
+    while ( *p == ' ' ) ++p;
+
+    const bool negative = ( *p == '-' );
+    if ( *p == '-' || *p == '+' ) ++p;
+
+    unsigned long m = 0;
+    int n_digits = 0;
+    int n_frac = 0;
+
+    while ( is_digit( *p ) )
+    {
+        m = m * 10 + ( *p - '0' );
+        ++n_digits;
+        ++p;
+    }
+
+    if ( *p == '.' )
+    {
+        ++p;
+        while ( is_digit( *p ) )
+        {
+            m = m * 10 + ( *p - '0' );
+            ++n_digits;
+            ++n_frac;
+            ++p;
+        }
+    }
+
+    if ( 0 < n_digits
+         && n_digits <= 9
+         && n_frac <= 10
+         && m <= ( 1ul << 24 )
+         && *p != 'e' && *p != 'E'
+         && *p != 'x' && *p != 'X' )
+    {
+        float v = static_cast< float >( m );
+        if ( n_frac > 0 )
+        {
+            v /= POW10F[n_frac];
+        }
+
+        *next = const_cast< char * >( p );
+        return ( negative ? -v : v );
+    }
+#endif
+
+    return strtof( buf, next );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief replacement of strtol() for the short integer.
+  \param buf head of the number string
+  \param next pointer to the character after the number
+  \param base 10 or 16. in case of 16, optional "0x" prefix is accepted.
+  \return converted value
+ */
+inline
+long
+scan_long( const char * buf,
+           char ** next,
+           const int base )
+{
+    const char * p = buf;
+    while ( *p == ' ' ) ++p;
+
+    const bool negative = ( *p == '-' );
+    if ( *p == '-' || *p == '+' ) ++p;
+
+    if ( base == 16
+         && *p == '0'
+         && ( *(p + 1) == 'x' || *(p + 1) == 'X' ) )
+    {
+        p += 2;
+    }
+
+    const char * const digits = p;
+    unsigned long v = 0;
+    int n_significant = 0;
+
+    for ( ; ; ++p )
+    {
+        int d = 0;
+        if ( is_digit( *p ) ) d = *p - '0';
+        else if ( base == 16 && 'a' <= *p && *p <= 'f' ) d = *p - 'a' + 10;
+        else if ( base == 16 && 'A' <= *p && *p <= 'F' ) d = *p - 'A' + 10;
+        else break;
+
+        v = v * base + d;
+        if ( v != 0 ) ++n_significant;
+    }
+
+    // the value must be in the range of 32-bit long
+    if ( p != digits
+         && n_significant <= ( base == 16 ? 7 : 9 ) )
+    {
+        *next = const_cast< char * >( p );
+        return ( negative
+                 ? -static_cast< long >( v )
+                 : static_cast< long >( v ) );
+    }
+
+    return std::strtol( buf, next, base );
+}
+
+}
+}
+
+#endif
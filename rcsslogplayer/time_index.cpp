@@ -0,0 +1,131 @@
+// -*-c++-*-
+
+/*!
+  \file time_index.cpp
+  \brief show time to frame index table Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "time_index.h"
+
+#include <algorithm>
+
+namespace rcss {
+namespace rcg {
+
+namespace {
+
+//! the table can always have this number of entries.
+const std::size_t MIN_TABLE_SIZE = 65536;
+//! the maximum number of entries per frame, if the table is larger than MIN_TABLE_SIZE.
+const std::size_t MAX_ENTRIES_PER_FRAME = 16;
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+TimeIndex::TimeIndex()
+    : M_size( 0 ),
+      M_valid( true )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+TimeIndex::clear()
+{
+    std::vector< std::size_t >().swap( M_first );
+    M_size = 0;
+    M_valid = true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+TimeIndex::push_back( const UInt32 time )
+{
+    ++M_size;
+    extend( time );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+TimeIndex::setBack( const UInt32 time )
+{
+    // remove the entries that refer the last frame.
+    while ( ! M_first.empty()
+            && M_first.back() == M_size - 1 )
+    {
+        M_first.pop_back();
+    }
+
+    extend( time );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+TimeIndex::extend( const UInt32 time )
+{
+    const std::size_t t = static_cast< std::size_t >( time );
+    if ( ! M_valid
+         || t < M_first.size() )
+    {
+        // the frame of the same time (sub-cycle) or the invalid time order
+        return;
+    }
+
+    if ( t >= std::max( MIN_TABLE_SIZE, M_size * MAX_ENTRIES_PER_FRAME ) )
+    {
+        std::vector< std::size_t >().swap( M_first );
+        M_valid = false;
+        return;
+    }
+
+    // the times after the previous frame refer the last frame.
+    M_first.resize( t + 1, M_size - 1 );
+}
+
+}
+}
@@ -0,0 +1,118 @@
+// -*-c++-*-
+
+/*!
+  \file time_index.h
+  \brief show time to frame index table Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_TIME_INDEX_H
+#define RCSSLOGPLAYER_TIME_INDEX_H
+
+#include <rcsslogplayer/types.h>
+
+#include <vector>
+#include <cstddef>
+
+namespace rcss {
+namespace rcg {
+
+/*!
+  \class TimeIndex
+  \brief dense table from the show time to the index of its first frame.
+
+  The table is updated when the frame is appended, and each lookup is O(1).
+  Several frames can have the same show time (e.g. during the stoppage of the game).
+  They are consecutive, and each of them is called the sub-cycle of the show time.
+
+  The show time must be monotonic. The frame whose show time is less than the
+  previous one is not registered. If the show time jumps so far that the table
+  becomes too sparse, the table is given up and isValid() returns false.
+  In that case, the owner should find the frame by bisection.
+*/
+class TimeIndex {
+private:
+
+    //! index of the first frame of each show time. [time]
+    std::vector< std::size_t > M_first;
+    //! the number of registered frames
+    std::size_t M_size;
+    //! false if the table is given up
+    bool M_valid;
+
+public:
+
+    /*!
+      \brief create the empty table.
+     */
+    TimeIndex();
+
+    /*!
+      \brief remove all entries. the table becomes valid again.
+     */
+    void clear();
+
+    bool isValid() const
+      {
+          return M_valid;
+      }
+
+    /*!
+      \brief register the new frame
+      \param time show time of the frame
+     */
+    void push_back( const UInt32 time );
+
+    /*!
+      \brief change the show time of the last frame. at least one frame must be registered.
+      \param time new show time of the last frame
+     */
+    void setBack( const UInt32 time );
+
+    /*!
+      \brief find the first frame whose time is not less than the given time.
+      \param time show time
+      \return frame index. the number of frames if not found.
+      The table must be valid.
+     */
+    std::size_t lowerBound( const UInt32 time ) const
+      {
+          const std::size_t t = static_cast< std::size_t >( time );
+          return ( t < M_first.size()
+                   ? M_first[t]
+                   : M_size );
+      }
+
+private:
+
+    void extend( const UInt32 time );
+};
+
+}
+}
+
+#endif
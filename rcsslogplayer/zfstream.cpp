@@ -0,0 +1,999 @@
+// -*-c++-*-
+
+/*!
+  \file zfstream.cpp
+  \brief compressed file stream Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "zfstream.h"
+
+#include "gzinflate.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+#ifdef HAVE_LIBLZ4
+#include <lz4frame.h>
+#endif
+
+namespace {
+
+//! the size of the stream buffer
+const std::size_t BUF_SIZE = 65536;
+
+#if defined(HAVE_LIBZSTD) || defined(HAVE_LIBLZ4)
+/*-------------------------------------------------------------------*/
+/*!
+  \brief release the unused area of the decompressed data.
+ */
+void
+shrink( std::vector< char > & out,
+        const std::size_t size )
+{
+    out.resize( size );
+    if ( out.capacity() > size + size / 2 )
+    {
+        std::vector< char >( out ).swap( out );
+    }
+}
+#endif
+
+}
+
+namespace rcss {
+
+/////////////////////////////////////////////////////////////////////
+
+//! the implementation of the codec
+struct zfilebuf_impl {
+
+    zfilebuf::Format format_;
+    std::ios_base::openmode mode_;
+
+    //! file used by the formats except gzip
+    std::FILE * file_;
+#ifdef HAVE_LIBZ
+    //! gzip file
+    gzFile gz_;
+#endif
+#ifdef HAVE_LIBZSTD
+    ZSTD_DStream * zstd_in_;
+    ZSTD_CStream * zstd_out_;
+#endif
+#ifdef HAVE_LIBLZ4
+    LZ4F_dctx * lz4_in_;
+    LZ4F_cctx * lz4_out_;
+#endif
+
+    //! compressed input buffer
+    std::vector< char > in_;
+    std::size_t in_pos_;
+    std::size_t in_size_;
+    //! true if the file reaches the end.
+    bool in_eof_;
+
+    //! compressed output buffer
+    std::vector< char > out_;
+
+    zfilebuf_impl()
+        : format_( zfilebuf::PLAIN ),
+          mode_( static_cast< std::ios_base::openmode >( 0 ) ),
+          file_( NULL )
+#ifdef HAVE_LIBZ
+        , gz_( NULL )
+#endif
+#ifdef HAVE_LIBZSTD
+        , zstd_in_( NULL )
+        , zstd_out_( NULL )
+#endif
+#ifdef HAVE_LIBLZ4
+        , lz4_in_( NULL )
+        , lz4_out_( NULL )
+#endif
+        , in_pos_( 0 )
+        , in_size_( 0 )
+        , in_eof_( false )
+      { }
+
+    ~zfilebuf_impl()
+      {
+          release();
+      }
+
+    bool is_open() const
+      {
+#ifdef HAVE_LIBZ
+          if ( gz_ )
+          {
+              return true;
+          }
+#endif
+          return file_ != NULL;
+      }
+
+    /*!
+      \brief release all resources without flushing.
+      \return true if the file is successfully closed.
+     */
+    bool release()
+      {
+          bool result = true;
+#ifdef HAVE_LIBZSTD
+          if ( zstd_in_ ) ZSTD_freeDStream( zstd_in_ );
+          if ( zstd_out_ ) ZSTD_freeCStream( zstd_out_ );
+          zstd_in_ = NULL;
+          zstd_out_ = NULL;
+#endif
+#ifdef HAVE_LIBLZ4
+          if ( lz4_in_ ) LZ4F_freeDecompressionContext( lz4_in_ );
+          if ( lz4_out_ ) LZ4F_freeCompressionContext( lz4_out_ );
+          lz4_in_ = NULL;
+          lz4_out_ = NULL;
+#endif
+#ifdef HAVE_LIBZ
+          if ( gz_ )
+          {
+              result = ( gzclose( gz_ ) == Z_OK );
+              gz_ = NULL;
+          }
+#endif
+          if ( file_ )
+          {
+              result = ( std::fclose( file_ ) == 0 );
+              file_ = NULL;
+          }
+
+          format_ = zfilebuf::PLAIN;
+          mode_ = static_cast< std::ios_base::openmode >( 0 );
+          in_pos_ = in_size_ = 0;
+          in_eof_ = false;
+          return result;
+      }
+
+    bool openInput( const char * path )
+      {
+          file_ = std::fopen( path, "rb" );
+          if ( ! file_ )
+          {
+              return false;
+          }
+
+          char magic[4];
+          const std::size_t n = std::fread( magic, 1, sizeof( magic ), file_ );
+          format_ = zfilebuf::detect( magic, n );
+          mode_ = std::ios_base::in;
+
+          if ( ! zfilebuf::isSupported( format_ )
+               || std::fseek( file_, 0, SEEK_SET ) != 0 )
+          {
+              return false;
+          }
+
+          switch ( format_ ) {
+#ifdef HAVE_LIBZ
+          case zfilebuf::GZIP:
+              std::fclose( file_ );
+              file_ = NULL;
+              gz_ = gzopen( path, "rb" );
+              return gz_ != NULL;
+#endif
+#ifdef HAVE_LIBZSTD
+          case zfilebuf::ZSTD:
+              zstd_in_ = ZSTD_createDStream();
+              in_.resize( ZSTD_DStreamInSize() );
+              return ( zstd_in_
+                       && ! ZSTD_isError( ZSTD_initDStream( zstd_in_ ) ) );
+#endif
+#ifdef HAVE_LIBLZ4
+          case zfilebuf::LZ4:
+              in_.resize( BUF_SIZE );
+              return ! LZ4F_isError( LZ4F_createDecompressionContext( &lz4_in_, LZ4F_VERSION ) );
+#endif
+          default:
+              break;
+          }
+
+          return true;
+      }
+
+    bool openOutput( const char * path,
+                     const zfilebuf::Format format,
+                     const int level )
+      {
+          if ( ! zfilebuf::isSupported( format ) )
+          {
+              return false;
+          }
+
+          format_ = format;
+          mode_ = std::ios_base::out;
+
+#ifdef HAVE_LIBZ
+          if ( format == zfilebuf::GZIP )
+          {
+              char mode_str[4] = "wb";
+              if ( 0 <= level && level <= 9 )
+              {
+                  mode_str[2] = static_cast< char >( '0' + level );
+              }
+              gz_ = gzopen( path, mode_str );
+              return gz_ != NULL;
+          }
+#endif
+
+          file_ = std::fopen( path, "wb" );
+          if ( ! file_ )
+          {
+              return false;
+          }
+
+          switch ( format ) {
+#ifdef HAVE_LIBZSTD
+          case zfilebuf::ZSTD:
+              zstd_out_ = ZSTD_createCStream();
+              out_.resize( ZSTD_CStreamOutSize() );
+              return ( zstd_out_
+                       && ! ZSTD_isError( ZSTD_initCStream( zstd_out_,
+                                                            level >= 0 ? level : ZSTD_CLEVEL_DEFAULT ) ) );
+#endif
+#ifdef HAVE_LIBLZ4
+          case zfilebuf::LZ4:
+              {
+                  LZ4F_preferences_t prefs;
+                  std::memset( &prefs, 0, sizeof( prefs ) );
+                  prefs.compressionLevel = ( level >= 0 ? level : 0 );
+
+                  if ( LZ4F_isError( LZ4F_createCompressionContext( &lz4_out_, LZ4F_VERSION ) ) )
+                  {
+                      return false;
+                  }
+
+                  out_.resize( LZ4F_compressBound( BUF_SIZE, &prefs ) + LZ4F_HEADER_SIZE_MAX );
+                  const std::size_t n = LZ4F_compressBegin( lz4_out_, &out_[0], out_.size(), &prefs );
+                  return ( ! LZ4F_isError( n )
+                           && std::fwrite( &out_[0], 1, n, file_ ) == n );
+              }
+#endif
+          default:
+              break;
+          }
+
+          return true;
+      }
+
+    /*!
+      \brief fill the input buffer if empty.
+     */
+    void fillInput()
+      {
+          if ( in_pos_ == in_size_
+               && ! in_eof_ )
+          {
+              in_pos_ = 0;
+              in_size_ = std::fread( &in_[0], 1, in_.size(), file_ );
+              if ( in_size_ == 0 )
+              {
+                  in_eof_ = true;
+              }
+          }
+      }
+
+    /*!
+      \brief read the uncompressed data.
+      \return the number of bytes read. -1 if error.
+     */
+    int read( char * buf,
+              const std::size_t len )
+      {
+          switch ( format_ ) {
+          case zfilebuf::PLAIN:
+              return static_cast< int >( std::fread( buf, 1, len, file_ ) );
+#ifdef HAVE_LIBZ
+          case zfilebuf::GZIP:
+              return gzread( gz_, buf, static_cast< unsigned >( len ) );
+#endif
+#ifdef HAVE_LIBZSTD
+          case zfilebuf::ZSTD:
+              {
+                  ZSTD_outBuffer out = { buf, len, 0 };
+                  while ( out.pos < out.size )
+                  {
+                      fillInput();
+
+                      const std::size_t before = out.pos;
+                      ZSTD_inBuffer in = { &in_[0], in_size_, in_pos_ };
+                      const std::size_t ret = ZSTD_decompressStream( zstd_in_, &out, &in );
+                      in_pos_ = in.pos;
+
+                      if ( ZSTD_isError( ret ) )
+                      {
+                          return ( out.pos > 0 ? static_cast< int >( out.pos ) : -1 );
+                      }
+
+                      if ( in_eof_
+                           && out.pos == before )
+                      {
+                          break;
+                      }
+                  }
+                  return static_cast< int >( out.pos );
+              }
+#endif
+#ifdef HAVE_LIBLZ4
+          case zfilebuf::LZ4:
+              {
+                  std::size_t pos = 0;
+                  while ( pos < len )
+                  {
+                      fillInput();
+
+                      std::size_t dst_size = len - pos;
+                      std::size_t src_size = in_size_ - in_pos_;
+                      const std::size_t ret = LZ4F_decompress( lz4_in_,
+                                                               buf + pos, &dst_size,
+                                                               &in_[0] + in_pos_, &src_size,
+                                                               NULL );
+                      pos += dst_size;
+                      in_pos_ += src_size;
+
+                      if ( LZ4F_isError( ret ) )
+                      {
+                          return ( pos > 0 ? static_cast< int >( pos ) : -1 );
+                      }
+
+                      if ( in_eof_
+                           && dst_size == 0 )
+                      {
+                          break;
+                      }
+                  }
+                  return static_cast< int >( pos );
+              }
+#endif
+          default:
+              break;
+          }
+
+          return -1;
+      }
+
+    /*!
+      \brief write the uncompressed data. len must not exceed BUF_SIZE.
+      \return true if successfully written.
+     */
+    bool write( const char * buf,
+                const std::size_t len )
+      {
+          switch ( format_ ) {
+          case zfilebuf::PLAIN:
+              return std::fwrite( buf, 1, len, file_ ) == len;
+#ifdef HAVE_LIBZ
+          case zfilebuf::GZIP:
+              return ( len == 0
+                       || gzwrite( gz_, buf, static_cast< unsigned >( len ) ) > 0 );
+#endif
+#ifdef HAVE_LIBZSTD
+          case zfilebuf::ZSTD:
+              {
+                  ZSTD_inBuffer in = { buf, len, 0 };
+                  while ( in.pos < in.size )
+                  {
+                      ZSTD_outBuffer out = { &out_[0], out_.size(), 0 };
+                      if ( ZSTD_isError( ZSTD_compressStream( zstd_out_, &out, &in ) )
+                           || std::fwrite( &out_[0], 1, out.pos, file_ ) != out.pos )
+                      {
+                          return false;
+                      }
+                  }
+                  return true;
+              }
+#endif
+#ifdef HAVE_LIBLZ4
+          case zfilebuf::LZ4:
+              {
+                  const std::size_t n = LZ4F_compressUpdate( lz4_out_, &out_[0], out_.size(), buf, len, NULL );
+                  return ( ! LZ4F_isError( n )
+                           && std::fwrite( &out_[0], 1, n, file_ ) == n );
+              }
+#endif
+          default:
+              break;
+          }
+
+          return false;
+      }
+
+    /*!
+      \brief write the end of the compressed frame.
+      \return true if successfully written.
+     */
+    bool finish()
+      {
+          switch ( format_ ) {
+#ifdef HAVE_LIBZSTD
+          case zfilebuf::ZSTD:
+              while ( true )
+              {
+                  ZSTD_outBuffer out = { &out_[0], out_.size(), 0 };
+                  const std::size_t remaining = ZSTD_endStream( zstd_out_, &out );
+                  if ( ZSTD_isError( remaining )
+                       || std::fwrite( &out_[0], 1, out.pos, file_ ) != out.pos )
+                  {
+                      return false;
+                  }
+
+                  if ( remaining == 0 )
+                  {
+                      return true;
+                  }
+              }
+#endif
+#ifdef HAVE_LIBLZ4
+          case zfilebuf::LZ4:
+              {
+                  const std::size_t n = LZ4F_compressEnd( lz4_out_, &out_[0], out_.size(), NULL );
+                  return ( ! LZ4F_isError( n )
+                           && std::fwrite( &out_[0], 1, n, file_ ) == n );
+              }
+#endif
+          default:
+              break;
+          }
+
+          return true;
+      }
+};
+
+/////////////////////////////////////////////////////////////////////
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf::zfilebuf()
+    : M_impl( new zfilebuf_impl )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf::~zfilebuf()
+{
+    close();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf::Format
+zfilebuf::detect( const char * buf,
+                  const std::size_t size )
+{
+    const unsigned char * p = reinterpret_cast< const unsigned char * >( buf );
+
+    if ( size >= 2
+         && p[0] == 0x1f && p[1] == 0x8b )
+    {
+        return GZIP;
+    }
+
+    if ( size >= 4
+         && p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd )
+    {
+        return ZSTD;
+    }
+
+    if ( size >= 4
+         && p[0] == 0x04 && p[1] == 0x22 && p[2] == 0x4d && p[3] == 0x18 )
+    {
+        return LZ4;
+    }
+
+    return PLAIN;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf::Format
+zfilebuf::formatOf( const std::string & path )
+{
+    const char * exts[] = { ".gz", ".zst", ".lz4" };
+    const Format formats[] = { GZIP, ZSTD, LZ4 };
+
+    for ( std::size_t i = 0; i < sizeof( exts ) / sizeof( exts[0] ); ++i )
+    {
+        const std::size_t len = std::strlen( exts[i] );
+        if ( path.length() >= len
+             && path.compare( path.length() - len, len, exts[i] ) == 0 )
+        {
+            return formats[i];
+        }
+    }
+
+    return PLAIN;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+zfilebuf::isSupported( const Format format )
+{
+    switch ( format ) {
+    case PLAIN:
+        return true;
+#ifdef HAVE_LIBZ
+    case GZIP:
+        return true;
+#endif
+#ifdef HAVE_LIBZSTD
+    case ZSTD:
+        return true;
+#endif
+#ifdef HAVE_LIBLZ4
+    case LZ4:
+        return true;
+#endif
+    default:
+        break;
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+zfilebuf::decompress( const char * buf,
+                      const std::size_t size,
+                      std::vector< char > & out )
+{
+    out.clear();
+
+    switch ( detect( buf, size ) ) {
+    case GZIP:
+        return inflate_gzip( buf, size, 1, out );
+#ifdef HAVE_LIBZSTD
+    case ZSTD:
+        {
+            ZSTD_DStream * ds = ZSTD_createDStream();
+            if ( ! ds
+                 || ZSTD_isError( ZSTD_initDStream( ds ) ) )
+            {
+                if ( ds ) ZSTD_freeDStream( ds );
+                return false;
+            }
+
+            // the frame header may have the content size.
+            const unsigned long long hint = ZSTD_getFrameContentSize( buf, size );
+            out.resize( hint != ZSTD_CONTENTSIZE_UNKNOWN
+                        && hint != ZSTD_CONTENTSIZE_ERROR
+                        && hint > 0
+                        ? static_cast< std::size_t >( hint )
+                        : std::max( size * 4, BUF_SIZE ) );
+
+            ZSTD_inBuffer in = { buf, size, 0 };
+            std::size_t produced = 0;
+            bool result = false;
+            while ( true )
+            {
+                if ( produced == out.size() )
+                {
+                    out.resize( out.size() * 2 );
+                }
+
+                ZSTD_outBuffer o = { &out[0], out.size(), produced };
+                const std::size_t ret = ZSTD_decompressStream( ds, &o, &in );
+                produced = o.pos;
+
+                if ( ZSTD_isError( ret ) )
+                {
+                    break;
+                }
+
+                // all frames are completed, or the last frame is truncated.
+                if ( in.pos == in.size
+                     && ( ret == 0 || o.pos < o.size ) )
+                {
+                    result = true;
+                    break;
+                }
+            }
+
+            ZSTD_freeDStream( ds );
+            shrink( out, result ? produced : 0 );
+            return result;
+        }
+#endif
+#ifdef HAVE_LIBLZ4
+    case LZ4:
+        {
+            LZ4F_dctx * ctx = NULL;
+            if ( LZ4F_isError( LZ4F_createDecompressionContext( &ctx, LZ4F_VERSION ) ) )
+            {
+                return false;
+            }
+
+            out.resize( std::max( size * 3, BUF_SIZE ) );
+
+            std::size_t in_pos = 0;
+            std::size_t produced = 0;
+            bool result = false;
+            while ( true )
+            {
+                if ( produced == out.size() )
+                {
+                    out.resize( out.size() * 2 );
+                }
+
+                std::size_t dst_size = out.size() - produced;
+                std::size_t src_size = size - in_pos;
+                const std::size_t ret = LZ4F_decompress( ctx,
+                                                         &out[produced], &dst_size,
+                                                         buf + in_pos, &src_size,
+                                                         NULL );
+                produced += dst_size;
+                in_pos += src_size;
+
+                if ( LZ4F_isError( ret ) )
+                {
+                    break;
+                }
+
+                // all frames are completed, or the last frame is truncated.
+                if ( in_pos == size
+                     && ( ret == 0 || produced < out.size() ) )
+                {
+                    result = true;
+                    break;
+                }
+            }
+
+            LZ4F_freeDecompressionContext( ctx );
+            shrink( out, result ? produced : 0 );
+            return result;
+        }
+#endif
+    default:
+        break;
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+zfilebuf::is_open() const
+{
+    return M_impl->is_open();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf::Format
+zfilebuf::format() const
+{
+    return M_impl->format_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf *
+zfilebuf::open( const char * path,
+                std::ios_base::openmode mode,
+                const Format format,
+                const int level )
+{
+    if ( is_open() )
+    {
+        return NULL;
+    }
+
+    const bool testi = mode & std::ios_base::in;
+    const bool testo = mode & std::ios_base::out;
+    if ( testi == testo )
+    {
+        return NULL;
+    }
+
+    const bool result = ( testi
+                          ? M_impl->openInput( path )
+                          : M_impl->openOutput( path, format, level ) );
+    if ( ! result )
+    {
+        M_impl->release();
+        return NULL;
+    }
+
+    M_buf.resize( BUF_SIZE );
+    if ( testi )
+    {
+        this->setg( &M_buf[0], &M_buf[0], &M_buf[0] );
+    }
+    else
+    {
+        this->setp( &M_buf[0], &M_buf[0] + M_buf.size() );
+    }
+
+    return this;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf *
+zfilebuf::close()
+{
+    if ( ! is_open() )
+    {
+        return NULL;
+    }
+
+    bool result = true;
+    if ( M_impl->mode_ & std::ios_base::out )
+    {
+        result = ( flushBuf()
+                   && M_impl->finish() );
+    }
+
+    if ( ! M_impl->release() )
+    {
+        result = false;
+    }
+
+    this->setg( NULL, NULL, NULL );
+    this->setp( NULL, NULL );
+    std::vector< char_type >().swap( M_buf );
+
+    return result ? this : NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+zfilebuf::flushBuf()
+{
+    if ( ! is_open()
+         || ! ( M_impl->mode_ & std::ios_base::out ) )
+    {
+        return false;
+    }
+
+    const std::size_t size = this->pptr() - this->pbase();
+    const bool result = ( size == 0
+                          || M_impl->write( this->pbase(), size ) );
+
+    this->setp( &M_buf[0], &M_buf[0] + M_buf.size() );
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+zfilebuf::sync()
+{
+    if ( ! is_open()
+         || ( M_impl->mode_ & std::ios_base::in ) )
+    {
+        return 0;
+    }
+
+    return flushBuf() ? 0 : -1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf::int_type
+zfilebuf::overflow( int_type c )
+{
+    if ( ! flushBuf() )
+    {
+        return traits_type::eof();
+    }
+
+    if ( ! traits_type::eq_int_type( c, traits_type::eof() ) )
+    {
+        *this->pptr() = traits_type::to_char_type( c );
+        this->pbump( 1 );
+    }
+
+    return traits_type::not_eof( c );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zfilebuf::int_type
+zfilebuf::underflow()
+{
+    if ( ! is_open()
+         || ! ( M_impl->mode_ & std::ios_base::in ) )
+    {
+        return traits_type::eof();
+    }
+
+    const int size = M_impl->read( &M_buf[0], M_buf.size() );
+    if ( size <= 0 )
+    {
+        return traits_type::eof();
+    }
+
+    this->setg( &M_buf[0], &M_buf[0], &M_buf[0] + size );
+    return traits_type::to_int_type( *this->gptr() );
+}
+
+///////////////////////////////////////////////////////////////////////
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zifstream::zifstream()
+    : std::istream( static_cast< std::streambuf * >( 0 ) )
+    , M_file_buf()
+{
+    this->init( &M_file_buf );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zifstream::zifstream( const char * path )
+    : std::istream( static_cast< std::streambuf * >( 0 ) )
+    , M_file_buf()
+{
+    this->init( &M_file_buf );
+    this->open( path );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+zifstream::open( const char * path )
+{
+    if ( ! M_file_buf.open( path, std::ios_base::in ) )
+    {
+        this->setstate( std::ios_base::failbit );
+    }
+    else
+    {
+        this->clear();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+zifstream::close()
+{
+    if ( ! M_file_buf.close() )
+    {
+        this->setstate( std::ios_base::failbit );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zofstream::zofstream()
+    : std::ostream( static_cast< std::streambuf * >( 0 ) )
+    , M_file_buf()
+{
+    this->init( &M_file_buf );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+zofstream::zofstream( const char * path,
+                      const zfilebuf::Format format,
+                      const int level )
+    : std::ostream( static_cast< std::streambuf * >( 0 ) )
+    , M_file_buf()
+{
+    this->init( &M_file_buf );
+    this->open( path, format, level );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+zofstream::open( const char * path,
+                 const zfilebuf::Format format,
+                 const int level )
+{
+    if ( ! M_file_buf.open( path, std::ios_base::out, format, level ) )
+    {
+        this->setstate( std::ios_base::failbit );
+    }
+    else
+    {
+        this->clear();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+zofstream::close()
+{
+    if ( ! M_file_buf.close() )
+    {
+        this->setstate( std::ios_base::failbit );
+    }
+}
+
+}
@@ -0,0 +1,330 @@
+// -*-c++-*-
+
+/*!
+  \file zfstream.h
+  \brief compressed file stream Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_ZFSTREAM_H
+#define RCSSLOGPLAYER_ZFSTREAM_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include <boost/scoped_ptr.hpp>
+
+namespace rcss {
+
+struct zfilebuf_impl;
+
+/*!
+  \class zfilebuf
+  \brief compression format independent file stream buffer class.
+
+  In the input mode, the format is detected by the magic bytes of the file,
+  and the uncompressed file is read as it is.
+  In the output mode, the format is given by the caller
+  (e.g. formatOf() of the output file path).
+
+  The gzip format is supported if zlib is available (HAVE_LIBZ).
+  The zstd and lz4 formats are supported if libzstd (HAVE_LIBZSTD) and
+  liblz4 (HAVE_LIBLZ4) are available.
+  Seeking is not supported.
+*/
+class zfilebuf
+    : public std::streambuf {
+public:
+
+    /*!
+      \enum Format
+      \brief compression format
+     */
+    enum Format {
+        PLAIN, //!< not compressed
+        GZIP,
+        ZSTD,
+        LZ4,
+    };
+
+    //! default compression level of each format
+    enum {
+        DEFAULT_LEVEL = -1
+    };
+
+private:
+
+    //! Pimpl ideom. the instance of the codec.
+    boost::scoped_ptr< zfilebuf_impl > M_impl;
+
+    //! pointer to the stream buffer. This is used as array.
+    std::vector< char_type > M_buf;
+
+    //! not used
+    zfilebuf( const zfilebuf & );
+    //! not used
+    zfilebuf & operator=( const zfilebuf & );
+
+public:
+    /*!
+      \brief default constructor.
+     */
+    zfilebuf();
+
+    /*!
+      \brief destructor. close the opened file.
+    */
+    virtual
+    ~zfilebuf();
+
+    /*!
+      \brief detect the format by the magic bytes.
+      \param buf head of the data
+      \param size byte length of the data
+      \return detected format. PLAIN if no known magic bytes.
+     */
+    static
+    Format detect( const char * buf,
+                   const std::size_t size );
+
+    /*!
+      \brief get the format by the file name extension (.gz, .zst or .lz4).
+      \param path file path
+      \return format for the file name. PLAIN if no known extension.
+     */
+    static
+    Format formatOf( const std::string & path );
+
+    /*!
+      \brief check if the format is available in this build.
+      \param format compression format
+      \return true if the format can be read and written.
+     */
+    static
+    bool isSupported( const Format format );
+
+    /*!
+      \brief decompress the whole data in the memory.
+      \param buf head of the compressed data
+      \param size byte length of the compressed data
+      \param out reference to the result container
+      \return true if the data is successfully decompressed.
+     */
+    static
+    bool decompress( const char * buf,
+                     const std::size_t size,
+                     std::vector< char > & out );
+
+    /*!
+      \brief check if file is open.
+      \return returns true if file is opend, else false.
+     */
+    bool is_open() const;
+
+    /*!
+      \brief get the format of the opened file.
+      \return compression format
+     */
+    Format format() const;
+
+    /*!
+      \brief open the file.
+      \param path file path
+      \param mode std::ios_base::in or std::ios_base::out.
+      \param format compression format used in the output mode. ignored in the input mode.
+      \param level compression level. DEFAULT_LEVEL means the default level of the format.
+      \return this if successfully opened, else NULL.
+     */
+    zfilebuf * open( const char * path,
+                     std::ios_base::openmode mode,
+                     const Format format = PLAIN,
+                     const int level = DEFAULT_LEVEL );
+
+    /*!
+      \brief flush the buffer and close the file.
+      \return this if successfully closed, else NULL.
+    */
+    zfilebuf * close();
+
+protected:
+
+    /*!
+      \brief synchronize stream buffer
+      \retval 0 data was successfully flushed
+      \retval -1 failed to synchronize
+    */
+    virtual
+    int sync();
+
+    /*!
+      \brief put character at current put position.
+      \param c this char is put to file.
+      \return EOF if failed.
+    */
+    virtual
+    int_type overflow( int_type c );
+
+    /*!
+      \brief get current character
+      \return current character. in the case error, returned EOF.
+     */
+    virtual
+    int_type underflow();
+
+private:
+
+    /*!
+      \brief write the buffered data to the codec.
+      \return true if successfully written.
+     */
+    bool flushBuf();
+};
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+/*!
+  \class zifstream
+  \brief compressed file input stream class. the format is detected automatically.
+*/
+class zifstream
+    : public std::istream {
+private:
+    //! underlying stream buffer.
+    zfilebuf M_file_buf;
+public:
+    /*!
+      \brief default constructor
+    */
+    zifstream();
+
+    /*!
+      \brief init stream buffer and open file.
+      \param path file path to be opened.
+     */
+    explicit
+    zifstream( const char * path );
+
+    /*!
+      \brief get underlying stream buffer.
+      \return pointer to the file buffer
+     */
+    zfilebuf * rdbuf() const
+      {
+          return const_cast< zfilebuf * >( &M_file_buf );
+      }
+
+    /*!
+      \brief check if file is open.
+      \return true if file opened.
+    */
+    bool is_open() const
+      {
+          return M_file_buf.is_open();
+      }
+
+    /*!
+      \brief open the file.
+      \param path file path.
+     */
+    void open( const char * path );
+
+    /*!
+      \brief close the file.
+     */
+    void close();
+};
+
+/*-------------------------------------------------------------------*/
+
+/*!
+  \class zofstream
+  \brief compressed file output stream class.
+*/
+class zofstream
+    : public std::ostream {
+private:
+    //! underlying stream buffer.
+    zfilebuf M_file_buf;
+
+public:
+    /*!
+      \brief default constructor
+     */
+    zofstream();
+
+    /*!
+      \brief init stream buffer and open file.
+      \param path file path.
+      \param format compression format
+      \param level compression level
+     */
+    zofstream( const char * path,
+               const zfilebuf::Format format,
+               const int level = zfilebuf::DEFAULT_LEVEL );
+
+    /*!
+      \brief get underlying stream buffer.
+      \return pointer to the file buffer.
+    */
+    zfilebuf * rdbuf() const
+      {
+          return const_cast< zfilebuf * >( &M_file_buf );
+      }
+
+    /*!
+      \brief check if file is open
+      \return true if file opened.
+     */
+    bool is_open() const
+      {
+          return M_file_buf.is_open();
+      }
+
+    /*!
+      \brief open the file.
+      \param path file path.
+      \param format compression format
+      \param level compression level
+    */
+    void open( const char * path,
+               const zfilebuf::Format format,
+               const int level = zfilebuf::DEFAULT_LEVEL );
+
+    /*!
+      \brief flush and close the file.
+    */
+    void close();
+};
+
+}
+
+#endif
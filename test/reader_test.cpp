@@ -0,0 +1,542 @@
+// -*-c++-*-
+
+/*!
+  \file reader_test.cpp
+  \brief regression test of the pull style reader.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "show_line.h"
+
+#include <rcsslogplayer/reader.h>
+#include <rcsslogplayer/parser.h>
+#include <rcsslogplayer/util.h>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+//! the number of generated frames
+const int N_FRAMES = 200;
+
+int g_failures = 0;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the text of the show data. all fields are written.
+ */
+std::string
+describe_show( const rcss::rcg::ShowInfoT & show )
+{
+    using namespace rcss::rcg;
+
+    std::ostringstream ostr;
+    ostr.precision( 9 );
+
+    ostr << "show " << show.time_
+         << ' ' << show.ball_.x_ << ' ' << show.ball_.y_
+         << ' ' << show.ball_.vx_ << ' ' << show.ball_.vy_;
+
+    for ( int i = 0; i < MAX_PLAYER*2; ++i )
+    {
+        const PlayerT & p = show.player_[i];
+        ostr << " (" << p.side_ << ' ' << p.unum_
+             << ' ' << p.type_ << ' ' << p.state_
+             << ' ' << p.x_ << ' ' << p.y_ << ' ' << p.vx_ << ' ' << p.vy_
+             << ' ' << p.body_ << ' ' << p.neck_
+             << ' ' << p.point_x_ << ' ' << p.point_y_
+             << ' ' << p.view_quality_ << ' ' << p.view_width_
+             << ' ' << p.stamina_ << ' ' << p.effort_ << ' ' << p.recovery_
+             << ' ' << p.stamina_capacity_
+             << ' ' << p.focus_side_ << ' ' << p.focus_unum_
+             << ' ' << p.kick_count_ << ' ' << p.dash_count_ << ' ' << p.turn_count_
+             << ' ' << p.catch_count_ << ' ' << p.move_count_ << ' ' << p.turn_neck_count_
+             << ' ' << p.change_view_count_ << ' ' << p.say_count_ << ' ' << p.tackle_count_
+             << ' ' << p.pointto_count_ << ' ' << p.attentionto_count_ << ')';
+    }
+
+    return ostr.str();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the text of the team info.
+ */
+std::string
+describe_team( const int time,
+               const rcss::rcg::TeamT & team_l,
+               const rcss::rcg::TeamT & team_r )
+{
+    std::ostringstream ostr;
+    ostr << "team " << time
+         << ' ' << team_l.name_ << ' ' << team_l.score_
+         << ' ' << team_l.pen_score_ << ' ' << team_l.pen_miss_
+         << ' ' << team_r.name_ << ' ' << team_r.score_
+         << ' ' << team_r.pen_score_ << ' ' << team_r.pen_miss_;
+    return ostr.str();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the text of the other records.
+ */
+std::string
+describe( const char * type,
+          const int time,
+          const int value = 0,
+          const std::string & msg = std::string() )
+{
+    std::ostringstream ostr;
+    ostr << type << ' ' << time << ' ' << value << ' ' << msg;
+    return ostr.str();
+}
+
+/*!
+  \class RecordLog
+  \brief handler that keeps the text of all records delivered by the parser.
+*/
+class RecordLog
+    : public rcss::rcg::Handler {
+private:
+    int M_log_version;
+    int M_time;
+    std::vector< std::string > M_records;
+
+public:
+
+    RecordLog()
+        : M_log_version( 0 ),
+          M_time( 0 )
+      { }
+
+    int logVersion() const
+      {
+          return M_log_version;
+      }
+
+    const
+    std::vector< std::string > & records() const
+      {
+          return M_records;
+      }
+
+private:
+
+    virtual
+    void doHandleLogVersion( int ver )
+      {
+          M_log_version = ver;
+      }
+    virtual
+    int doGetLogVersion() const
+      {
+          return M_log_version;
+      }
+    virtual
+    void doHandleShowInfo( const rcss::rcg::ShowInfoT & show )
+      {
+          M_time = show.time_;
+          M_records.push_back( describe_show( show ) );
+      }
+    virtual
+    void doHandleMsgInfo( const int time,
+                          const int board,
+                          const std::string & msg )
+      {
+          M_time = time;
+          M_records.push_back( describe( "msg", time, board, msg ) );
+      }
+    virtual
+    void doHandlePlayMode( const int time,
+                           const rcss::rcg::PlayMode pm )
+      {
+          M_time = time;
+          M_records.push_back( describe( "playmode", time, pm ) );
+      }
+    virtual
+    void doHandleTeamInfo( const int time,
+                           const rcss::rcg::TeamT & team_l,
+                           const rcss::rcg::TeamT & team_r )
+      {
+          M_time = time;
+          M_records.push_back( describe_team( time, team_l, team_r ) );
+      }
+    virtual
+    void doHandleDrawClear( const int time )
+      {
+          M_time = time;
+          M_records.push_back( describe( "clear", time ) );
+      }
+    virtual
+    void doHandleDrawPointInfo( const int time,
+                                const rcss::rcg::PointInfoT & )
+      {
+          M_time = time;
+          M_records.push_back( describe( "point", time ) );
+      }
+    virtual
+    void doHandleDrawCircleInfo( const int time,
+                                 const rcss::rcg::CircleInfoT & )
+      {
+          M_time = time;
+          M_records.push_back( describe( "circle", time ) );
+      }
+    virtual
+    void doHandleDrawLineInfo( const int time,
+                               const rcss::rcg::LineInfoT & )
+      {
+          M_time = time;
+          M_records.push_back( describe( "line", time ) );
+      }
+    virtual
+    void doHandleServerParam( const rcss::rcg::ServerParamT & )
+      {
+          M_records.push_back( describe( "server_param", M_time ) );
+      }
+    virtual
+    void doHandlePlayerParam( const rcss::rcg::PlayerParamT & )
+      {
+          M_records.push_back( describe( "player_param", M_time ) );
+      }
+    virtual
+    void doHandlePlayerType( const rcss::rcg::PlayerTypeT & )
+      {
+          M_records.push_back( describe( "player_type", M_time ) );
+      }
+    virtual
+    void doHandleEOF()
+      { }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the v5 text log. the last show line has no new line character.
+ */
+std::string
+create_text_log()
+{
+    std::string log = "ULG5\n"
+        "(msg 0 1 \"(team_graphic_l (0 0 \\\"8 8 1 1\\\"))\")\n"
+        "(playmode 0 before_kick_off)\n"
+        "(team 0 left right 0 0)\n"
+        "(draw 0 (clear))\n";
+
+    SampleGenerator generator( 20090101 );
+    rcss::rcg::DispInfoT disp;
+    std::string line;
+    for ( int n = 0; n < N_FRAMES; ++n )
+    {
+        generator.create( disp );
+        disp.show_.time_ = static_cast< rcss::rcg::UInt32 >( n + 1 );
+        serialize_disp( disp, line );
+
+        if ( n > 0 ) log += '\n';
+        log += line;
+    }
+
+    return log;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the v3 binary log.
+ */
+std::string
+create_binary_log()
+{
+    using namespace rcss::rcg;
+
+    std::string log = "ULG";
+    log += static_cast< char >( REC_VERSION_3 );
+
+    SampleGenerator generator( 20090102 );
+    DispInfoT disp;
+    for ( int n = 0; n < N_FRAMES; ++n )
+    {
+        generator.create( disp );
+
+        const Int16 mode = hitons( SHOW_MODE );
+        short_showinfo_t2 show;
+        convert( disp.show_.ball_, show.ball );
+        for ( int i = 0; i < MAX_PLAYER*2; ++i )
+        {
+            convert( disp.show_.player_[i], show.pos[i] );
+        }
+        show.time = hitons( n + 1 );
+
+        log.append( reinterpret_cast< const char * >( &mode ), sizeof( mode ) );
+        log.append( reinterpret_cast< const char * >( &show ), sizeof( show ) );
+    }
+
+    return log;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief pull the records from the reader until NULL is returned.
+  \param max_count the maximum number of records. negative value means no limit.
+ */
+void
+read_records( rcss::rcg::Reader & reader,
+              std::vector< std::string > & records,
+              const int max_count = -1 )
+{
+    using rcss::rcg::Reader;
+
+    const rcss::rcg::ShowInfoT * slot = 0;
+
+    while ( max_count < 0
+            || static_cast< int >( records.size() ) < max_count )
+    {
+        const Reader::Record * rec = reader.next();
+        if ( ! rec )
+        {
+            // the end of input is sticky.
+            if ( reader.next() )
+            {
+                ++g_failures;
+                std::cerr << "Reader::next() returned a record after NULL" << std::endl;
+            }
+            break;
+        }
+
+        switch ( rec->type() ) {
+        case Reader::SHOW:
+            // one parse() call gives at most one show, so the reused slot never moves.
+            if ( slot && slot != &rec->show() )
+            {
+                ++g_failures;
+                std::cerr << "show slot is reallocated at " << rec->time() << std::endl;
+            }
+            slot = &rec->show();
+            records.push_back( describe_show( rec->show() ) );
+            break;
+        case Reader::MSG:
+            records.push_back( describe( "msg", rec->time(), rec->board(), rec->msg() ) );
+            break;
+        case Reader::PLAYMODE:
+            records.push_back( describe( "playmode", rec->time(), rec->playMode() ) );
+            break;
+        case Reader::TEAM:
+            records.push_back( describe_team( rec->time(), rec->teamLeft(), rec->teamRight() ) );
+            break;
+        case Reader::DRAW_CLEAR:
+            records.push_back( describe( "clear", rec->time() ) );
+            break;
+        case Reader::DRAW_POINT:
+            records.push_back( describe( "point", rec->time() ) );
+            break;
+        case Reader::DRAW_CIRCLE:
+            records.push_back( describe( "circle", rec->time() ) );
+            break;
+        case Reader::DRAW_LINE:
+            records.push_back( describe( "line", rec->time() ) );
+            break;
+        case Reader::SERVER_PARAM:
+            records.push_back( describe( "server_param", rec->time() ) );
+            break;
+        case Reader::PLAYER_PARAM:
+            records.push_back( describe( "player_param", rec->time() ) );
+            break;
+        case Reader::PLAYER_TYPE:
+            records.push_back( describe( "player_type", rec->time() ) );
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief count the show records.
+ */
+int
+count_shows( const std::vector< std::string > & records )
+{
+    int count = 0;
+    for ( std::vector< std::string >::const_iterator it = records.begin(), end = records.end();
+          it != end;
+          ++it )
+    {
+        if ( it->compare( 0, 5, "show " ) == 0 ) ++count;
+    }
+    return count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief compare the records given by the reader with the records given to the handler.
+  \param name test case name
+  \param data whole log data
+  \param version expected log version
+  \param n_shows expected number of the show records
+ */
+void
+check_log( const char * name,
+           const std::string & data,
+           const int version,
+           const int n_shows )
+{
+    using namespace rcss::rcg;
+
+    // push style, memory block
+    RecordLog mem_log;
+    {
+        Parser parser( mem_log );
+        std::size_t pos = 0;
+        while ( parser.parse( data.data(), data.length(), pos ) )
+        {
+
+        }
+    }
+
+    // push style, stream
+    RecordLog stream_log;
+    {
+        std::istringstream is( data );
+        Parser parser( stream_log );
+        while ( parser.parse( is ) )
+        {
+
+        }
+    }
+
+    // pull style
+    std::vector< std::string > mem_records;
+    std::vector< std::string > stream_records;
+    std::vector< std::string > head_records;
+    int mem_version = 0;
+    int stream_version = 0;
+    {
+        Reader reader( data.data(), data.length() );
+        read_records( reader, mem_records );
+        mem_version = reader.logVersion();
+    }
+    {
+        std::istringstream is( data );
+        Reader reader( is );
+        read_records( reader, stream_records );
+        stream_version = reader.logVersion();
+    }
+    {
+        // stop reading before the end of input
+        Reader reader( data.data(), data.length() );
+        read_records( reader, head_records, 10 );
+    }
+
+    const int n_failures = g_failures;
+
+    if ( mem_version != version
+         || stream_version != version
+         || mem_log.logVersion() != version )
+    {
+        ++g_failures;
+        std::cerr << name << ": log version " << mem_version << ' ' << stream_version
+                  << " != " << version << std::endl;
+    }
+
+    if ( count_shows( mem_log.records() ) != n_shows
+         || count_shows( stream_log.records() ) != n_shows )
+    {
+        ++g_failures;
+        std::cerr << name << ": handler got " << count_shows( mem_log.records() )
+                  << ' ' << count_shows( stream_log.records() )
+                  << " shows. expected " << n_shows << std::endl;
+    }
+
+    if ( mem_records != mem_log.records() )
+    {
+        ++g_failures;
+        std::cerr << name << ": memory block records differ. "
+                  << mem_records.size() << " != " << mem_log.records().size() << std::endl;
+    }
+
+    if ( stream_records != stream_log.records() )
+    {
+        ++g_failures;
+        std::cerr << name << ": stream records differ. "
+                  << stream_records.size() << " != " << stream_log.records().size() << std::endl;
+    }
+
+    if ( head_records.size() != 10
+         || ! std::equal( head_records.begin(), head_records.end(), mem_log.records().begin() ) )
+    {
+        ++g_failures;
+        std::cerr << name << ": first records differ." << std::endl;
+    }
+
+    if ( g_failures == n_failures )
+    {
+        std::cout << name << ": " << mem_records.size() << " records OK" << std::endl;
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+main()
+{
+    using namespace rcss::rcg;
+
+    const std::string text = create_text_log();
+    check_log( "v5 text", text, REC_VERSION_5, N_FRAMES );
+
+    // the last show line is cut in the middle of the players.
+    const std::size_t last_line = text.rfind( '\n' ) + 1;
+    check_log( "v5 text, partial last line",
+               text.substr( 0, last_line + ( text.length() - last_line ) / 2 ),
+               REC_VERSION_5, N_FRAMES - 1 );
+
+    const std::string binary = create_binary_log();
+    check_log( "v3 binary", binary, REC_VERSION_3, N_FRAMES );
+
+    // the last show record is cut in the middle.
+    check_log( "v3 binary, partial last record",
+               binary.substr( 0, binary.length() - sizeof( short_showinfo_t2 ) / 2 ),
+               REC_VERSION_3, N_FRAMES - 1 );
+
+    if ( g_failures > 0 )
+    {
+        std::cerr << g_failures << " failures" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+// -*-c++-*-
+
+/*!
+  \file scan_number_bench.cpp
+  \brief benchmark of the show line number scanners against strtof/strtol.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "show_line.h"
+
+#include <rcsslogplayer/scan_number.h>
+#include <rcsslogplayer/parser.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+namespace {
+
+//! the number of generated show lines
+const int N_LINES = 2000;
+//! the number of repetitions of each measurement
+const int N_REPEAT = 20;
+
+double
+elapsed_ns( const std::clock_t start,
+            const double count )
+{
+    return ( std::clock() - start ) * 1.0e9 / CLOCKS_PER_SEC / count;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+main()
+{
+    SampleGenerator generator( 20090101 );
+    rcss::rcg::DispInfoT disp;
+
+    std::vector< std::string > lines( N_LINES );
+    for ( int n = 0; n < N_LINES; ++n )
+    {
+        generator.create( disp );
+        serialize_disp( disp, lines[n] );
+    }
+
+    // the head of each number. real values and integers are separated.
+    std::vector< const char * > reals;
+    std::vector< const char * > integers;
+    for ( int n = 0; n < N_LINES; ++n )
+    {
+        const char * buf = lines[n].c_str();
+        for ( const char * p = buf; *p; ++p )
+        {
+            if ( ( p != buf && *( p - 1 ) != ' ' )
+                 || ! ( ( '0' <= *p && *p <= '9' ) || *p == '-' ) )
+            {
+                continue;
+            }
+
+            const char * e = p;
+            while ( *e && *e != ' ' && *e != ')' && *e != '.' ) ++e;
+            if ( *e == '.' )
+            {
+                reals.push_back( p );
+            }
+            else
+            {
+                integers.push_back( p );
+            }
+        }
+    }
+
+    const double n_reals = static_cast< double >( reals.size() ) * N_REPEAT;
+    const double n_integers = static_cast< double >( integers.size() ) * N_REPEAT;
+    double sum = 0.0;
+    char * next = 0;
+
+    std::clock_t start = std::clock();
+    for ( int r = 0; r < N_REPEAT; ++r )
+    {
+        for ( std::size_t i = 0; i < reals.size(); ++i )
+        {
+            sum += strtof( reals[i], &next );
+        }
+    }
+    const double strtof_ns = elapsed_ns( start, n_reals );
+
+    start = std::clock();
+    for ( int r = 0; r < N_REPEAT; ++r )
+    {
+        for ( std::size_t i = 0; i < reals.size(); ++i )
+        {
+            sum += rcss::rcg::scan_float( reals[i], &next );
+        }
+    }
+    const double scan_float_ns = elapsed_ns( start, n_reals );
+
+    start = std::clock();
+    for ( int r = 0; r < N_REPEAT; ++r )
+    {
+        for ( std::size_t i = 0; i < integers.size(); ++i )
+        {
+            sum += std::strtol( integers[i], &next, 10 );
+        }
+    }
+    const double strtol_ns = elapsed_ns( start, n_integers );
+
+    start = std::clock();
+    for ( int r = 0; r < N_REPEAT; ++r )
+    {
+        for ( std::size_t i = 0; i < integers.size(); ++i )
+        {
+            sum += rcss::rcg::scan_long( integers[i], &next, 10 );
+        }
+    }
+    const double scan_long_ns = elapsed_ns( start, n_integers );
+
+    // whole show line
+    ShowCollector collector;
+    rcss::rcg::Parser parser( collector );
+    start = std::clock();
+    for ( int r = 0; r < N_REPEAT; ++r )
+    {
+        for ( int n = 0; n < N_LINES; ++n )
+        {
+            parser.parseLine( -1, lines[n].c_str(), lines[n].length() );
+        }
+    }
+    const double line_ns = elapsed_ns( start, static_cast< double >( N_LINES ) * N_REPEAT );
+
+    std::printf( "%lu reals, %lu integers in %d show lines\n",
+                 static_cast< unsigned long >( reals.size() ),
+                 static_cast< unsigned long >( integers.size() ),
+                 N_LINES );
+    std::printf( "strtof     %7.1f ns/number\n", strtof_ns );
+    std::printf( "scan_float %7.1f ns/number  (x%.2f)\n", scan_float_ns, strtof_ns / scan_float_ns );
+    std::printf( "strtol     %7.1f ns/number\n", strtol_ns );
+    std::printf( "scan_long  %7.1f ns/number  (x%.2f)\n", scan_long_ns, strtol_ns / scan_long_ns );
+    std::printf( "show line  %7.0f ns/line (%lu lines parsed)\n",
+                 line_ns, static_cast< unsigned long >( collector.showCount() ) );
+    std::printf( "(checksum %g)\n", sum );
+
+    return 0;
+}
@@ -0,0 +1,323 @@
+// -*-c++-*-
+
+/*!
+  \file scan_number_test.cpp
+  \brief regression test of the show line number scanners.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "show_line.h"
+
+#include <rcsslogplayer/scan_number.h>
+#include <rcsslogplayer/parser.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+//! the number of generated show lines
+const int N_LINES = 2000;
+
+int g_failures = 0;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check that scan_float() gives the same bits and end position as strtof().
+ */
+void
+check_float( const char * buf )
+{
+    char * scan_end = 0;
+    char * libc_end = 0;
+    const float scan_value = rcss::rcg::scan_float( buf, &scan_end );
+    const float libc_value = strtof( buf, &libc_end );
+
+    if ( std::memcmp( &scan_value, &libc_value, sizeof( float ) ) != 0
+         || scan_end != libc_end )
+    {
+        if ( ++g_failures <= 10 )
+        {
+            std::cerr << "scan_float mismatch [" << std::string( buf ).substr( 0, 24 )
+                      << "] " << scan_value << " != " << libc_value << std::endl;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check that scan_long() gives the same value and end position as strtol().
+ */
+void
+check_long( const char * buf,
+            const int base )
+{
+    char * scan_end = 0;
+    char * libc_end = 0;
+    const long scan_value = rcss::rcg::scan_long( buf, &scan_end, base );
+    const long libc_value = std::strtol( buf, &libc_end, base );
+
+    if ( scan_value != libc_value
+         || scan_end != libc_end )
+    {
+        if ( ++g_failures <= 10 )
+        {
+            std::cerr << "scan_long mismatch [" << std::string( buf ).substr( 0, 24 )
+                      << "] base=" << base
+                      << ' ' << scan_value << " != " << libc_value << std::endl;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check every number in the line at its position in the line.
+ */
+void
+check_line_numbers( const std::string & line )
+{
+    const char * buf = line.c_str();
+    for ( std::size_t i = 0; i < line.length(); ++i )
+    {
+        const char c = buf[i];
+        const bool head = ( i == 0
+                            || buf[i - 1] == ' '
+                            || buf[i - 1] == '(' );
+        if ( ! head
+             || ! ( ( '0' <= c && c <= '9' ) || c == '-' || c == '+' || c == '.' ) )
+        {
+            continue;
+        }
+
+        // the scanners are called from the space before the number, too.
+        const char * start = ( i > 0 && buf[i - 1] == ' ' ? buf + i - 1 : buf + i );
+        check_float( start );
+        check_long( start, 10 );
+        check_long( start, 16 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief the parsed value must be the value that strtof() reads from the printed text.
+ */
+void
+check_value( const char * name,
+             const float parsed,
+             const float value )
+{
+    std::ostringstream ostr;
+    ostr << value;
+    const float expected = strtof( ostr.str().c_str(), 0 );
+
+    if ( std::memcmp( &parsed, &expected, sizeof( float ) ) != 0 )
+    {
+        if ( ++g_failures <= 10 )
+        {
+            std::cerr << "round trip mismatch " << name << ' '
+                      << parsed << " != " << ostr.str() << std::endl;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief parse the show line and compare it with the original data.
+  \param safe_mode if true, the line is parsed by the safe decoder.
+ */
+void
+check_round_trip( const rcss::rcg::DispInfoT & disp,
+                  const std::string & line,
+                  const bool safe_mode )
+{
+    using namespace rcss::rcg;
+
+    const float PREC = 0.0001f;
+    const float DPREC = 0.001f;
+
+    ShowCollector collector;
+    Parser parser( collector );
+    parser.setSafeMode( safe_mode );
+    const std::size_t count = collector.showCount();
+    if ( ! parser.parseLine( -1, line.c_str(), line.length() )
+         || collector.showCount() != count + 1 )
+    {
+        ++g_failures;
+        std::cerr << "failed to parse [" << line.substr( 0, 64 ) << "...]" << std::endl;
+        return;
+    }
+
+    const ShowInfoT & show = collector.show();
+
+    if ( show.time_ != disp.show_.time_ )
+    {
+        ++g_failures;
+        std::cerr << "time mismatch " << show.time_ << std::endl;
+    }
+
+    if ( collector.playmode() != disp.pmode_ )
+    {
+        ++g_failures;
+        std::cerr << "playmode mismatch " << collector.playmode() << std::endl;
+    }
+
+    for ( int i = 0; i < 2; ++i )
+    {
+        if ( ! collector.team( i ).equals( disp.team_[i] ) )
+        {
+            if ( ++g_failures <= 10 )
+            {
+                std::cerr << "team mismatch " << i
+                          << " [" << line.substr( 0, 64 ) << "...]" << std::endl;
+            }
+        }
+    }
+
+    check_value( "ball x", show.ball_.x_, quantize( disp.show_.ball_.x_, PREC ) );
+    check_value( "ball y", show.ball_.y_, quantize( disp.show_.ball_.y_, PREC ) );
+    check_value( "ball vx", show.ball_.vx_, quantize( disp.show_.ball_.vx_, PREC ) );
+    check_value( "ball vy", show.ball_.vy_, quantize( disp.show_.ball_.vy_, PREC ) );
+
+    for ( int i = 0; i < MAX_PLAYER*2; ++i )
+    {
+        const PlayerT & p = show.player_[i];
+        const PlayerT & o = disp.show_.player_[i];
+
+        if ( p.side_ != o.side_
+             || p.unum_ != o.unum_
+             || p.type_ != o.type_
+             || p.state_ != o.state_
+             || p.view_quality_ != o.view_quality_
+             || p.focus_side_ != o.focus_side_
+             || p.focus_unum_ != o.focus_unum_
+             || p.kick_count_ != o.kick_count_
+             || p.dash_count_ != o.dash_count_
+             || p.turn_count_ != o.turn_count_
+             || p.catch_count_ != o.catch_count_
+             || p.move_count_ != o.move_count_
+             || p.turn_neck_count_ != o.turn_neck_count_
+             || p.change_view_count_ != o.change_view_count_
+             || p.say_count_ != o.say_count_
+             || p.tackle_count_ != o.tackle_count_
+             || p.pointto_count_ != o.pointto_count_
+             || p.attentionto_count_ != o.attentionto_count_ )
+        {
+            if ( ++g_failures <= 10 )
+            {
+                std::cerr << "integer field mismatch player " << i << std::endl;
+            }
+        }
+
+        check_value( "x", p.x_, quantize( o.x_, PREC ) );
+        check_value( "y", p.y_, quantize( o.y_, PREC ) );
+        check_value( "vx", p.vx_, quantize( o.vx_, PREC ) );
+        check_value( "vy", p.vy_, quantize( o.vy_, PREC ) );
+        check_value( "body", p.body_, quantize( o.body_, DPREC ) );
+        check_value( "neck", p.neck_, quantize( o.neck_, DPREC ) );
+        if ( o.isPointing() )
+        {
+            check_value( "point x", p.point_x_, quantize( o.point_x_, PREC ) );
+            check_value( "point y", p.point_y_, quantize( o.point_y_, PREC ) );
+        }
+        else if ( p.isPointing() )
+        {
+            ++g_failures;
+            std::cerr << "unexpected pointing player " << i << std::endl;
+        }
+        check_value( "view width", p.view_width_, quantize( o.view_width_, DPREC ) );
+        check_value( "stamina", p.stamina_, quantize( o.stamina_, 0.001f ) );
+        check_value( "effort", p.effort_, quantize( o.effort_, 0.0001f ) );
+        check_value( "recovery", p.recovery_, quantize( o.recovery_, 0.0001f ) );
+        check_value( "capacity", p.stamina_capacity_, quantize( o.stamina_capacity_, 0.001f ) );
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+main()
+{
+    // unusual formats are delegated to the C library.
+    const char * const float_cases[] = {
+        "0", "-0", "0.0", "-0.0", "+3.25", ".5", "-.5", "5.", "0.1", "-0.0001",
+        "1e5", "1.5E-3", "-2.5e+2", "0x1A", "nan", "inf", "-inf", "", "-", ".",
+        "123456789", "1234567890", "16777216", "16777217", "-16777217",
+        "0.00000000001", "1.0000000001", "99999999.9", "3.4028235e38", "1e39",
+        "12345.6789", "8000", "130600", "1.306e+06", " 12.5", "  -7.25)", "\t5",
+        0
+    };
+    const char * const long_cases[] = {
+        "0", "-0", "+12", "2147483647", "-2147483648", "99999999999", "1e3",
+        "0x7fffffff", "0xffffffff", "0x", "0X1F", "ff", "-0x10", "", "-",
+        "123456789", "1234567890", " 42)", "007",
+        0
+    };
+
+    for ( int i = 0; float_cases[i]; ++i )
+    {
+        check_float( float_cases[i] );
+    }
+
+    for ( int i = 0; long_cases[i]; ++i )
+    {
+        check_long( long_cases[i], 10 );
+        check_long( long_cases[i], 16 );
+    }
+
+    SampleGenerator generator( 20090101 );
+    rcss::rcg::DispInfoT disp;
+    std::string line;
+    for ( int n = 0; n < N_LINES; ++n )
+    {
+        generator.create( disp );
+        serialize_disp( disp, line );
+
+        check_line_numbers( line );
+        check_round_trip( disp, line, false );
+        check_round_trip( disp, line, true );
+    }
+
+    if ( g_failures > 0 )
+    {
+        std::cerr << g_failures << " failures" << std::endl;
+        return 1;
+    }
+
+    std::cout << "scan_number_test: " << N_LINES << " show lines OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,379 @@
+// -*-c++-*-
+
+/*!
+  \file show_line.h
+  \brief sample show line generator for the tests and the benchmarks.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSSLOGPLAYER_TEST_SHOW_LINE_H
+#define RCSSLOGPLAYER_TEST_SHOW_LINE_H
+
+#include <rcsslogplayer/types.h>
+#include <rcsslogplayer/handler.h>
+
+#include <sstream>
+#include <string>
+#include <cmath>
+
+/*!
+  \class SampleGenerator
+  \brief deterministic generator of the display data in the range of the real game.
+*/
+class SampleGenerator {
+private:
+    unsigned long M_state;
+
+public:
+
+    explicit
+    SampleGenerator( const unsigned long seed )
+        : M_state( seed )
+      { }
+
+    /*!
+      \brief get the next random value
+      \return value in [0, 2^31)
+     */
+    unsigned long next()
+      {
+          // LCG used by glibc rand_r(). the result does not depend on the platform.
+          M_state = ( M_state * 1103515245ul + 12345ul ) & 0xfffffffful;
+          return ( M_state >> 1 ) & 0x7ffffffful;
+      }
+
+    double uniform( const double min,
+                    const double max )
+      {
+          return min + ( max - min ) * ( next() / 2147483648.0 );
+      }
+
+    int uniformInt( const int min,
+                    const int max )
+      {
+          return min + static_cast< int >( next() % static_cast< unsigned long >( max - min + 1 ) );
+      }
+
+    /*!
+      \brief create the display data
+      \param disp reference to the result variable
+     */
+    void create( rcss::rcg::DispInfoT & disp )
+      {
+          using namespace rcss::rcg;
+
+          disp.pmode_ = static_cast< PlayMode >( uniformInt( PM_BeforeKickOff, PM_PlayOn ) );
+          disp.team_[0] = TeamT( "left", uniformInt( 0, 10 ), 0, 0 );
+          disp.team_[1] = TeamT( "right", uniformInt( 0, 10 ), 0, 0 );
+          if ( uniformInt( 0, 3 ) == 0 )
+          {
+              // penalty shootouts
+              disp.team_[0].pen_score_ = static_cast< UInt16 >( uniformInt( 0, 5 ) );
+              disp.team_[0].pen_miss_ = static_cast< UInt16 >( uniformInt( 0, 5 ) );
+              disp.team_[1].pen_score_ = static_cast< UInt16 >( uniformInt( 0, 5 ) );
+              disp.team_[1].pen_miss_ = static_cast< UInt16 >( uniformInt( 0, 5 ) );
+          }
+
+          ShowInfoT & show = disp.show_;
+          show.time_ = static_cast< UInt32 >( uniformInt( 0, 6000 ) );
+          show.ball_.x_ = static_cast< float >( uniform( -55.0, 55.0 ) );
+          show.ball_.y_ = static_cast< float >( uniform( -35.0, 35.0 ) );
+          show.ball_.vx_ = static_cast< float >( uniform( -3.0, 3.0 ) );
+          show.ball_.vy_ = static_cast< float >( uniform( -3.0, 3.0 ) );
+
+          for ( int i = 0; i < MAX_PLAYER*2; ++i )
+          {
+              PlayerT & p = show.player_[i];
+              p.side_ = ( i < MAX_PLAYER ? 'l' : 'r' );
+              p.unum_ = static_cast< Int16 >( i % MAX_PLAYER + 1 );
+              p.type_ = static_cast< Int16 >( uniformInt( 0, 17 ) );
+              p.state_ = STAND | ( uniformInt( 0, 9 ) == 0 ? KICK : 0 );
+              p.x_ = static_cast< float >( uniform( -55.0, 55.0 ) );
+              p.y_ = static_cast< float >( uniform( -35.0, 35.0 ) );
+              p.vx_ = static_cast< float >( uniform( -1.2, 1.2 ) );
+              p.vy_ = static_cast< float >( uniform( -1.2, 1.2 ) );
+              p.body_ = static_cast< float >( uniform( -180.0, 180.0 ) );
+              p.neck_ = static_cast< float >( uniform( -90.0, 90.0 ) );
+              if ( uniformInt( 0, 3 ) == 0 )
+              {
+                  p.point_x_ = static_cast< float >( uniform( -55.0, 55.0 ) );
+                  p.point_y_ = static_cast< float >( uniform( -35.0, 35.0 ) );
+              }
+              else
+              {
+                  p.point_x_ = SHOWINFO_SCALE2F;
+                  p.point_y_ = SHOWINFO_SCALE2F;
+              }
+              p.view_quality_ = ( uniformInt( 0, 1 ) == 0 ? 'h' : 'l' );
+              p.view_width_ = static_cast< float >( 60 * uniformInt( 1, 3 ) );
+              p.stamina_ = static_cast< float >( uniform( 0.0, 8000.0 ) );
+              p.effort_ = static_cast< float >( uniform( 0.6, 1.0 ) );
+              p.recovery_ = static_cast< float >( uniform( 0.5, 1.0 ) );
+              p.stamina_capacity_ = static_cast< float >( uniform( 0.0, 130600.0 ) );
+              if ( uniformInt( 0, 3 ) == 0 )
+              {
+                  p.focus_side_ = ( uniformInt( 0, 1 ) == 0 ? 'l' : 'r' );
+                  p.focus_unum_ = static_cast< Int16 >( uniformInt( 1, MAX_PLAYER ) );
+              }
+              else
+              {
+                  p.focus_side_ = 'n';
+                  p.focus_unum_ = 0;
+              }
+              p.kick_count_ = static_cast< UInt16 >( uniformInt( 0, 9999 ) );
+              p.dash_count_ = static_cast< UInt16 >( uniformInt( 0, 9999 ) );
+              p.turn_count_ = static_cast< UInt16 >( uniformInt( 0, 9999 ) );
+              p.catch_count_ = static_cast< UInt16 >( uniformInt( 0, 99 ) );
+              p.move_count_ = static_cast< UInt16 >( uniformInt( 0, 99 ) );
+              p.turn_neck_count_ = static_cast< UInt16 >( uniformInt( 0, 9999 ) );
+              p.change_view_count_ = static_cast< UInt16 >( uniformInt( 0, 999 ) );
+              p.say_count_ = static_cast< UInt16 >( uniformInt( 0, 999 ) );
+              p.tackle_count_ = static_cast< UInt16 >( uniformInt( 0, 99 ) );
+              p.pointto_count_ = static_cast< UInt16 >( uniformInt( 0, 999 ) );
+              p.attentionto_count_ = static_cast< UInt16 >( uniformInt( 0, 999 ) );
+          }
+      }
+};
+
+/*!
+  \class ShowCollector
+  \brief handler that keeps the last show data and counts the show records.
+*/
+class ShowCollector
+    : public rcss::rcg::Handler {
+private:
+    int M_log_version;
+    rcss::rcg::PlayMode M_playmode;
+    rcss::rcg::TeamT M_team[2];
+    rcss::rcg::ShowInfoT M_show;
+    std::size_t M_show_count;
+
+public:
+
+    ShowCollector()
+        : M_log_version( rcss::rcg::REC_VERSION_4 ),
+          M_playmode( rcss::rcg::PM_Null ),
+          M_show_count( 0 )
+      { }
+
+    rcss::rcg::PlayMode playmode() const
+      {
+          return M_playmode;
+      }
+
+    const
+    rcss::rcg::TeamT & team( const int i ) const
+      {
+          return M_team[i];
+      }
+
+    const
+    rcss::rcg::ShowInfoT & show() const
+      {
+          return M_show;
+      }
+
+    std::size_t showCount() const
+      {
+          return M_show_count;
+      }
+
+private:
+
+    virtual
+    void doHandleLogVersion( int ver )
+      {
+          M_log_version = ver;
+      }
+    virtual
+    int doGetLogVersion() const
+      {
+          return M_log_version;
+      }
+    virtual
+    void doHandleShowInfo( const rcss::rcg::ShowInfoT & show )
+      {
+          M_show = show;
+          ++M_show_count;
+      }
+    virtual
+    void doHandleMsgInfo( const int,
+                          const int,
+                          const std::string & )
+      { }
+    virtual
+    void doHandlePlayMode( const int,
+                           const rcss::rcg::PlayMode pm )
+      {
+          M_playmode = pm;
+      }
+    virtual
+    void doHandleTeamInfo( const int,
+                           const rcss::rcg::TeamT & team_l,
+                           const rcss::rcg::TeamT & team_r )
+      {
+          M_team[0] = team_l;
+          M_team[1] = team_r;
+      }
+    virtual
+    void doHandleDrawClear( const int )
+      { }
+    virtual
+    void doHandleDrawPointInfo( const int,
+                                const rcss::rcg::PointInfoT & )
+      { }
+    virtual
+    void doHandleDrawCircleInfo( const int,
+                                 const rcss::rcg::CircleInfoT & )
+      { }
+    virtual
+    void doHandleDrawLineInfo( const int,
+                               const rcss::rcg::LineInfoT & )
+      { }
+    virtual
+    void doHandleServerParam( const rcss::rcg::ServerParamT & )
+      { }
+    virtual
+    void doHandlePlayerParam( const rcss::rcg::PlayerParamT & )
+      { }
+    virtual
+    void doHandlePlayerType( const rcss::rcg::PlayerTypeT & )
+      { }
+    virtual
+    void doHandleEOF()
+      { }
+};
+
+/*!
+  \brief round the value in the same way as the monitor server
+  \param val value
+  \param prec precision
+  \return rounded value
+ */
+inline
+float
+quantize( const float & val,
+          const float & prec )
+{
+    return rintf( val / prec ) * prec;
+}
+
+/*!
+  \brief create the show line in the same format as RemoteMonitor::serializeDisp() (qt4)
+  for the monitor protocol version 4 or later.
+  \param disp display data
+  \param msg reference to the result variable
+ */
+inline
+void
+serialize_disp( const rcss::rcg::DispInfoT & disp,
+                std::string & msg )
+{
+    const float PREC = 0.0001f;
+    const float DPREC = 0.001f;
+
+    std::ostringstream ostr;
+
+    ostr << "(show " << disp.show_.time_;
+
+    ostr << " (pm " << disp.pmode_ << ")";
+    ostr << " (tm"
+         << ' ' << ( disp.team_[0].name_.empty() ? "null" : disp.team_[0].name_.c_str() )
+         << ' ' << ( disp.team_[1].name_.empty() ? "null" : disp.team_[1].name_.c_str() )
+         << ' ' << disp.team_[0].score_
+         << ' ' << disp.team_[1].score_;
+    if ( disp.team_[0].penaltyTrial() > 0
+         || disp.team_[1].penaltyTrial() > 0 )
+    {
+        ostr << ' ' << disp.team_[0].pen_score_
+             << ' ' << disp.team_[0].pen_miss_
+             << ' ' << disp.team_[1].pen_score_
+             << ' ' << disp.team_[1].pen_miss_;
+    }
+    ostr << ')';
+
+    ostr << " ((b)"
+         << ' ' << quantize( disp.show_.ball_.x_, PREC )
+         << ' ' << quantize( disp.show_.ball_.y_, PREC )
+         << ' ' << quantize( disp.show_.ball_.vx_, PREC )
+         << ' ' << quantize( disp.show_.ball_.vy_, PREC )
+         << ')';
+
+    for ( int i = 0; i < rcss::rcg::MAX_PLAYER*2; ++i )
+    {
+        const rcss::rcg::PlayerT & p = disp.show_.player_[i];
+
+        ostr << " ("
+             << '(' << p.side_ << ' ' << p.unum_ << ')'
+             << ' ' << p.type_
+             << ' ' << std::hex << std::showbase << p.state_ << std::dec << std::noshowbase;
+        ostr << ' ' << quantize( p.x_, PREC )
+             << ' ' << quantize( p.y_, PREC )
+             << ' ' << quantize( p.vx_, PREC )
+             << ' ' << quantize( p.vy_, PREC )
+             << ' ' << quantize( p.body_, DPREC )
+             << ' ' << quantize( p.neck_, DPREC );
+        if ( p.isPointing() )
+        {
+            ostr << ' ' << quantize( p.point_x_, PREC )
+                 << ' ' << quantize( p.point_y_, PREC );
+        }
+
+        ostr << " (v " << p.view_quality_ << ' ' << quantize( p.view_width_, DPREC ) << ')';
+
+        ostr << " (s "
+             << quantize( p.stamina_, 0.001f ) << ' '
+             << quantize( p.effort_, 0.0001f ) << ' '
+             << quantize( p.recovery_, 0.0001f ) << ' '
+             << quantize( p.stamina_capacity_, 0.001f )
+             << ')';
+
+        if ( p.isFocusing() )
+        {
+            ostr << " (f " << p.focus_side_ << ' ' << p.focus_unum_ << ')';
+        }
+
+        ostr << " (c "
+             << p.kick_count_ << ' '
+             << p.dash_count_ << ' '
+             << p.turn_count_ << ' '
+             << p.catch_count_ << ' '
+             << p.move_count_ << ' '
+             << p.turn_neck_count_ << ' '
+             << p.change_view_count_ << ' '
+             << p.say_count_ << ' '
+             << p.tackle_count_ << ' '
+             << p.pointto_count_ << ' '
+             << p.attentionto_count_ << ')';
+        ostr << ')';
+    }
+    ostr << ')';
+
+    msg = ostr.str();
+}
+
+#endif
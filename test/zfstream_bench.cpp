@@ -0,0 +1,211 @@
+// -*-c++-*-
+
+/*!
+  \file zfstream_bench.cpp
+  \brief benchmark of the compressed log formats: ratio and decode speed.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsslogplayer/zfstream.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+//! the number of repetitions of each decode measurement
+const int N_REPEAT = 3;
+
+double
+elapsed_sec( const std::clock_t start )
+{
+    return static_cast< double >( std::clock() - start ) / CLOCKS_PER_SEC;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief read the whole file through zifstream
+  \param path file path
+  \param data reference to the result container
+  \return true if successfully read
+ */
+bool
+read_all( const std::string & path,
+          std::vector< char > & data )
+{
+    rcss::zifstream fin( path.c_str() );
+    if ( ! fin.is_open() )
+    {
+        return false;
+    }
+
+    data.clear();
+    char buf[65536];
+    while ( fin.read( buf, sizeof( buf ) ) || fin.gcount() > 0 )
+    {
+        data.insert( data.end(), buf, buf + fin.gcount() );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief read the raw bytes of the file
+ */
+bool
+read_raw( const std::string & path,
+          std::vector< char > & data )
+{
+    std::ifstream fin( path.c_str(), std::ios_base::in | std::ios_base::binary );
+    if ( ! fin )
+    {
+        return false;
+    }
+
+    fin.seekg( 0, std::ios_base::end );
+    data.resize( static_cast< std::size_t >( fin.tellg() ) );
+    fin.seekg( 0 );
+    return ( data.empty()
+             || fin.read( &data[0], data.size() ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief compress the data in one format, and measure the decode speed.
+ */
+void
+bench( const std::vector< char > & data,
+       const rcss::zfilebuf::Format format,
+       const char * name,
+       const char * ext )
+{
+    if ( ! rcss::zfilebuf::isSupported( format ) )
+    {
+        std::printf( "%-6s not supported in this build\n", name );
+        return;
+    }
+
+    const std::string path = std::string( "zfstream_bench.tmp" ) + ext;
+    const double mb = data.size() / ( 1024.0 * 1024.0 );
+
+    std::clock_t start = std::clock();
+    {
+        rcss::zofstream fout( path.c_str(), format );
+        fout.write( &data[0], data.size() );
+    }
+    const double compress_sec = elapsed_sec( start );
+
+    std::vector< char > compressed;
+    if ( ! read_raw( path, compressed )
+         || compressed.empty() )
+    {
+        std::printf( "%-6s failed to write %s\n", name, path.c_str() );
+        std::remove( path.c_str() );
+        return;
+    }
+
+    // stream decode through zifstream
+    std::vector< char > out;
+    start = std::clock();
+    for ( int r = 0; r < N_REPEAT; ++r )
+    {
+        read_all( path, out );
+    }
+    const double stream_sec = elapsed_sec( start ) / N_REPEAT;
+    const bool stream_ok = ( out == data );
+
+    // decode in the memory, as MappedFile does. plain data is used as is.
+    double memory_mb_per_sec = 0.0;
+    bool memory_ok = true;
+    if ( format != rcss::zfilebuf::PLAIN )
+    {
+        start = std::clock();
+        for ( int r = 0; r < N_REPEAT; ++r )
+        {
+            rcss::zfilebuf::decompress( &compressed[0], compressed.size(), out );
+        }
+        memory_mb_per_sec = mb / ( elapsed_sec( start ) / N_REPEAT );
+        memory_ok = ( out == data );
+    }
+
+    std::remove( path.c_str() );
+
+    std::printf( "%-6s %10lu bytes  ratio %5.2f  compress %7.2f s"
+                 "  decode(stream) %7.1f MB/s  decode(memory) %7.1f MB/s%s\n",
+                 name,
+                 static_cast< unsigned long >( compressed.size() ),
+                 static_cast< double >( data.size() ) / compressed.size(),
+                 compress_sec,
+                 mb / stream_sec,
+                 memory_mb_per_sec,
+                 ( stream_ok && memory_ok ? "" : "  MISMATCH" ) );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+main( int argc,
+      char ** argv )
+{
+    if ( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <rcg file>..." << std::endl;
+        return 1;
+    }
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        std::vector< char > data;
+        if ( ! read_all( argv[i], data )
+             || data.empty() )
+        {
+            std::cerr << "failed to read " << argv[i] << std::endl;
+            continue;
+        }
+
+        std::printf( "%s: %lu bytes\n", argv[i], static_cast< unsigned long >( data.size() ) );
+        bench( data, rcss::zfilebuf::PLAIN, "plain", "" );
+        bench( data, rcss::zfilebuf::GZIP, "gzip", ".gz" );
+        bench( data, rcss::zfilebuf::ZSTD, "zstd", ".zst" );
+        bench( data, rcss::zfilebuf::LZ4, "lz4", ".lz4" );
+    }
+
+    return 0;
+}
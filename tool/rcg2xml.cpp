@@ -25,6 +25,7 @@
 
 #include <rcsslogplayer/parser.h>
 #include <rcsslogplayer/handler.h>
+#include <rcsslogplayer/mappedfile.h>
 
 #ifdef HAVE_NETINET_IN_H
 #include <netinet/in.h>
@@ -36,6 +37,7 @@
 #include <iostream>
 #include <limits>
 #include <cstring>
+#include <cstdio>
 
 static int MAX_TIME = std::numeric_limits< short >::max();
 
@@ -427,6 +429,15 @@ private:
           M_time = info.time_;
       }
 
+    void doHandleShowBlock( const ShowInfoT * shows,
+                            const std::size_t n )
+      {
+          for ( std::size_t i = 0; i < n; ++i )
+          {
+              XMLWriter::doHandleShowInfo( shows[i] );
+          }
+      }
+
     void print( const BallT & ball )
       {
           std::cout << "<Ball>\n";
@@ -614,6 +625,23 @@ main()
 {
     rcss::rcg::XMLWriter writer;
     rcss::rcg::Parser parser( writer );
+    parser.setShowBlockSize( rcss::rcg::Parser::DEFAULT_SHOW_BLOCK_SIZE );
+
+    // if the standard input is redirected from a regular file,
+    // the file is directly parsed on the mapped memory.
+    // compressed file (gzip, zstd or lz4) is decompressed into the memory.
+    rcss::MappedFile mapped;
+    if ( mapped.open( fileno( stdin ) )
+         && ( ! mapped.isCompressed()
+              || mapped.inflate() ) )
+    {
+        std::size_t pos = 0;
+        while ( parser.parse( mapped.data(), mapped.size(), pos ) )
+        {
+
+        }
+        return 0;
+    }
 
     while ( parser.parse( std::cin ) )
     {
@@ -38,6 +38,8 @@
 #include <rcsslogplayer/handler.h>
 #include <rcsslogplayer/util.h>
 
+#include <rcsslogplayer/mappedfile.h>
+#include <rcsslogplayer/zfstream.h>
 #ifdef HAVE_LIBZ
 #include <rcsslogplayer/gzfstream.h>
 #endif
@@ -307,6 +309,7 @@ private:
     TeamT M_team_l;
     TeamT M_team_r;
 
+    rcss::MappedFile M_mapped; //!< mapped input file
     std::istream * M_in; //!< input stream
     std::ostream * M_out; //!< output stream
 
@@ -330,6 +333,12 @@ public:
     bool parseCmdLine( int argc,
                        char ** argv );
 
+    const
+    rcss::MappedFile & mappedInput() const
+      {
+          return M_mapped;
+      }
+
     std::istream * input()
       {
           return M_in;
@@ -355,6 +364,16 @@ private:
     virtual
     void doHandleShowInfo( const ShowInfoT & );
 
+    virtual
+    void doHandleShowBlock( const ShowInfoT * shows,
+                            const std::size_t n )
+      {
+          for ( std::size_t i = 0; i < n; ++i )
+          {
+              RCGConvert::doHandleShowInfo( shows[i] );
+          }
+      }
+
     virtual
     void doHandleMsgInfo( const int,
                           const int,
@@ -1058,19 +1077,41 @@ RCGConvert::open( const std::string & input_file,
     if ( input_file.empty()
          || input_file == "-" )
     {
-        M_in = &std::cin;
+        // regular file redirected to stdin can be mapped.
+        if ( ! M_mapped.open( fileno( stdin ) ) )
+        {
+            M_in = &std::cin;
+        }
         std::cerr << "rcgconvert: input file = stdin" << std::endl;
     }
     else
     {
-        if ( input_file.length() > 3
-             && input_file.compare( input_file.length() - 3, 3, ".gz" ) == 0 )
+        // uncompressed file is directly parsed on the mapped memory.
+        // zstd or lz4 compressed file is decompressed into the memory.
+        if ( M_mapped.open( input_file.c_str() )
+             && M_mapped.isCompressed()
+             && ( M_mapped.isGzipped()
+                  || ! M_mapped.inflate() ) )
+        {
+            M_mapped.close();
+        }
+
+        if ( M_mapped.is_open() )
+        {
+            // nothing to do
+        }
+        else if ( input_file.length() > 3
+                  && input_file.compare( input_file.length() - 3, 3, ".gz" ) == 0 )
         {
 #ifndef HAVE_LIBZ
             std::cerr << "No zlib support!" << std::endl;
             return false;
 #else
-            M_in = new rcss::gzifstream( input_file.c_str() );
+            rcss::gzifstream * gzin = new rcss::gzifstream();
+            // inflate the next blocks while parsing
+            gzin->setReadAhead( true );
+            gzin->open( input_file.c_str() );
+            M_in = gzin;
 #endif
         }
         else
@@ -1078,7 +1119,8 @@ RCGConvert::open( const std::string & input_file,
             M_in = new std::ifstream( input_file.c_str() );
         }
 
-        if ( ! *M_in )
+        if ( ! M_mapped.is_open()
+             && ! *M_in )
         {
             std::cerr << "rcgconvert could not open the input file ." << input_file
                       << std::endl;
@@ -1095,15 +1137,16 @@ RCGConvert::open( const std::string & input_file,
     }
     else
     {
-        if ( output_file.length() > 3
-             && output_file.compare( output_file.length() - 3, 3, ".gz" ) == 0 )
+        const rcss::zfilebuf::Format format = rcss::zfilebuf::formatOf( output_file );
+        if ( format != rcss::zfilebuf::PLAIN )
         {
-#ifndef HAVE_LIBZ
-            std::cerr << "No zlib support!" << std::endl;
-            return false;
-#else
-            M_out = new rcss::gzofstream( output_file.c_str() );
-#endif
+            if ( ! rcss::zfilebuf::isSupported( format ) )
+            {
+                std::cerr << "No compression library support for ["
+                          << output_file << "]!" << std::endl;
+                return false;
+            }
+            M_out = new rcss::zofstream( output_file.c_str(), format );
         }
         else
         {
@@ -1127,6 +1170,8 @@ RCGConvert::open( const std::string & input_file,
 void
 RCGConvert::close()
 {
+    M_mapped.close();
+
     if ( M_in
          && M_in != &std::cin )
     {
@@ -1402,9 +1447,11 @@ main( int argc, char ** argv )
         return 1;
     }
 
+    const rcss::MappedFile & mapped = converter.mappedInput();
     std::istream * in = converter.input();
-    if ( ! in
-         || ! *in )
+    if ( ! mapped.is_open()
+         && ( ! in
+              || ! *in ) )
     {
         std::cerr << "rcgconvert could not open the input stream."
                   << std::endl;
@@ -1412,9 +1459,13 @@ main( int argc, char ** argv )
     }
 
     rcss::rcg::Parser parser( converter );
+    parser.setShowBlockSize( rcss::rcg::Parser::DEFAULT_SHOW_BLOCK_SIZE );
 
+    std::size_t pos = 0;
     int count = -1;
-    while ( parser.parse( *in ) )
+    while ( mapped.is_open()
+            ? parser.parse( mapped.data(), mapped.size(), pos )
+            : parser.parse( *in ) )
     {
         if ( ++count % 512 == 0 )
         {
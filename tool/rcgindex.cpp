@@ -0,0 +1,264 @@
+// -*-c++-*-
+
+/*!
+  \file rcgindex.cpp
+  \brief rcg offset index generator
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) The RoboCup Soccer Server Maintenance Group.
+ Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsslogplayer/gzindex.h>
+#include <rcsslogplayer/index.h>
+#include <rcsslogplayer/mappedfile.h>
+
+#ifdef HAVE_BOOST_PROGRAM_OPTIONS
+#include <boost/program_options.hpp>
+#endif
+
+#include <iostream>
+#include <string>
+
+namespace {
+
+struct Options {
+    std::string input_file_;
+    std::string output_file_;
+    bool verbose_;
+    int cycle_;
+    int span_;
+
+    Options()
+        : verbose_( false ),
+          cycle_( -1 ),
+          span_( 1 )
+      { }
+};
+
+/*--------------------------------------------------------------------*/
+bool
+parse_cmd_line( int argc,
+                char ** argv,
+                Options & opt )
+{
+#ifdef HAVE_BOOST_PROGRAM_OPTIONS
+    namespace po = boost::program_options;
+
+    po::options_description visibles( "Allowed options" );
+
+    visibles.add_options()
+        ( "help,h",
+          "print this message." )
+        ( "verbose",
+          po::bool_switch( &opt.verbose_ )->default_value( false ),
+          "verbose mode." )
+        ( "output,o",
+          po::value< std::string >( &opt.output_file_ )->default_value( "" ),
+          "set a file path of the output index file. (default: <GameLogFile>idx)" )
+        ( "cycle,c",
+          po::value< int >( &opt.cycle_ )->default_value( -1, "-1" ),
+          "print the position of the show record at the specified cycle." )
+        ( "span,s",
+          po::value< int >( &opt.span_ )->default_value( 1 ),
+          "set the distance [MB] between the access points of the compressed file." )
+        ;
+
+    po::options_description invisibles( "Invisibles" );
+    invisibles.add_options()
+        ( "input",
+          po::value< std::string >( &opt.input_file_ )->default_value( "" ),
+          "set the path to Game Log file(.rcg) to be indexed."  )
+        ;
+
+    po::options_description all_desc( "All options" );
+    all_desc.add( visibles ).add( invisibles );
+
+    po::positional_options_description pdesc;
+    pdesc.add( "input", 1 ); // allowed only one rcg file
+
+    bool help = false;
+    try
+    {
+        po::variables_map vm;
+        po::command_line_parser parser( argc, argv );
+        parser.options( all_desc ).positional( pdesc );
+        po::store( parser.run(), vm );
+        po::notify( vm );
+
+        if ( vm.count( "help" ) )
+        {
+            help = true;
+        }
+    }
+    catch ( std::exception & e )
+    {
+        std::cerr << e.what() << std::endl;
+        help = true;
+    }
+
+    if ( help
+         || opt.input_file_.empty() )
+    {
+        std::cout << "Usage: rcgindex [options ... ] <GameLogFile>\n";
+        std::cout << visibles << std::endl;
+        return false;
+    }
+
+    if ( opt.span_ <= 0 )
+    {
+        std::cerr << "illegal span " << opt.span_ << std::endl;
+        return false;
+    }
+
+    return true;
+#else // HAVE_BOOST_PROGRAM_OPTIONS
+    if ( argc < 2 )
+    {
+        std::cout << "Usage: rcgindex <GameLogFile>" << std::endl;
+        return false;
+    }
+
+    opt.input_file_ = argv[1];
+    return true;
+#endif
+}
+
+/*--------------------------------------------------------------------*/
+/*!
+  \brief build the access point index for the compressed file.
+ */
+int
+build_gzip_index( Options & opt )
+{
+    if ( opt.output_file_.empty() )
+    {
+        opt.output_file_ = rcss::GzipIndex::indexFilePath( opt.input_file_ );
+    }
+
+    rcss::GzipIndex index;
+    if ( ! index.build( opt.input_file_.c_str(),
+                        static_cast< std::size_t >( opt.span_ ) * 1024 * 1024 ) )
+    {
+        std::cerr << "rcgindex failed to inflate the input file ["
+                  << opt.input_file_ << "]." << std::endl;
+        return 1;
+    }
+
+    if ( ! index.write( opt.output_file_ ) )
+    {
+        std::cerr << "rcgindex failed to write the index file ["
+                  << opt.output_file_ << "]." << std::endl;
+        return 1;
+    }
+
+    if ( opt.verbose_ )
+    {
+        std::cout << "data size = " << index.dataSize()
+                  << "\naccess point = " << index.points().size()
+                  << std::endl;
+    }
+
+    return 0;
+}
+
+}
+
+/*--------------------------------------------------------------------*/
+
+int
+main( int argc, char ** argv )
+{
+    Options opt;
+
+    if ( ! parse_cmd_line( argc, argv, opt ) )
+    {
+        return 1;
+    }
+
+    rcss::MappedFile mapped;
+    if ( ! mapped.open( opt.input_file_.c_str() ) )
+    {
+        std::cerr << "rcgindex could not open the input file ["
+                  << opt.input_file_ << "]." << std::endl;
+        return 1;
+    }
+
+    if ( mapped.isGzipped() )
+    {
+        mapped.close();
+        return build_gzip_index( opt );
+    }
+
+    if ( opt.output_file_.empty() )
+    {
+        opt.output_file_ = rcss::rcg::Index::indexFilePath( opt.input_file_ );
+    }
+
+    rcss::rcg::Index index;
+    if ( ! index.build( mapped.data(), mapped.size() ) )
+    {
+        std::cerr << "rcgindex failed to parse the input file ["
+                  << opt.input_file_ << "]." << std::endl;
+        return 1;
+    }
+
+    if ( ! index.write( opt.output_file_ ) )
+    {
+        std::cerr << "rcgindex failed to write the index file ["
+                  << opt.output_file_ << "]." << std::endl;
+        return 1;
+    }
+
+    if ( opt.verbose_ )
+    {
+        std::cout << "log version = " << index.logVersion()
+                  << "\nshow = " << index.shows().size()
+                  << "\nplaymode = " << index.playModes().size()
+                  << "\nteam = " << index.teams().size()
+                  << "\nteam_graphic = " << index.teamGraphics().size()
+                  << std::endl;
+    }
+
+    if ( opt.cycle_ >= 0 )
+    {
+        const rcss::rcg::Index::Entry * e = index.findShow( opt.cycle_ );
+        if ( ! e )
+        {
+            std::cerr << "no show record at cycle " << opt.cycle_ << std::endl;
+            return 1;
+        }
+
+        std::cout << "cycle " << e->time_
+                  << " offset " << e->offset_
+                  << " line " << e->line_
+                  << std::endl;
+    }
+
+    return 0;
+}
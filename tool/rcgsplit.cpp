@@ -37,7 +37,9 @@
 
 #include <rcsslogplayer/parser.h>
 #include <rcsslogplayer/handler.h>
+#include <rcsslogplayer/mappedfile.h>
 #include <rcsslogplayer/util.h>
+#include <rcsslogplayer/zfstream.h>
 
 #ifdef HAVE_LIBZ
 #include <rcsslogplayer/gzfstream.h>
@@ -71,6 +73,7 @@ private:
     int M_span_cycle;
     int M_segment_start_cycle;
     int M_segment_end_cycle;
+    std::string M_compression;
 
     // game log data
     int M_version;
@@ -86,7 +89,8 @@ private:
 
     // output file info
     int M_start_cycle;
-    std::ofstream M_fout;
+    zfilebuf::Format M_out_format;
+    zofstream M_fout;
 
 public:
     RCGSplitter()
@@ -94,7 +98,8 @@ public:
           M_segment_start_cycle( -1 ),
           M_segment_end_cycle( -1 ),
           M_version( 0 ),
-          M_start_cycle( 0 )
+          M_start_cycle( 0 ),
+          M_out_format( zfilebuf::PLAIN )
       { }
 
     bool parseCmdLine( int argc,
@@ -110,6 +115,25 @@ public:
       {
           return M_time;
       }
+
+    int segmentStartCycle() const
+      {
+          return M_segment_start_cycle;
+      }
+
+    int segmentEndCycle() const
+      {
+          return M_segment_end_cycle;
+      }
+
+    bool hasSegment() const
+      {
+          return M_segment_start_cycle > 0
+              || M_segment_end_cycle > 0;
+      }
+
+    void finish();
+
 private:
 
     virtual
@@ -124,6 +148,16 @@ private:
     virtual
     void doHandleShowInfo( const ShowInfoT & );
 
+    virtual
+    void doHandleShowBlock( const ShowInfoT * shows,
+                            const std::size_t n )
+      {
+          for ( std::size_t i = 0; i < n; ++i )
+          {
+              RCGSplitter::doHandleShowInfo( shows[i] );
+          }
+      }
+
     virtual
     void doHandleMsgInfo( const int,
                           const int,
@@ -206,6 +240,15 @@ RCGSplitter::parseCmdLine( int argc,
         ( "segment-end,e",
           po::value< int >( &M_segment_end_cycle )->default_value( -1, "-1"  ),
           "set a segment end cycle value. (negative value means the end cycle in the input file)" )
+        ( "start",
+          po::value< int >(),
+          "same as --segment-start." )
+        ( "end",
+          po::value< int >(),
+          "same as --segment-end." )
+        ( "compression,z",
+          po::value< std::string >( &M_compression )->default_value( "" ),
+          "set a compression format of the output files. (gz, zst or lz4)" )
         ;
 
     po::options_description invisibles( "Invisibles" );
@@ -234,6 +277,16 @@ RCGSplitter::parseCmdLine( int argc,
         {
             help = true;
         }
+
+        if ( vm.count( "start" ) )
+        {
+            M_segment_start_cycle = vm["start"].as< int >();
+        }
+
+        if ( vm.count( "end" ) )
+        {
+            M_segment_end_cycle = vm["end"].as< int >();
+        }
     }
     catch ( std::exception & e )
     {
@@ -252,6 +305,18 @@ RCGSplitter::parseCmdLine( int argc,
         std::cout << visibles << std::endl;
         return false;
     }
+
+    if ( ! M_compression.empty() )
+    {
+        M_out_format = zfilebuf::formatOf( "." + M_compression );
+        if ( M_out_format == zfilebuf::PLAIN
+             || ! zfilebuf::isSupported( M_out_format ) )
+        {
+            std::cerr << "unsupported compression format [" << M_compression << "]"
+                      << std::endl;
+            return false;
+        }
+    }
     return true;
 #else // HAVE_BOOST_PROGRAM_OPTIONS
     return false
@@ -570,6 +635,13 @@ RCGSplitter::doHandleMsgInfo( const int time,
 /*--------------------------------------------------------------------*/
 void
 RCGSplitter::doHandleEOF()
+{
+    finish();
+}
+
+/*--------------------------------------------------------------------*/
+void
+RCGSplitter::finish()
 {
     if ( M_fout.is_open() )
     {
@@ -653,10 +725,11 @@ RCGSplitter::createOutputFile( const int cycle )
         M_start_cycle = cycle;
 
         char filename[256];
-        snprintf( filename, 256, "%08d-%08d.rcg",
-                  M_start_cycle, M_start_cycle + M_span_cycle - 1 );
-        M_fout.open( filename,
-                     std::ios_base::out | std::ios_base::binary );
+        snprintf( filename, 256, "%08d-%08d.rcg%s%s",
+                  M_start_cycle, M_start_cycle + M_span_cycle - 1,
+                  M_compression.empty() ? "" : ".",
+                  M_compression.c_str() );
+        M_fout.open( filename, M_out_format );
         if ( M_verbose )
         {
             std::cout << "new file [" << filename << "]" << std::endl;
@@ -764,15 +837,58 @@ main( int argc, char ** argv )
         return 1;
     }
 
+    // uncompressed file is directly parsed on the mapped memory.
+    // zstd or lz4 compressed file is decompressed into the memory.
+    // gzip file is also decompressed if the segment is specified,
+    // because the segment is searched in the memory.
+    rcss::MappedFile mapped;
+    if ( mapped.open( splitter.filepath().c_str() )
+         && mapped.isCompressed()
+         && ( ( mapped.isGzipped() && ! splitter.hasSegment() )
+              || ! mapped.inflate() ) )
+    {
+        mapped.close();
+    }
+
 #ifdef HAVE_LIBZ
-    rcss::gzifstream fin( splitter.filepath().c_str() );
+    rcss::gzifstream fin;
 #else
-    std::ifstream fin( splitter.filepath().c_str() );
+    std::ifstream fin;
+#endif
+
+    if ( ! mapped.is_open() )
+    {
+#ifdef HAVE_LIBZ
+        // inflate the next blocks while parsing
+        fin.setReadAhead( true );
 #endif
+        fin.open( splitter.filepath().c_str() );
+    }
 
     rcss::rcg::Parser parser( splitter );
+    parser.setShowBlockSize( rcss::rcg::Parser::DEFAULT_SHOW_BLOCK_SIZE );
+    std::size_t pos = 0;
+
+    // v4+ log: only the segment is parsed.
+    if ( mapped.is_open()
+         && splitter.hasSegment()
+         && parser.parseRange( splitter.segmentStartCycle(),
+                               splitter.segmentEndCycle(),
+                               mapped.data(), mapped.size(), pos ) )
+    {
+        // the parser calls handleEOF() only if the segment reaches the end of the data.
+        // the records after the segment are not needed.
+        if ( pos < mapped.size() )
+        {
+            splitter.finish();
+        }
+        return 0;
+    }
+
     int count = 0;
-    while ( parser.parse( fin ) )
+    while ( mapped.is_open()
+            ? parser.parse( mapped.data(), mapped.size(), pos )
+            : parser.parse( fin ) )
     {
         if ( ++count % 500 == 0 )
         {